@@ -25,8 +25,14 @@
 #include "PureCore/TWTimer.h"
 #include "PureCore/Event.h"
 #include "PureCore/SleepIdler.h"
+#include "PureCore/Channel.h"
+#include "PureCore/Memory/FrameArena.h"
+#include "PureCore/Memory/PoolStat.h"
+#include "PureCore/Memory/PoolTrimmer.h"
 #include "PureLua/PureLuaEnv.h"
 #include "PureNet/PureNetThread.h"
+#include "PureDb/LevelDb/LevelAsyncConnector.h"
+#include "PureDb/Redis/RedisAsyncConnector.h"
 #include "PureApp/PureAppLib.h"
 
 namespace PureApp {
@@ -40,6 +46,10 @@ public:
     uint16_t get_hz() const;
 
     PureLua::PureLuaEnv& lua();
+    // memory allocated in frame arena is invalid at frame end
+    PureCore::FrameArena& frame_arena();
+    // dump PoolRegistry to log every interval milli seconds, 0 is disable
+    void set_pool_dump_interval(int64_t interval);
 
     int init(const std::string& name);
     void stop();
@@ -55,10 +65,19 @@ public:
     int add_lua_archive(const char* path, const char* pwd = nullptr);
     void clear_lua_archive();
 
+    // the loop wakes and updates attached connectors when their responses land,
+    // attach before connect starts the work thread, detach before the connector is freed
+    int attach_redis(PureDb::RedisAsyncConnector* conn);
+    void detach_redis(PureDb::RedisAsyncConnector* conn);
+    int attach_level(PureDb::LevelAsyncConnector* conn);
+    void detach_level(PureDb::LevelAsyncConnector* conn);
+
     void loop();
 
 private:
     void update(int64_t delta);
+    void update_resp();
+    bool has_resp() const;
 
 public:
     PureCore::Event<> mEventStart;
@@ -75,7 +94,14 @@ private:
     int64_t mTimeZero = 0;
     int64_t mTimeOffset = 0;
     PureCore::SleepIdler mIdler;
+    PureCore::ChannelWaker mWaker;
+    PureCore::FrameArena mFrameArena;
+    int64_t mPoolDumpInterval = 0;
+    int64_t mPoolDumpElapsed = 0;
+    int64_t mPoolTrimElapsed = 0;
     PureNet::PureNetThread mNet;
+    std::vector<PureDb::RedisAsyncConnector*> mRedis;
+    std::vector<PureDb::LevelAsyncConnector*> mLevel;
 };
 
 }  // namespace PureApp
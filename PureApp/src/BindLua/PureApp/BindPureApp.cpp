@@ -40,6 +40,12 @@ void bind_app_pure_app(lua_State* L) {
            .def(&PureApp::time_micro_s, "time_micro_s")
            .def(&PureApp::add_lua_archive, "add_lua_archive")
            .def(&PureApp::clear_lua_archive, "clear_lua_archive")
+           .def(&PureApp::attach_redis, "attach_redis")
+           .def(&PureApp::detach_redis, "detach_redis")
+           .def(&PureApp::attach_level, "attach_level")
+           .def(&PureApp::detach_level, "detach_level")
+           .def([](PureApp& self) { return &self.frame_arena(); }, "frame_arena")
+           .def(&PureApp::set_pool_dump_interval, "set_pool_dump_interval")
            .def([](PureApp& self, std::function<bool()> cb) { return self.mEventStart.bind(cb); }, "listen_event_start")
            .def([](PureApp& self, int64_t id) { return self.mEventStart.unbind(id); }, "stop_event_start")
            .def([](PureApp& self, std::function<bool(int64_t)> cb) { return self.mEventFrame.bind(cb); }, "listen_event_frame")
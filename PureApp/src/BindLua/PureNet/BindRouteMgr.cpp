@@ -37,7 +37,37 @@ void bind_net_route_mgr(lua_State* L) {
            .def(&RouteMgr::find_route_by_user, "find_route_by_user")
            .def(&RouteMgr::find_route_by_server, "find_route_by_server")
            .def(&RouteMgr::find_server_type_routes, "find_server_type_routes")
-           .def(&RouteMgr::find_server_type_id_routes, "find_server_type_id_routes")];
+           .def(&RouteMgr::find_server_type_id_routes, "find_server_type_id_routes")
+           .def(
+               [](lua_State* L) -> int {
+                   RouteMgr& self = PureLua::LuaStack<RouteMgr&>::get(L, 1);
+                   if (!lua_istable(L, 2)) {
+                       PureLuaErrorJump(L, "2th arg must a table");
+                       return 0;
+                   }
+                   std::vector<UserID> users;
+                   int64_t len = lua_rawlen(L, 2);
+                   for (int64_t i = 1; i <= len; ++i) {
+                       lua_rawgeti(L, 2, i);
+                       users.push_back(PureLua::LuaStack<UserID>::get(L, -1));
+                       lua_pop(L, 1);
+                   }
+                   BroadcastDest dest;
+                   self.fill_broadcast_dest(users, dest);
+                   // same layout broadcast_msg takes, {linkID = {userID, ...}}
+                   lua_createtable(L, 0, int(dest.size()));
+                   for (auto& iter : dest) {
+                       lua_createtable(L, int(iter.second.size()), 0);
+                       int i = 0;
+                       for (auto userID : iter.second) {
+                           lua_pushinteger(L, userID);
+                           lua_rawseti(L, -2, ++i);
+                       }
+                       lua_rawseti(L, -2, iter.first);
+                   }
+                   return 1;
+               },
+               "fill_broadcast_dest")];
 }
 
 }  // namespace PureApp
@@ -37,6 +37,8 @@
 #include "PureApp/BindAllPureMsg.h"
 #include "PureApp/BindAllPureNet.h"
 
+#include <algorithm>
+
 namespace PureApp {
 
 const std::string& PureApp::name() const { return mName; }
@@ -47,6 +49,13 @@ uint16_t PureApp::get_hz() const { return mHz; }
 
 PureLua::PureLuaEnv& PureApp::lua() { return mLua; }
 
+PureCore::FrameArena& PureApp::frame_arena() { return mFrameArena; }
+
+void PureApp::set_pool_dump_interval(int64_t interval) {
+    mPoolDumpInterval = interval > 0 ? interval : 0;
+    mPoolDumpElapsed = 0;
+}
+
 int PureApp::init(const std::string& name) {
     if (mRunning) {
         return ErrorInvalidState;
@@ -59,6 +68,14 @@ int PureApp::init(const std::string& name) {
         PureError("timer init failed {}", PureCore::get_error_desc(err));
         return ErrorAppInitFailed;
     }
+    err = mWaker.init();
+    if (err != PureCore::Success) {
+        PureError("waker init failed {}", PureCore::get_error_desc(err));
+        return ErrorAppInitFailed;
+    }
+    // wait the rest of the frame, net and attached db responses wake the loop early
+    mIdler.set_waker(&mWaker);
+    mNet.set_resp_waker(&mWaker);
     err = mLua.init();
     if (err != PureLua::Success) {
         PureError("lua init failed {}", PureLua::get_error_desc(err));
@@ -192,28 +209,113 @@ int PureApp::add_lua_archive(const char* path, const char* pwd) {
 
 void PureApp::clear_lua_archive() { mLuaArchive.clear(); }
 
+int PureApp::attach_redis(PureDb::RedisAsyncConnector* conn) {
+    if (conn == nullptr) {
+        return ErrorNullPointer;
+    }
+    if (conn->is_running()) {
+        return ErrorInvalidState;
+    }
+    if (std::find(mRedis.begin(), mRedis.end(), conn) == mRedis.end()) {
+        conn->set_resp_waker(&mWaker);
+        mRedis.push_back(conn);
+    }
+    return Success;
+}
+
+void PureApp::detach_redis(PureDb::RedisAsyncConnector* conn) {
+    auto iter = std::find(mRedis.begin(), mRedis.end(), conn);
+    if (iter != mRedis.end()) {
+        mRedis.erase(iter);
+    }
+}
+
+int PureApp::attach_level(PureDb::LevelAsyncConnector* conn) {
+    if (conn == nullptr) {
+        return ErrorNullPointer;
+    }
+    if (conn->is_running()) {
+        return ErrorInvalidState;
+    }
+    if (std::find(mLevel.begin(), mLevel.end(), conn) == mLevel.end()) {
+        conn->set_resp_waker(&mWaker);
+        mLevel.push_back(conn);
+    }
+    return Success;
+}
+
+void PureApp::detach_level(PureDb::LevelAsyncConnector* conn) {
+    auto iter = std::find(mLevel.begin(), mLevel.end(), conn);
+    if (iter != mLevel.end()) {
+        mLevel.erase(iter);
+    }
+}
+
 void PureApp::loop() {
     mIdler.set_idle_delay(10 * 1000);
     mEventStart.notify();
     while (mRunning) {
         int64_t frameTime = 1000 / mHz;
         mIdler.frame_begin();
-        mNet.update();
+        update_resp();
         int64_t delta = mIdler.frame_check(frameTime);
         if (delta > 0) {
             update(delta);
+            mPoolTrimElapsed += delta;
+        } else if (mPoolTrimElapsed > 0) {
+            // first idle check after a frame, trim pools of logic thread
+            PureCore::PoolTrimmer::trim_thread(mPoolTrimElapsed);
+            mPoolTrimElapsed = 0;
         }
-        mIdler.frame_end(frameTime);
+        // responses pushed while updating have not been handled, do not wait
+        mIdler.frame_end(has_resp() ? 0 : frameTime);
     }
     mEventEnd.notify();
+    mRedis.clear();
+    mLevel.clear();
     mTimer.release();
     mNet.stop();
     mLua.close();
 }
 
+void PureApp::update_resp() {
+    mNet.update();
+    for (size_t i = 0; i < mRedis.size(); ++i) {
+        mRedis[i]->update();
+    }
+    for (size_t i = 0; i < mLevel.size(); ++i) {
+        mLevel[i]->update();
+    }
+}
+
+bool PureApp::has_resp() const {
+    if (mNet.has_resp()) {
+        return true;
+    }
+    for (size_t i = 0; i < mRedis.size(); ++i) {
+        if (mRedis[i]->has_resp()) {
+            return true;
+        }
+    }
+    for (size_t i = 0; i < mLevel.size(); ++i) {
+        if (mLevel[i]->has_resp()) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void PureApp::update(int64_t delta) {
     mEventFrame.notify(delta);
     mTimer.update(delta);
+    mFrameArena.reset();
+    if (mPoolDumpInterval > 0) {
+        mPoolDumpElapsed += delta;
+        if (mPoolDumpElapsed >= mPoolDumpInterval) {
+            mPoolDumpElapsed = 0;
+            PureCore::PoolRegistry::inst()->dump();
+        }
+    }
 }
 
 }  // namespace PureApp
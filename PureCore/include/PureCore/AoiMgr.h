@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "PureCore/PureCoreLib.h"
+#include "PureCore/Memory/ObjectPool.h"
+#include "PureCore/Geometry.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace PureCore {
+// watcher sees target
+struct PURECORE_API AoiPair {
+    int64_t mWatcher = 0;
+    int64_t mTarget = 0;
+};
+
+class AoiMgr;
+class PURECORE_API AoiEntity {
+public:
+    friend class AoiMgr;
+    AoiEntity() = default;
+    ~AoiEntity() = default;
+
+    int64_t obj_id() const;
+    const IntPoint& pos() const;
+    int32_t radius() const;
+    // targets this entity sees, sorted by id
+    const std::vector<AoiEntity*>& seen() const;
+    // entities seeing this one, move updates fan out to them
+    const std::vector<AoiEntity*>& watchers() const;
+
+private:
+    int64_t mObjID = 0;
+    IntPoint mPos{};
+    int32_t mRadius = 0;
+    int32_t mCell = -1;
+    uint32_t mCellPos = 0;
+    bool mDirty = false;
+    bool mAdded = false;
+    bool mMoved = false;
+    bool mRemoved = false;
+    std::vector<AoiEntity*> mSeen;
+    std::vector<AoiEntity*> mWatchers;
+};
+
+// grid based area of interest, every entity is a target and those with a radius are also watchers.
+// changes are batched, update() once a tick diffs the view sets into enter, leave and move events
+class PURECORE_API AoiMgr {
+public:
+    AoiMgr() = default;
+    ~AoiMgr();
+
+    // box is split into cells of cellSize, positions are clamped into box
+    int init(const IntABox& box, int32_t cellSize);
+    void clear();
+
+    // radius <= 0 watches nothing, adding an existing obj moves it
+    int add(int64_t objID, const IntPoint& pos, int32_t radius);
+    // watchers get leave events on next update, the removed obj gets none
+    int remove(int64_t objID);
+    int move(int64_t objID, const IntPoint& pos);
+    int set_radius(int64_t objID, int32_t radius);
+    AoiEntity* find(int64_t objID) const;
+    // append ids of the watchers of objID to out, e.g. users for RouteMgr::fill_broadcast_dest
+    size_t get_watcher_ids(int64_t objID, std::vector<int64_t>& out) const;
+    size_t size() const;
+
+    void update();
+    // events of the last update, valid until the next one
+    const std::vector<AoiPair>& enters() const;
+    const std::vector<AoiPair>& leaves() const;
+    // moved entities that have watchers, new ones are only in enters
+    const std::vector<AoiEntity*>& moves() const;
+
+private:
+    template <typename Func>
+    void scan_cells(const IntPoint& pos, int32_t radius, Func&& func);
+    int32_t cell_index(const IntPoint& pos) const;
+    IntPoint clamp_pos(const IntPoint& pos) const;
+    void add_to_cell(AoiEntity* e);
+    void remove_from_cell(AoiEntity* e);
+    void mark_dirty(AoiEntity* e);
+    void update_watcher(AoiEntity* e);
+    void update_target(AoiEntity* e);
+    void unlink(AoiEntity* e);
+
+private:
+    IntABox mABox{};
+    int32_t mCellSize = 0;
+    int32_t mCols = 0;
+    int32_t mRows = 0;
+    int32_t mMaxRadius = 0;
+    size_t mRemovedCount = 0;
+    std::vector<std::vector<AoiEntity*>> mCells;
+    std::unordered_map<int64_t, AoiEntity*> mObjs;
+    ObjectPool<AoiEntity, 64 * 1024, SlabAllocator> mPool{"AoiEntity"};
+    std::vector<AoiEntity*> mDirty;
+    std::vector<AoiEntity*> mNewSeen;
+    std::vector<AoiPair> mEnters;
+    std::vector<AoiPair> mLeaves;
+    std::vector<AoiEntity*> mMoves;
+
+    PURE_DISABLE_COPY(AoiMgr)
+};
+}  // namespace PureCore
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "PureCore/Buffer/DynamicBuffer.h"
+#include "PureCore/Memory/FrameArena.h"
+
+namespace PureCore {
+// DynamicBuffer grow in FrameArena, invalid after the arena reset
+class PURECORE_API ArenaBuffer : public DynamicBuffer {
+public:
+    ArenaBuffer(FrameArena& arena);
+    virtual ~ArenaBuffer();
+
+    virtual int resize_buffer(size_t size);
+
+    // memory own by arena, can't move or swap to DynamicBuffer which free it
+    ArenaBuffer(ArenaBuffer&&) = delete;
+    ArenaBuffer& operator=(ArenaBuffer&&) = delete;
+    ArenaBuffer& operator=(DynamicBuffer&&) = delete;
+    ArenaBuffer& operator=(const DynamicBuffer&) = delete;
+    void swap(DynamicBuffer& dest) = delete;
+
+private:
+    FrameArena& mArena;
+
+    PURE_DISABLE_COPY(ArenaBuffer)
+};
+
+// checked handle of an ArenaBuffer, such as for scripts, get return nullptr after the arena moved to another frame
+class PURECORE_API ArenaBufferHandle {
+public:
+    ArenaBufferHandle() = default;
+    ArenaBufferHandle(FrameArena& arena, size_t size);
+    ~ArenaBufferHandle() = default;
+
+    bool valid() const;
+    ArenaBuffer* get() const;
+    uint64_t get_frame() const;
+
+private:
+    FrameArena* mArena = nullptr;
+    ArenaBuffer* mBuffer = nullptr;
+    uint64_t mFrame = 0;
+};
+
+}  // namespace PureCore
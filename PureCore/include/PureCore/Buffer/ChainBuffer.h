@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "PureCore/PureCoreLib.h"
+#include "PureCore/DataRef.h"
+
+#include <atomic>
+#include <vector>
+
+namespace PureCore {
+// refcounted block of bytes, the bytes follow the header in one allocation. segments of the default size are
+// cached per thread
+class PURECORE_API ChainSegment {
+public:
+    enum EChainSegmentConst {
+        DefaultSize = 16 * 1024,
+        CacheCount = 64,
+    };
+
+    static ChainSegment* create(size_t capacity);
+    void retain();
+    // free on the last release
+    void release();
+
+    char* data();
+    size_t capacity() const;
+    uint32_t ref_count() const;
+    // the caller holds the only reference, acquire so it can write after other threads released it
+    bool unique() const;
+
+private:
+    ChainSegment(uint32_t capacity);
+    ~ChainSegment() = default;
+    friend struct ChainSegmentCache;
+    friend class ChainBuffer;
+
+private:
+    std::atomic<uint32_t> mRef;
+    uint32_t mCapacity;
+    uint32_t mSize = 0;  // bytes written by the chain that created it
+
+    PURE_DISABLE_COPY(ChainSegment)
+};
+
+struct ChainSlice {
+    ChainSegment* mSegment;
+    uint32_t mOffset;
+    uint32_t mLength;
+};
+
+// bytes kept as a list of slices of shared segments. write copies into the tail segment, append shares the
+// segments of another chain without copying, peek hands the slices out for a gather write
+class PURECORE_API ChainBuffer {
+public:
+    explicit ChainBuffer(size_t segmentSize = ChainSegment::DefaultSize);
+    ~ChainBuffer();
+
+    void swap(ChainBuffer& dest);
+    void clear();
+
+    bool empty() const;
+    size_t size() const;
+    size_t slice_count() const;
+    const ChainSlice& slice(size_t idx) const;
+
+    int write(DataRef data);
+    // share the bytes of other, other is unchanged
+    int append(const ChainBuffer& other);
+    // share len bytes of segment from offset
+    int append(ChainSegment* segment, size_t offset, size_t len);
+    // move the first count slices to the end of dest, return the moved bytes
+    size_t move_front(ChainBuffer& dest, size_t count);
+
+    // fill out with the first slices, return the filled count
+    size_t peek(DataRef* out, size_t count) const;
+    // drop size bytes from the front
+    void consume(size_t size);
+
+private:
+    void push_slice(ChainSegment* segment, uint32_t offset, uint32_t len);
+    void compact();
+
+private:
+    size_t mSegmentSize;
+    size_t mSize = 0;
+    size_t mHead = 0;  // slices before head are consumed
+    std::vector<ChainSlice> mSlices;
+    ChainSegment* mTail = nullptr;  // segment created by this chain that write may still fill, kept across move_front and consume
+
+    PURE_DISABLE_COPY(ChainBuffer)
+};
+
+}  // namespace PureCore
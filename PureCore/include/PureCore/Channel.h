@@ -0,0 +1,376 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "PureCore/PureCoreLib.h"
+#include "PureCore/NodeList.h"
+
+#include <atomic>
+#include <type_traits>
+#include <mutex>
+#include <condition_variable>
+
+namespace PureCore {
+// wake a consumer blocked in wait, eventfd on linux, condition variable on other platforms
+// notify before wait is not lost, the next wait returns at once
+class PURECORE_API ChannelWaker {
+public:
+    ChannelWaker() = default;
+    ~ChannelWaker();
+
+    int init();
+    void release();
+
+    void notify();
+    // ms < 0 wait forever, return false when timeout
+    bool wait(int64_t ms);
+    // eventfd for poll loops, -1 when not supported
+    int get_fd() const;
+
+private:
+    int mFd = -1;
+    std::mutex mMutex;
+    std::condition_variable mCond;
+    bool mNotified = false;
+
+    PURE_DISABLE_COPY(ChannelWaker)
+};
+
+// counters of a channel, read from any thread
+struct ChannelStat {
+    size_t mPushed = 0;    // items pushed
+    size_t mPopped = 0;    // items popped
+    size_t mFull = 0;      // push failed or partly done because the channel is full
+    size_t mMaxDepth = 0;  // max depth seen by producer
+};
+
+// bounded lock free ring, one producer thread and one consumer thread
+template <typename T, size_t Capacity = 4096>
+class SpscChannel {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "SpscChannel Capacity must be power of 2");
+
+public:
+    SpscChannel() = default;
+    ~SpscChannel() = default;
+
+    static constexpr size_t capacity() { return Capacity; }
+
+    // waker is notified when producer pushes to an empty channel,
+    // consumer checks empty after pop and before wait so a push racing with the pop is not missed
+    void set_waker(ChannelWaker* waker) { mWaker = waker; }
+
+    // producer
+    bool push(const T& value) { return push_batch(&value, 1) == 1; }
+
+    // producer, return pushed count
+    size_t push_batch(const T* values, size_t count) {
+        size_t tail = mTail.load(std::memory_order_relaxed);
+        size_t room = reserve(tail, count);
+        for (size_t i = 0; i < room; ++i) {
+            mBuffer[(tail + i) & Mask] = values[i];
+        }
+        commit(tail, room, count);
+        return room;
+    }
+
+    // producer, move nodes from the front of list until full, return moved count
+    size_t push_list(NodeList& list) {
+        size_t tail = mTail.load(std::memory_order_relaxed);
+        size_t room = reserve(tail, Capacity);
+        size_t count = 0;
+        while (count < room && !list.empty()) {
+            mBuffer[(tail + count) & Mask] = list.pop_front_t<typename std::remove_pointer<T>::type>();
+            ++count;
+        }
+        commit(tail, count, list.empty() ? count : count + 1);
+        return count;
+    }
+
+    // consumer
+    bool pop(T& value) { return pop_batch(&value, 1) == 1; }
+
+    // consumer, return popped count
+    size_t pop_batch(T* values, size_t count) {
+        size_t head = mHead.load(std::memory_order_relaxed);
+        size_t ready = acquire(head, count);
+        for (size_t i = 0; i < ready; ++i) {
+            values[i] = mBuffer[(head + i) & Mask];
+        }
+        release(head, ready);
+        return ready;
+    }
+
+    // consumer, append at most count items to the back of list, return popped count
+    size_t pop_list(NodeList& list, size_t count = Capacity) {
+        size_t head = mHead.load(std::memory_order_relaxed);
+        size_t ready = acquire(head, count);
+        for (size_t i = 0; i < ready; ++i) {
+            list.push_back(mBuffer[(head + i) & Mask]);
+        }
+        release(head, ready);
+        return ready;
+    }
+
+    // approximate in other threads
+    size_t size() const { return mTail.load(std::memory_order_seq_cst) - mHead.load(std::memory_order_seq_cst); }
+    bool empty() const { return size() == 0; }
+
+    ChannelStat get_stat() const {
+        ChannelStat stat;
+        stat.mPushed = mPushed.load(std::memory_order_relaxed);
+        stat.mPopped = mPopped.load(std::memory_order_relaxed);
+        stat.mFull = mFull.load(std::memory_order_relaxed);
+        stat.mMaxDepth = mMaxDepth.load(std::memory_order_relaxed);
+        return stat;
+    }
+
+private:
+    enum ESpscChannelConst {
+        Mask = Capacity - 1,
+    };
+
+    size_t reserve(size_t tail, size_t count) {
+        size_t room = Capacity - (tail - mHeadCache);
+        if (room < count) {
+            mHeadCache = mHead.load(std::memory_order_acquire);
+            room = Capacity - (tail - mHeadCache);
+        }
+        return room < count ? room : count;
+    }
+
+    void commit(size_t tail, size_t count, size_t want) {
+        if (count < want) {
+            mFull.store(mFull.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+        if (count == 0) {
+            return;
+        }
+        mPushed.store(mPushed.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+        size_t depth = tail + count - mHeadCache;
+        if (depth > mMaxDepth.load(std::memory_order_relaxed)) {
+            mMaxDepth.store(depth, std::memory_order_relaxed);
+        }
+        if (mWaker == nullptr) {
+            mTail.store(tail + count, std::memory_order_release);
+            return;
+        }
+        // pairs with seq_cst in release, either consumer sees the new tail or producer sees it drained
+        mTail.store(tail + count, std::memory_order_seq_cst);
+        if (mHead.load(std::memory_order_seq_cst) == tail) {
+            mWaker->notify();
+        }
+    }
+
+    size_t acquire(size_t head, size_t count) {
+        size_t ready = mTailCache - head;
+        if (ready < count) {
+            mTailCache = mTail.load(std::memory_order_seq_cst);
+            ready = mTailCache - head;
+        }
+        return ready < count ? ready : count;
+    }
+
+    void release(size_t head, size_t count) {
+        if (count == 0) {
+            return;
+        }
+        mPopped.store(mPopped.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+        mHead.store(head + count, std::memory_order_seq_cst);
+    }
+
+private:
+    // consumer side
+    alignas(64) std::atomic<size_t> mHead{};
+    size_t mTailCache = 0;
+    std::atomic<size_t> mPopped{};
+    // producer side
+    alignas(64) std::atomic<size_t> mTail{};
+    size_t mHeadCache = 0;
+    std::atomic<size_t> mPushed{};
+    std::atomic<size_t> mFull{};
+    std::atomic<size_t> mMaxDepth{};
+    ChannelWaker* mWaker = nullptr;
+    alignas(64) T mBuffer[Capacity]{};
+
+    PURE_DISABLE_COPY(SpscChannel)
+};
+
+// bounded lock free ring, any producer threads and one consumer thread
+// every slot has a sequence, producers claim a slot by cas on tail then publish it by the sequence
+template <typename T, size_t Capacity = 4096>
+class MpscChannel {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "MpscChannel Capacity must be power of 2");
+
+public:
+    MpscChannel() {
+        for (size_t i = 0; i < Capacity; ++i) {
+            mSlots[i].mSeq.store(i, std::memory_order_relaxed);
+        }
+    }
+    ~MpscChannel() = default;
+
+    static constexpr size_t capacity() { return Capacity; }
+
+    // waker is notified when producer pushes to an empty channel,
+    // consumer checks empty after pop and before wait so a push racing with the pop is not missed
+    void set_waker(ChannelWaker* waker) { mWaker = waker; }
+
+    // any thread
+    bool push(const T& value) {
+        size_t tail = mTail.load(std::memory_order_relaxed);
+        Slot* slot = nullptr;
+        while (true) {
+            slot = &mSlots[tail & Mask];
+            size_t seq = slot->mSeq.load(std::memory_order_acquire);
+            intptr_t dif = intptr_t(seq) - intptr_t(tail);
+            if (dif == 0) {
+                if (mTail.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (dif < 0) {
+                mFull.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            } else {
+                tail = mTail.load(std::memory_order_relaxed);
+            }
+        }
+        slot->mValue = value;
+        if (mWaker == nullptr) {
+            slot->mSeq.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+        // pairs with seq_cst in pop, either consumer sees the slot or producer sees it drained
+        slot->mSeq.store(tail + 1, std::memory_order_seq_cst);
+        if (mHead.load(std::memory_order_seq_cst) == tail) {
+            mWaker->notify();
+        }
+        return true;
+    }
+
+    // any thread, items are pushed one by one and may interleave with other producers, return pushed count
+    size_t push_batch(const T* values, size_t count) {
+        size_t pushed = 0;
+        while (pushed < count && push(values[pushed])) {
+            ++pushed;
+        }
+        return pushed;
+    }
+
+    // any thread, move nodes from the front of list until full, return moved count
+    size_t push_list(NodeList& list) {
+        size_t count = 0;
+        while (!list.empty()) {
+            auto node = list.get_front_t<typename std::remove_pointer<T>::type>();
+            if (!push(node)) {
+                break;
+            }
+            list.pop_front();
+            ++count;
+        }
+        return count;
+    }
+
+    // consumer
+    bool pop(T& value) {
+        size_t head = mHead.load(std::memory_order_relaxed);
+        Slot& slot = mSlots[head & Mask];
+        if (slot.mSeq.load(std::memory_order_seq_cst) != head + 1) {
+            return false;
+        }
+        value = slot.mValue;
+        slot.mSeq.store(head + Capacity, std::memory_order_release);
+        mHead.store(head + 1, std::memory_order_seq_cst);
+        mPopped.store(mPopped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // consumer, return popped count
+    size_t pop_batch(T* values, size_t count) {
+        size_t popped = 0;
+        while (popped < count && pop(values[popped])) {
+            ++popped;
+        }
+        return popped;
+    }
+
+    // consumer, append at most count items to the back of list, return popped count
+    size_t pop_list(NodeList& list, size_t count = Capacity) {
+        size_t popped = 0;
+        T value{};
+        while (popped < count && pop(value)) {
+            list.push_back(value);
+            ++popped;
+        }
+        return popped;
+    }
+
+    // approximate in other threads
+    size_t size() const {
+        size_t tail = mTail.load(std::memory_order_seq_cst);
+        size_t head = mHead.load(std::memory_order_seq_cst);
+        return tail > head ? tail - head : 0;
+    }
+    bool empty() const { return size() == 0; }
+
+    ChannelStat get_stat() const {
+        ChannelStat stat;
+        stat.mPopped = mPopped.load(std::memory_order_relaxed);
+        stat.mPushed = stat.mPopped + size();
+        stat.mFull = mFull.load(std::memory_order_relaxed);
+        stat.mMaxDepth = mMaxDepth.load(std::memory_order_relaxed);
+        return stat;
+    }
+
+    // consumer, record depth for stat, producers do not track it to keep push cheap
+    void sample_depth() {
+        size_t depth = size();
+        if (depth > mMaxDepth.load(std::memory_order_relaxed)) {
+            mMaxDepth.store(depth, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    enum EMpscChannelConst {
+        Mask = Capacity - 1,
+    };
+
+    struct Slot {
+        std::atomic<size_t> mSeq{};
+        T mValue{};
+    };
+
+private:
+    // consumer side
+    alignas(64) std::atomic<size_t> mHead{};
+    std::atomic<size_t> mPopped{};
+    std::atomic<size_t> mMaxDepth{};
+    // producer side
+    alignas(64) std::atomic<size_t> mTail{};
+    std::atomic<size_t> mFull{};
+    ChannelWaker* mWaker = nullptr;
+    alignas(64) Slot mSlots[Capacity];
+
+    PURE_DISABLE_COPY(MpscChannel)
+};
+
+}  // namespace PureCore
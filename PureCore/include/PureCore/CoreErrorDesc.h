@@ -49,7 +49,10 @@
     XX(ErrorThreadAlreadyRunning, "The Thread Is Already Running") \
     XX(ErrorNotJoinSelfThread, "Can't Join Self Thread")           \
     XX(ErrorTaskAlreadyRunning, "Task Is Already Running")         \
-    XX(ErrorTaskIsStoped, "Task Is Stoped")
+    XX(ErrorTaskIsStoped, "Task Is Stoped")                        \
+    XX(ErrorCreateWakerFailed, "Create Channel Waker Failed")      \
+    XX(ErrorAoiObjNotFound, "The Aoi Object Not Found")            \
+    XX(ErrorPathNotFound, "The Path Not Found")
 
 namespace PureCore {
 enum EPureCoreErrorCode {
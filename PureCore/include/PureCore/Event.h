@@ -22,15 +22,18 @@
 
 #pragma once
 
-#include "PureCore/IncrIDGen.h"
+#include "PureCore/InlineFunction.h"
 
-#include <map>
-#include <functional>
+#include <vector>
 
 namespace PureCore {
+// handlers are kept in a dense vector in bind order, a handle is slot index with its generation,
+// removed handlers are tombstoned and compacted after the outermost notify or when half are tombstones
 template <typename... Args>
 class Event {
 public:
+    typedef InlineFunction<bool(Args...), 48> EventFunc;
+
     Event() = default;
 
     template <typename T>
@@ -38,58 +41,159 @@ public:
         if (obj == nullptr) {
             return 0;
         }
-        return bind([=](Args&&... args) { return (obj->*func)(std::forward<Args>(args)...); });
+        return bind([obj, func](Args... args) { return (obj->*func)(std::forward<Args>(args)...); });
     }
 
-    int64_t bind(std::function<bool(Args...)> callback) {
-        int64_t id = mGen.gen_id();
-        mCallbacks.emplace(id, callback);
-        return id;
+    // bind while notifying is called in the same notify after the bound handlers
+    int64_t bind(EventFunc callback) {
+        if (callback == nullptr) {
+            return 0;
+        }
+        uint32_t slot = 0;
+        if (mFreeSlots.empty()) {
+            slot = static_cast<uint32_t>(mSlots.size());
+            mSlots.emplace_back();
+        } else {
+            slot = mFreeSlots.back();
+            mFreeSlots.pop_back();
+        }
+        Slot& s = mSlots[slot];
+        s.mUsed = true;
+        s.mPos = static_cast<uint32_t>(mHandlers.size() + mPending.size());
+        if (mNotifing > 0) {
+            mPending.emplace_back(std::move(callback), slot);
+        } else {
+            mHandlers.emplace_back(std::move(callback), slot);
+        }
+        return make_id(slot, s.mGen);
     }
 
-    Event& operator+=(std::function<bool(Args...)> callback) {
-        bind(callback);
+    Event& operator+=(EventFunc callback) {
+        bind(std::move(callback));
         return *this;
     }
 
     void unbind(int64_t id) {
-        auto iter = mCallbacks.find(id);
-        if (iter == mCallbacks.end()) {
+        uint32_t slot = static_cast<uint32_t>(id & SlotMask);
+        uint32_t gen = static_cast<uint32_t>(id >> GenShift);
+        if (id <= 0 || slot >= mSlots.size() || !mSlots[slot].mUsed || mSlots[slot].mGen != gen) {
             return;
         }
-        if (mNotifing) {
-            iter->second = nullptr;
-        } else {
-            mCallbacks.erase(iter);
+        uint32_t pos = mSlots[slot].mPos;
+        remove(pos < mHandlers.size() ? mHandlers[pos] : mPending[pos - mHandlers.size()]);
+        // notify skips tombstones, compact once half of the handlers are removed so unbind is not O(n)
+        if (mNotifing == 0 && mTombs * 2 >= mHandlers.size()) {
+            compact();
         }
     }
 
     void clear() {
-        if (mNotifing) {
-            for (auto& iter : mCallbacks) {
-                iter.second = nullptr;
-            }
-        } else {
-            mCallbacks.clear();
+        for (auto& handler : mHandlers) {
+            remove(handler);
+        }
+        for (auto& handler : mPending) {
+            remove(handler);
+        }
+        if (mNotifing == 0) {
+            compact();
         }
     }
 
+    size_t size() const { return mHandlers.size() + mPending.size() - mTombs; }
+    bool empty() const { return size() == 0; }
+
     // if return false remove self
     void notify(Args... args) {
-        mNotifing = true;
-        for (auto iter = mCallbacks.begin(); iter != mCallbacks.end();) {
-            if (iter->second && iter->second(std::forward<Args>(args)...)) {
-                ++iter;
-            } else {
-                iter = mCallbacks.erase(iter);
+        ++mNotifing;
+        size_t i = 0;
+        while (true) {
+            for (; i < mHandlers.size(); ++i) {
+                // mHandlers is not moved while notifying, a handler may be tombstoned by an early one
+                Handler& handler = mHandlers[i];
+                if (handler.mFunc != nullptr && !handler.mFunc(std::forward<Args>(args)...)) {
+                    remove(handler);
+                }
+            }
+            // handlers bound in this notify join the outermost one, nested notify must not move mHandlers
+            if (mNotifing > 1 || mPending.empty()) {
+                break;
+            }
+            append_pending();
+        }
+        if (--mNotifing == 0) {
+            compact();
+        }
+    }
+
+private:
+    enum EEventConst : uint32_t {
+        GenShift = 32,
+        SlotMask = 0xffffffff,
+        GenMask = 0x7fffffff,  // keep handle positive
+    };
+
+    struct Slot {
+        uint32_t mGen = 1;
+        uint32_t mPos = 0;  // index in mHandlers, then mPending
+        bool mUsed = false;
+    };
+
+    struct Handler {
+        Handler(EventFunc&& func, uint32_t slot) : mFunc(std::move(func)), mSlot(slot) {}
+        EventFunc mFunc;
+        uint32_t mSlot;
+    };
+
+    static inline int64_t make_id(uint32_t slot, uint32_t gen) { return (int64_t(gen) << GenShift) | int64_t(slot); }
+
+    // free slot at once so the handle is invalid, the handler is dropped by compact
+    void remove(Handler& handler) {
+        if (handler.mFunc == nullptr) {
+            return;
+        }
+        handler.mFunc = nullptr;
+        Slot& s = mSlots[handler.mSlot];
+        s.mUsed = false;
+        s.mGen = (s.mGen + 1) & GenMask;
+        if (s.mGen == 0) {
+            s.mGen = 1;
+        }
+        mFreeSlots.push_back(handler.mSlot);
+        ++mTombs;
+    }
+
+    void append_pending() {
+        for (auto& handler : mPending) {
+            mHandlers.emplace_back(std::move(handler));
+        }
+        mPending.clear();
+    }
+
+    void compact() {
+        if (mTombs == 0) {
+            return;
+        }
+        size_t count = 0;
+        for (size_t i = 0; i < mHandlers.size(); ++i) {
+            if (mHandlers[i].mFunc == nullptr) {
+                continue;
+            }
+            if (count != i) {
+                mHandlers[count] = std::move(mHandlers[i]);
+                mSlots[mHandlers[count].mSlot].mPos = static_cast<uint32_t>(count);
             }
+            ++count;
         }
-        mNotifing = false;
+        mHandlers.erase(mHandlers.begin() + count, mHandlers.end());
+        mTombs = 0;
     }
 
 private:
-    std::map<int64_t, std::function<bool(Args...)>> mCallbacks;
-    bool mNotifing = false;
-    IncrIDGen mGen;
+    std::vector<Handler> mHandlers;
+    std::vector<Handler> mPending;  // bound while notifying
+    std::vector<Slot> mSlots;
+    std::vector<uint32_t> mFreeSlots;
+    size_t mTombs = 0;
+    uint32_t mNotifing = 0;
 };
 }  // namespace PureCore
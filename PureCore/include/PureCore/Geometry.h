@@ -92,6 +92,12 @@ struct PURECORE_API IntABox {
     int64_t box_margin() const;
     int64_t intersect_area(const IntABox& box) const;
     void extend(const IntABox& box);
+    // box grown by margin on every side, clamped to int32 range
+    IntABox expand(int32_t margin) const;
+    // squared distance from p to the box, 0 when p is inside
+    int64_t dist2_point(const IntPoint& p) const;
+    // fraction t in [0, 1] of l from mMin to mMax where l enters the box, 0 when mMin is inside, false when l misses
+    bool line_enter(const IntLine& l, double& t) const;
     IntOBox to_obox() const;
     IntPoint center() const;
     IntPoint size() const;
@@ -101,6 +107,13 @@ struct PURECORE_API IntABox {
     IntPoint mMax;
 };
 
+// first obj hit by a segment
+struct PURECORE_API RayHit {
+    int64_t mObjID = 0;
+    // distance from the segment start to the hit point
+    double mDist = 0.0;
+};
+
 struct PURECORE_API IntOBox {
     int get_vertices(ArrayRef<IntPoint>& points) const;
     bool inersect(const IntOBox& box) const;
@@ -110,4 +123,39 @@ struct PURECORE_API IntOBox {
     IntPoint mHalfSize;
     double mAngle = 0.0;
 };
+
+// boxes as structure of arrays for the batch tests, the four columns share one allocation
+struct PURECORE_API IntABoxArray {
+    size_t size() const;
+    bool empty() const;
+    void clear();
+    void reserve(size_t n);
+    void push_back(const IntABox& box);
+    void set(size_t idx, const IntABox& box);
+    IntABox get(size_t idx) const;
+    // move the last box into idx, same as the swap and pop on the owner's vector
+    void swap_remove(size_t idx);
+    const int32_t* min_x() const { return mData.data(); }
+    const int32_t* min_y() const { return mData.data() + mCapacity; }
+    const int32_t* max_x() const { return mData.data() + mCapacity * 2; }
+    const int32_t* max_y() const { return mData.data() + mCapacity * 3; }
+
+    std::vector<int32_t> mData;
+    size_t mSize = 0;
+    size_t mCapacity = 0;
+};
+
+// bit i is set when box i hits, n is at most 64
+PURECORE_API uint64_t intersect_abox_bits(const IntABox& box, const int32_t* minX, const int32_t* minY, const int32_t* maxX, const int32_t* maxY, size_t n);
+PURECORE_API uint64_t intersect_circle_bits(const IntCircle& cir, const int32_t* minX, const int32_t* minY, const int32_t* maxX, const int32_t* maxY, size_t n);
+// batch tests of n boxes, mask[i] is 1 when box i hits and 0 otherwise, return the count of hits.
+// sse4.2 or avx2 kernels are picked at runtime on x86, others run the scalar loop
+PURECORE_API size_t intersect_abox_many(const IntABox& box, const int32_t* minX, const int32_t* minY, const int32_t* maxX, const int32_t* maxY, size_t n,
+                                        uint8_t* mask);
+PURECORE_API size_t intersect_abox_many(const IntABox& box, const IntABoxArray& boxes, uint8_t* mask);
+PURECORE_API size_t intersect_circle_many(const IntCircle& cir, const int32_t* minX, const int32_t* minY, const int32_t* maxX, const int32_t* maxY, size_t n,
+                                          uint8_t* mask);
+PURECORE_API size_t intersect_circle_many(const IntCircle& cir, const IntABoxArray& boxes, uint8_t* mask);
+// "avx2", "sse4.2" or "scalar"
+PURECORE_API const char* geometry_batch_level();
 }  // namespace PureCore
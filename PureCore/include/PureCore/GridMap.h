@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "PureCore/PureCoreLib.h"
+#include "PureCore/Geometry.h"
+
+#include <vector>
+
+namespace PureCore {
+// walkability of a grid, one bit per cell set for blocked. cells are kept twice, by rows and by columns, so a
+// straight scan along either axis reads 64 cells a word. cells out of the map are blocked
+class PURECORE_API GridMap {
+public:
+    GridMap() = default;
+    ~GridMap() = default;
+
+    // all cells walkable, width and height are 1 to 32768
+    int init(int32_t width, int32_t height);
+    void clear();
+
+    int32_t width() const;
+    int32_t height() const;
+    bool is_block(int32_t x, int32_t y) const;
+    bool is_walkable(int32_t x, int32_t y) const;
+    int set_block(int32_t x, int32_t y, bool block);
+    // set every cell in box, the box is clamped to the map
+    int set_block_abox(const IntABox& box, bool block);
+    // the segment between the cell centers crosses no blocked cell, passing a corner needs both side cells walkable
+    bool line_of_sight(const IntLine& line) const;
+    // changes with every cell change and never repeats between maps, caches of searches key on it
+    uint64_t stamp() const;
+
+    int save(const char* path) const;
+    int load(const char* path);
+
+    // bits of row y and column x, -1 and width or height give blocked borders
+    const uint64_t* row(int32_t y) const;
+    const uint64_t* column(int32_t x) const;
+    size_t row_words() const;
+    size_t column_words() const;
+
+private:
+    void set_bit(int32_t x, int32_t y, bool block);
+    void touch();
+
+private:
+    int32_t mWidth = 0;
+    int32_t mHeight = 0;
+    size_t mRowWords = 0;
+    size_t mColumnWords = 0;
+    std::vector<uint64_t> mRows;     // height + 2 rows, a blocked border row above and below
+    std::vector<uint64_t> mColumns;  // width + 2 columns, the transpose of mRows
+    uint64_t mStamp = 0;
+
+    PURE_DISABLE_COPY(GridMap)
+};
+
+}  // namespace PureCore
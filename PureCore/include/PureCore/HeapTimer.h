@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "PureCore/PureCoreLib.h"
+#include "PureCore/IncrIDGen.h"
+#include "PureCore/TimerNode.h"
+#include "PureCore/TimerGroup.h"
+#include "PureCore/Memory/ObjectPool.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace PureCore {
+class HeapTimerNode : public TimerNode {
+public:
+    HeapTimerNode() = default;
+    ~HeapTimerNode() = default;
+
+private:
+    friend class HeapTimer;
+    size_t mHeapIndex = 0;  // position in heap, InvalidIndex is not in heap
+
+    PURE_DISABLE_COPY(HeapTimerNode)
+};
+
+// timers sorted by a 4-ary min heap in one array, node keeps its heap position
+class PURECORE_API HeapTimer {
+public:
+    HeapTimer();
+    ~HeapTimer();
+
+    void init();
+    void release();
+
+    void update(int64_t delta);
+
+    // owner is not 0 means the timer is in the group of owner
+    int64_t add_timer(int32_t timerType, int64_t startTime, int64_t interval, int64_t times, TimerCallback callback, bool nextFromNow = false,
+                      int64_t owner = 0);
+    bool remove_timer(int64_t timerID);
+    void clear_timer();
+
+    // remove all timers of owner, return removed count
+    size_t remove_group(int64_t owner);
+    size_t get_group_count(int64_t owner) const;
+
+private:
+    enum HeapTimerDefine : size_t {
+        HeapArity = 4,
+        InvalidIndex = ~size_t(0),
+    };
+
+    void add_heap_node(HeapTimerNode* timer);
+    void remove_heap_node(HeapTimerNode* timer);
+    void sift_up(size_t index);
+    void sift_down(size_t index);
+    struct HeapEntry {
+        int64_t mNextTime;      // copy of timer next time, compare without touching node
+        HeapTimerNode* mTimer;  // timer
+    };
+    void set_heap_node(size_t index, const HeapEntry& entry);
+    static bool is_before(const HeapEntry& a, const HeapEntry& b);
+
+private:
+    int64_t mNow;
+
+    std::vector<HeapEntry> mHeap;
+    std::unordered_map<int64_t, HeapTimerNode*> mTimers;
+    TimerGroup mGroups;
+
+    IncrIDGen mIDGen;
+    ObjectPool<HeapTimerNode, 64 * 1024, SlabAllocator> mPool{"HeapTimerNode"};
+
+    PURE_DISABLE_COPY(HeapTimer)
+};
+}  // namespace PureCore
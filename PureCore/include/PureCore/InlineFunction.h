@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "PureCore/PureCoreLib.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace PureCore {
+// callable stored in a fixed inline buffer, never allocates
+// a callable larger than Capacity fails to compile
+template <typename Signature, size_t Capacity = 32>
+class InlineFunction;
+
+template <typename R, typename... Args, size_t Capacity>
+class InlineFunction<R(Args...), Capacity> {
+public:
+    typedef R (*ContextFunc)(void* ctx, Args... args);
+
+    InlineFunction() : mOps(nullptr) {}
+    InlineFunction(std::nullptr_t) : mOps(nullptr) {}
+    // fast path for raw function with context, no wrapper is generated
+    InlineFunction(ContextFunc func, void* ctx) : mOps(nullptr) {
+        if (func != nullptr) {
+            ContextCall call{func, ctx};
+            std::memcpy(mStorage, &call, sizeof(call));
+            mOps = &sContextOps;
+        }
+    }
+    template <typename F, typename Fn = typename std::decay<F>::type,
+              typename = typename std::enable_if<!std::is_same<Fn, InlineFunction>::value && !std::is_same<Fn, std::nullptr_t>::value>::type>
+    InlineFunction(F&& f) : mOps(nullptr) {
+        static_assert(sizeof(Fn) <= Capacity, "callable is too large for InlineFunction, reduce captures or raise Capacity");
+        static_assert(alignof(Fn) <= StorageAlign, "callable is over aligned for InlineFunction");
+        static_assert(std::is_copy_constructible<Fn>::value, "callable of InlineFunction must be copy constructible");
+        if (is_null(f)) {
+            return;
+        }
+        new (mStorage) Fn(std::forward<F>(f));
+        mOps = &FuncOps<Fn>::sOps;
+    }
+    InlineFunction(const InlineFunction& cp) : mOps(nullptr) { copy_from(cp); }
+    InlineFunction(InlineFunction&& cp) : mOps(nullptr) { move_from(cp); }
+    ~InlineFunction() { reset(); }
+
+    inline InlineFunction& operator=(const InlineFunction& cp) {
+        if (this != &cp) {
+            reset();
+            copy_from(cp);
+        }
+        return *this;
+    }
+    inline InlineFunction& operator=(InlineFunction&& cp) {
+        if (this != &cp) {
+            reset();
+            move_from(cp);
+        }
+        return *this;
+    }
+    inline InlineFunction& operator=(std::nullptr_t) {
+        reset();
+        return *this;
+    }
+
+    inline explicit operator bool() const { return mOps != nullptr; }
+    inline bool operator==(std::nullptr_t) const { return mOps == nullptr; }
+    inline bool operator!=(std::nullptr_t) const { return mOps != nullptr; }
+
+    // call an empty function is undefined
+    inline R operator()(Args... args) const { return mOps->mInvoke(const_cast<Storage*>(&mStorage), std::forward<Args>(args)...); }
+
+    inline void reset() {
+        if (mOps != nullptr && mOps->mDestroy != nullptr) {
+            mOps->mDestroy(&mStorage);
+        }
+        mOps = nullptr;
+    }
+
+private:
+    typedef unsigned char Storage[Capacity];
+    static constexpr size_t StorageAlign = alignof(int64_t) > alignof(void*) ? alignof(int64_t) : alignof(void*);
+    struct Ops {
+        R (*mInvoke)(void* storage, Args&&... args);
+        void (*mCopy)(void* dst, const void* src);  // nullptr is trivial copy
+        void (*mMove)(void* dst, void* src);        // move and destroy src, nullptr is trivial move
+        void (*mDestroy)(void* storage);            // nullptr is trivial destroy
+    };
+    struct ContextCall {
+        ContextFunc mFunc;
+        void* mCtx;
+    };
+
+    template <typename Fn>
+    struct FuncOps {
+        static R invoke(void* storage, Args&&... args) { return (*static_cast<Fn*>(storage))(std::forward<Args>(args)...); }
+        static void copy(void* dst, const void* src) { new (dst) Fn(*static_cast<const Fn*>(src)); }
+        static void move(void* dst, void* src) {
+            new (dst) Fn(std::move(*static_cast<Fn*>(src)));
+            static_cast<Fn*>(src)->~Fn();
+        }
+        static void destroy(void* storage) { static_cast<Fn*>(storage)->~Fn(); }
+
+        static constexpr bool sTrivial = std::is_trivially_copyable<Fn>::value && std::is_trivially_destructible<Fn>::value;
+        static constexpr Ops sOps{&FuncOps::invoke, sTrivial ? nullptr : &FuncOps::copy, sTrivial ? nullptr : &FuncOps::move,
+                                  sTrivial ? nullptr : &FuncOps::destroy};
+    };
+
+    static R invoke_context(void* storage, Args&&... args) {
+        ContextCall* call = static_cast<ContextCall*>(storage);
+        return call->mFunc(call->mCtx, std::forward<Args>(args)...);
+    }
+    static constexpr Ops sContextOps{&InlineFunction::invoke_context, nullptr, nullptr, nullptr};
+
+    template <typename F>
+    static inline bool is_null(const F& f) {
+        if constexpr (std::is_pointer<F>::value || std::is_member_pointer<F>::value || std::is_constructible<bool, const F&>::value) {
+            return !f;
+        } else {
+            return false;
+        }
+    }
+
+    inline void copy_from(const InlineFunction& cp) {
+        if (cp.mOps == nullptr) {
+            return;
+        }
+        if (cp.mOps->mCopy != nullptr) {
+            cp.mOps->mCopy(&mStorage, &cp.mStorage);
+        } else {
+            std::memcpy(mStorage, cp.mStorage, Capacity);
+        }
+        mOps = cp.mOps;
+    }
+    inline void move_from(InlineFunction& cp) {
+        if (cp.mOps == nullptr) {
+            return;
+        }
+        if (cp.mOps->mMove != nullptr) {
+            cp.mOps->mMove(&mStorage, &cp.mStorage);
+        } else {
+            std::memcpy(mStorage, cp.mStorage, Capacity);
+        }
+        mOps = cp.mOps;
+        cp.mOps = nullptr;
+    }
+
+    alignas(StorageAlign) Storage mStorage;
+    const Ops* mOps;
+};
+
+}  // namespace PureCore
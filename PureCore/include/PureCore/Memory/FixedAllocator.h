@@ -24,11 +24,14 @@
 
 #include "PureCore/PureCoreLib.h"
 #include "PureCore/NodeList.h"
+#include "PureCore/Memory/PoolStat.h"
 
 #include <stdint.h>
 #include <stddef.h>
 
 namespace PureCore {
+class MemoryChunk;
+
 class PURECORE_API FixedAllocator {
 public:
     FixedAllocator(size_t blockSize, uint8_t countBlocks);
@@ -42,8 +45,12 @@ public:
 
     void gc(bool all);
 
+    // stat owned by caller, must outlive the allocator
+    void set_stat(PoolStat* stat);
+
 private:
     int create_chunk();
+    void destroy_chunk(MemoryChunk* pChunk);
 
 private:
     size_t mBlockSize;     // block size
@@ -53,6 +60,7 @@ private:
     NodeList mFullList;    // full list
     NodeList mFreeList;    // free chunk list
     NodeList mEmptyList;   // empty chunk list
+    PoolStat* mStat;       // stat, nullable
     PURE_DISABLE_COPY(FixedAllocator)
 };
 
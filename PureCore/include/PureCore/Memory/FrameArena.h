@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "PureCore/PureCoreLib.h"
+
+#include <new>
+#include <stdint.h>
+#include <stddef.h>
+
+namespace PureCore {
+class ArenaBuffer;
+// bump allocator for one frame, all memory allocate in the frame is invalid after reset,
+// memory is not free one by one and no destructor is called
+class PURECORE_API FrameArena {
+public:
+    enum ESizeConst {
+        DefaultBlockSize = 64 * 1024,
+        DefaultAlign = 16,
+    };
+
+public:
+    FrameArena(size_t blockSize = DefaultBlockSize);
+    ~FrameArena();
+
+    void* allocate(size_t size, size_t align = DefaultAlign);
+    // grow in place if p is the last allocation, else allocate and copy
+    void* reallocate(void* p, size_t osize, size_t nsize, size_t align = DefaultAlign);
+    // the buffer is invalid after reset
+    ArenaBuffer* new_buffer(size_t size);
+
+    // call at frame end, merge blocks to one block if used more than one block
+    void reset();
+    // free all blocks, the frame moves on too
+    void release();
+
+    size_t get_used() const;
+    size_t get_capacity() const;
+    size_t get_high_water() const;
+    uint64_t get_frame() const;
+
+private:
+    struct Block {
+        Block* mNext;
+        size_t mSize;
+        size_t mUsed;
+    };
+    Block* new_block(size_t size);
+    void free_blocks();
+    static uint8_t* block_data(Block* block);
+
+private:
+    Block* mBlock;      // current block, old blocks link by mNext
+    size_t mBlockSize;  // min block size
+    size_t mUsed;       // used size this frame
+    size_t mCapacity;   // all block size
+    size_t mHighWater;  // max used size of all frames
+    uint64_t mFrame;    // frame count, memory allocated in older frames is invalid
+    uint8_t* mLast;     // last allocation
+
+    PURE_DISABLE_COPY(FrameArena)
+};
+
+// stl allocator of FrameArena, deallocate do nothing
+template <typename T>
+class FrameAllocator {
+public:
+    typedef T value_type;
+
+    FrameAllocator(FrameArena& arena) noexcept : mArena(&arena) {}
+    template <typename U>
+    FrameAllocator(const FrameAllocator<U>& other) noexcept : mArena(other.arena()) {}
+
+    T* allocate(size_t n) {
+        void* p = mArena->allocate(n * sizeof(T), alignof(T) > size_t(FrameArena::DefaultAlign) ? alignof(T) : size_t(FrameArena::DefaultAlign));
+        if (p == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(p);
+    }
+    void deallocate(T*, size_t) noexcept {}
+
+    FrameArena* arena() const noexcept { return mArena; }
+
+    template <typename U>
+    bool operator==(const FrameAllocator<U>& right) const noexcept {
+        return mArena == right.arena();
+    }
+    template <typename U>
+    bool operator!=(const FrameAllocator<U>& right) const noexcept {
+        return mArena != right.arena();
+    }
+
+private:
+    FrameArena* mArena;
+};
+
+}  // namespace PureCore
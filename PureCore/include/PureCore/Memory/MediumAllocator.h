@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "PureCore/PureCoreLib.h"
+#include "PureCore/NodeList.h"
+#include "PureCore/Memory/PageMemory.h"
+#include "PureCore/Memory/PoolStat.h"
+
+#include <vector>
+#include <stdint.h>
+#include <stddef.h>
+
+namespace PureCore {
+class MediumSegment;
+struct MediumSpan;
+
+// serve size in (PURE_BIG_SIZE, PURE_MEDIUM_SIZE], memory comes from segments aligned by segment size and split into page runs.
+// size not bigger than SpanMaxSize rounds up to a geometric size class and is carved from a span of that class,
+// bigger size uses a page run directly, which grows and shrinks in place when the neighbour pages are free
+class PURECORE_API MediumAllocator {
+public:
+    enum ESizeConst {
+        MinSize = PURE_BIG_SIZE,
+        MaxSize = PURE_MEDIUM_SIZE,
+        PageBit = 12,
+        PageSize = 1 << PageBit,
+        SegmentSize = 1024 * 1024,
+        SegmentPages = SegmentSize / PageSize,
+        ClassStepBit = 2,  // 4 size classes every power of 2
+        SpanMaxSize = 2 * PageSize,
+        SpanMinBlocks = 8,
+        ClassCount = (bit_log2(SpanMaxSize) - bit_log2(MinSize)) << ClassStepBit,
+    };
+
+public:
+    MediumAllocator();
+    ~MediumAllocator();
+
+    void* allocate(size_t size);
+    void deallocate(void* p, size_t size);
+    // osize and nsize must both in medium range
+    void* reallocate(void* p, size_t osize, size_t nsize);
+
+    size_t get_segment_count() const;
+
+    void gc(bool all);
+
+    // stat owned by caller, must outlive the allocator
+    void set_stat(PoolStat* stat);
+
+    static size_t class_index(size_t size);
+    static size_t class_size(size_t index);
+
+private:
+    void* allocate_block(size_t index);
+    void deallocate_block(MediumSpan* span, void* p);
+    void* allocate_run(size_t size);
+    void deallocate_run(MediumSpan* span);
+    bool resize_run(MediumSpan* span, size_t size);
+
+    MediumSpan* new_span(uint32_t pages);
+    void delete_span(MediumSpan* span);
+    void delete_segment(size_t index);
+    static MediumSpan* span_of(void* p);
+
+private:
+    std::vector<MediumSegment*> mSegments;  // all segments
+    NodeList mPartial[ClassCount];          // spans has free blocks
+    size_t mEmptySegments;                  // segments without span
+    PoolStat* mStat;                        // stat, nullable
+
+    PURE_DISABLE_COPY(MediumAllocator)
+};
+
+}  // namespace PureCore
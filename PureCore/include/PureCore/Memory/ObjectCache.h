@@ -23,7 +23,9 @@
 #pragma once
 
 #include "PureCore/PureCoreLib.h"
+#include "PureCore/Memory/PoolStat.h"
 
+#include <typeinfo>
 #include <vector>
 #include <stddef.h>
 
@@ -31,7 +33,11 @@ namespace PureCore {
 template <typename T, size_t MaxCache>
 class ObjectCache {
 public:
-    ObjectCache() : mObjects() {}
+    // name show in PoolRegistry, default is type name.
+    // countUsed is false for caches exchanging objects with another cache, such as get in one thread and free to the cache
+    // of another thread, the allocated count of them is meaningless, only free, hit and miss are reported
+    explicit ObjectCache(const char* name = nullptr, bool countUsed = true)
+        : mObjects(), mStat(name != nullptr ? name : typeid(T).name()), mCountUsed(countUsed) {}
 
     ~ObjectCache() {
         for (size_t i = 0; i < mObjects.size(); ++i) {
@@ -46,10 +52,19 @@ public:
     template <typename... Args>
     T* get(Args&&... args) {
         if (mObjects.empty()) {
+            mStat.miss();
+            if (mCountUsed) {
+                mStat.add_allocated(1);
+            }
             return new T(std::forward<Args>(args)...);
         }
         T* obj = mObjects.back();
         mObjects.pop_back();
+        mStat.hit();
+        if (mCountUsed) {
+            mStat.add_allocated(1);
+        }
+        mStat.add_free(-1);
         return obj;
     }
 
@@ -57,6 +72,9 @@ public:
         if (p == nullptr) {
             return;
         }
+        if (mCountUsed) {
+            mStat.add_allocated(-1);
+        }
         if (mObjects.size() >= MaxCache) {
             p->clear();
             delete p;
@@ -64,10 +82,15 @@ public:
         }
         p->clear();
         mObjects.push_back(p);
+        mStat.add_free(1);
     }
 
+    const PoolStat& get_stat() const { return mStat; }
+
 private:
     std::vector<T*> mObjects;
+    PoolStat mStat;
+    bool mCountUsed;
 
     PURE_DISABLE_COPY(ObjectCache)
 };
@@ -24,19 +24,28 @@
 
 #include "PureCore/PureCoreLib.h"
 #include "PureCore/Memory/FixedAllocator.h"
+#include "PureCore/Memory/SlabAllocator.h"
+#include "PureCore/Memory/PoolStat.h"
+#include "PureCore/Memory/PoolTrimmer.h"
 
+#include <typeinfo>
 #include <utility>
 
 namespace PureCore {
-template <typename T, uint8_t BlockCount>
-class ObjectPool {
+// ChunkArg is block count a chunk for FixedAllocator(max 255), chunk bytes for SlabAllocator
+template <typename T, size_t ChunkArg, typename Allocator = FixedAllocator>
+class ObjectPool : public PoolTrimmer {
 public:
-    ObjectPool() : mAllocator(sizeof(T), BlockCount) {}
+    // name show in PoolRegistry, default is type name
+    explicit ObjectPool(const char* name = nullptr) : mStat(name != nullptr ? name : typeid(T).name()), mAllocator(sizeof(T), ChunkArg) {
+        mAllocator.set_stat(&mStat);
+    }
 
-    ~ObjectPool() {}
+    ~ObjectPool() override {}
 
     template <typename... Args>
     T* get(Args&&... args) {
+        attach();
         void* p = mAllocator.allocate();
         return new (p) T(std::forward<Args>(args)...);
     }
@@ -47,13 +56,43 @@ public:
         }
         p->~T();
         mAllocator.deallocate(p);
-        if (mAllocator.get_empty_count() > 1) {
+        if (mAllocator.get_empty_count() > mRetention.mMaxSpare) {
+            mAllocator.gc(false);
+        }
+    }
+
+    void set_retention(const PoolRetention& retention) {
+        mRetention = retention;
+        if (mRetention.mMaxSpare < mRetention.mMinSpare) {
+            mRetention.mMaxSpare = mRetention.mMinSpare;
+        }
+        while (mAllocator.get_empty_count() > mRetention.mMaxSpare) {
+            mAllocator.gc(false);
+        }
+    }
+
+    const PoolRetention& get_retention() const { return mRetention; }
+
+    // release a spare chunk over min spare every decay, PureApp calls it with milli seconds when frame is idle
+    void trim(int64_t elapsed) override {
+        if (mAllocator.get_empty_count() <= mRetention.mMinSpare) {
+            mDecayElapsed = 0;
+            return;
+        }
+        mDecayElapsed += elapsed;
+        if (mDecayElapsed >= mRetention.mDecay) {
+            mDecayElapsed = 0;
             mAllocator.gc(false);
         }
     }
 
+    const PoolStat& get_stat() const { return mStat; }
+
 private:
-    FixedAllocator mAllocator;
+    PoolStat mStat;
+    Allocator mAllocator;
+    PoolRetention mRetention;
+    int64_t mDecayElapsed = 0;
 
     PURE_DISABLE_COPY(ObjectPool)
 };
@@ -0,0 +1,258 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "PureCore/PureCoreLib.h"
+#include "PureCore/Memory/PoolStat.h"
+
+#include <typeinfo>
+#include <vector>
+#include <atomic>
+#include <utility>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace PureCore {
+class RecycleObject;
+
+// shared by the owner thread and the threads return object to it
+struct RecycleHome {
+    std::atomic<RecycleObject*> mReturn{};  // lock free return list
+    std::atomic<size_t> mRef{1};            // owner thread + objects created by owner
+    std::atomic<bool> mClosed{};            // owner thread exited
+};
+
+struct RecycleStat {
+    uint64_t mHit = 0;     // get from cache
+    uint64_t mMiss = 0;    // get by new
+    uint64_t mRemote = 0;  // returned by other thread
+    uint64_t mLive = 0;    // objects created by this thread and not delete
+};
+
+// object recycled by ObjectRecycler must derived from RecycleObject
+class RecycleObject {
+public:
+    RecycleObject() = default;
+    RecycleObject(const RecycleObject&) {}
+    ~RecycleObject() = default;
+    RecycleObject& operator=(const RecycleObject&) { return *this; }
+
+private:
+    template <typename T, size_t MaxCache, size_t BatchSize>
+    friend class ObjectRecycler;
+    RecycleHome* mRecycleHome = nullptr;
+    RecycleObject* mRecycleNext = nullptr;
+};
+
+// use as thread_local, object free in other thread return to the thread created it in batch,
+// keep the object inner buffer for reuse
+template <typename T, size_t MaxCache, size_t BatchSize = 32>
+class ObjectRecycler {
+public:
+    enum ESizeConst {
+        OutboxSize = 4,
+    };
+
+public:
+    // name show in PoolRegistry, default is type name
+    explicit ObjectRecycler(const char* name = nullptr) : mHome(new RecycleHome()), mObjects(), mPoolStat(name != nullptr ? name : typeid(T).name()) {}
+
+    ~ObjectRecycler() {
+        flush();
+        mHome->mClosed.store(true);
+        size_t count = 0;
+        for (size_t i = 0; i < mObjects.size(); ++i) {
+            delete mObjects[i];
+            ++count;
+        }
+        mObjects.clear();
+        count += delete_list(mHome->mReturn.exchange(nullptr));
+        release_home(mHome, count + 1);
+        mHome = nullptr;
+    }
+
+    template <typename... Args>
+    T* get(Args&&... args) {
+        if (mObjects.empty() && mHome->mReturn.load(std::memory_order_relaxed) != nullptr) {
+            collect();
+        }
+        if (!mObjects.empty()) {
+            T* obj = mObjects.back();
+            mObjects.pop_back();
+            mPoolStat.hit();
+            mPoolStat.add_allocated(1);
+            mPoolStat.add_free(-1);
+            return obj;
+        }
+        T* obj = new T(std::forward<Args>(args)...);
+        if (obj == nullptr) {
+            return nullptr;
+        }
+        obj->mRecycleHome = mHome;
+        mHome->mRef.fetch_add(1, std::memory_order_relaxed);
+        mPoolStat.miss();
+        mPoolStat.add_allocated(1);
+        return obj;
+    }
+
+    void free(T* p) {
+        if (p == nullptr) {
+            return;
+        }
+        p->clear();
+        RecycleHome* home = p->mRecycleHome;
+        if (home == mHome) {
+            put_local(p);
+        } else if (home == nullptr) {
+            delete p;
+        } else {
+            put_outbox(home, p);
+        }
+    }
+
+    // return the objects waiting in outbox to their owner thread
+    void flush() {
+        for (size_t i = 0; i < OutboxSize; ++i) {
+            flush_outbox(mOutbox[i]);
+        }
+    }
+
+    RecycleStat get_stat() const {
+        PoolStatInfo info = mPoolStat.info();
+        RecycleStat stat;
+        stat.mHit = info.mHit;
+        stat.mMiss = info.mMiss;
+        stat.mRemote = mRemote;
+        stat.mLive = mHome->mRef.load(std::memory_order_relaxed) - 1;
+        return stat;
+    }
+
+    size_t cache_size() const { return mObjects.size(); }
+
+private:
+    struct Outbox {
+        RecycleHome* mHome = nullptr;
+        RecycleObject* mHead = nullptr;
+        RecycleObject* mTail = nullptr;
+        size_t mCount = 0;
+    };
+
+    void collect() {
+        RecycleObject* obj = mHome->mReturn.exchange(nullptr, std::memory_order_acquire);
+        while (obj != nullptr) {
+            RecycleObject* next = obj->mRecycleNext;
+            obj->mRecycleNext = nullptr;
+            ++mRemote;
+            put_local(static_cast<T*>(obj));
+            obj = next;
+        }
+    }
+
+    void put_local(T* p) {
+        mPoolStat.add_allocated(-1);
+        if (mObjects.size() >= MaxCache) {
+            delete p;
+            release_home(mHome, 1);
+            return;
+        }
+        mObjects.push_back(p);
+        mPoolStat.add_free(1);
+    }
+
+    void put_outbox(RecycleHome* home, T* p) {
+        Outbox* box = nullptr;
+        for (size_t i = 0; i < OutboxSize; ++i) {
+            if (mOutbox[i].mHome == home) {
+                box = &mOutbox[i];
+                break;
+            }
+            if (box == nullptr && mOutbox[i].mHome == nullptr) {
+                box = &mOutbox[i];
+            }
+        }
+        if (box == nullptr) {
+            box = &mOutbox[mOutboxVictim];
+            mOutboxVictim = (mOutboxVictim + 1) % OutboxSize;
+            flush_outbox(*box);
+        }
+        RecycleObject* obj = p;
+        obj->mRecycleNext = box->mHead;
+        box->mHead = obj;
+        if (box->mTail == nullptr) {
+            box->mTail = obj;
+        }
+        box->mHome = home;
+        if (++box->mCount >= BatchSize) {
+            flush_outbox(*box);
+        }
+    }
+
+    static void flush_outbox(Outbox& box) {
+        if (box.mHome == nullptr) {
+            return;
+        }
+        RecycleHome* home = box.mHome;
+        // the owner may free the returned objects and their home right after they are pushed, hold home until done
+        home->mRef.fetch_add(1, std::memory_order_relaxed);
+        RecycleObject* head = home->mReturn.load(std::memory_order_relaxed);
+        do {
+            box.mTail->mRecycleNext = head;
+        } while (!home->mReturn.compare_exchange_weak(head, box.mHead));
+        box = Outbox();
+        size_t count = 1;
+        // owner exited, nobody collect the return list
+        if (home->mClosed.load()) {
+            count += delete_list(home->mReturn.exchange(nullptr));
+        }
+        release_home(home, count);
+    }
+
+    static size_t delete_list(RecycleObject* obj) {
+        size_t count = 0;
+        while (obj != nullptr) {
+            RecycleObject* next = obj->mRecycleNext;
+            delete static_cast<T*>(obj);
+            ++count;
+            obj = next;
+        }
+        return count;
+    }
+
+    static void release_home(RecycleHome* home, size_t count) {
+        if (count > 0 && home->mRef.fetch_sub(count, std::memory_order_acq_rel) == count) {
+            delete home;
+        }
+    }
+
+private:
+    RecycleHome* mHome;
+    std::vector<T*> mObjects;
+    Outbox mOutbox[OutboxSize];
+    size_t mOutboxVictim = 0;
+    uint64_t mRemote = 0;  // returned by other thread
+    PoolStat mPoolStat;
+
+    PURE_DISABLE_COPY(ObjectRecycler)
+};
+
+}  // namespace PureCore
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "PureCore/PureCoreLib.h"
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace PureCore {
+// map memory aligned by size, size must be power of 2, try huge page if hugePage is true and report the result by it
+PURECORE_API void* map_aligned_pages(size_t size, bool& hugePage);
+PURECORE_API void unmap_aligned_pages(void* p, size_t size);
+
+// floor of log2, v must not be 0
+constexpr uint32_t bit_log2(size_t v) { return v <= 1 ? 0 : 1 + bit_log2(v >> 1); }
+
+// count trailing zero, v must not be 0
+inline uint32_t bit_ctz(uint64_t v) {
+#ifdef _MSC_VER
+    unsigned long idx = 0;
+    _BitScanForward64(&idx, v);
+    return static_cast<uint32_t>(idx);
+#else
+    return static_cast<uint32_t>(__builtin_ctzll(v));
+#endif
+}
+
+}  // namespace PureCore
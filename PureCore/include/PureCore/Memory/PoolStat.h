@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "PureCore/PureCoreLib.h"
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace PureCore {
+// snapshot of pool counters, pools with same name are merged
+struct PoolStatInfo {
+    std::string mName;
+    int64_t mAllocated = 0;  // blocks in use
+    int64_t mFree = 0;       // free blocks hold by pool
+    int64_t mChunks = 0;     // chunk count
+    int64_t mBytes = 0;      // memory hold by chunks
+    int64_t mHit = 0;        // get from cache
+    int64_t mMiss = 0;       // get from system
+    int64_t mHighWater = 0;  // max blocks in use
+    int64_t mInstances = 0;  // pool instances merged
+};
+
+// live counters of a pool, register to PoolRegistry on construct.
+// write by the thread using the pool only, so update with relaxed load and store, read from any thread
+class PURECORE_API PoolStat {
+public:
+    explicit PoolStat(const char* name);
+    ~PoolStat();
+
+    const std::string& name() const { return mName; }
+
+    void add_allocated(int64_t n) {
+        int64_t v = mAllocated.load(std::memory_order_relaxed) + n;
+        mAllocated.store(v, std::memory_order_relaxed);
+        if (v > mHighWater.load(std::memory_order_relaxed)) {
+            mHighWater.store(v, std::memory_order_relaxed);
+        }
+    }
+    void add_free(int64_t n) { add(mFree, n); }
+    void add_chunks(int64_t n, int64_t bytes) {
+        add(mChunks, n);
+        add(mBytes, bytes);
+    }
+    void set_free(int64_t n) { mFree.store(n, std::memory_order_relaxed); }
+    void hit() { add(mHit, 1); }
+    void miss() { add(mMiss, 1); }
+
+    PoolStatInfo info() const;
+
+private:
+    static void add(std::atomic<int64_t>& counter, int64_t n) { counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed); }
+
+private:
+    std::string mName;
+    std::atomic<int64_t> mAllocated{};
+    std::atomic<int64_t> mFree{};
+    std::atomic<int64_t> mChunks{};
+    std::atomic<int64_t> mBytes{};
+    std::atomic<int64_t> mHit{};
+    std::atomic<int64_t> mMiss{};
+    std::atomic<int64_t> mHighWater{};
+
+    PURE_DISABLE_COPY(PoolStat)
+};
+
+class PURECORE_API PoolRegistry {
+public:
+    static PoolRegistry* inst();
+
+    void add(PoolStat* stat);
+    void remove(PoolStat* stat);
+
+    // merge pools with same name, such as thread local pools
+    std::vector<PoolStatInfo> get_stats() const;
+    void dump() const;
+
+private:
+    PoolRegistry() = default;
+    ~PoolRegistry() = default;
+
+private:
+    mutable std::mutex mMutex;
+    std::vector<PoolStat*> mStats;
+
+    PURE_DISABLE_COPY(PoolRegistry)
+};
+
+}  // namespace PureCore
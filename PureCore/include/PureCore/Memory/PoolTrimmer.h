@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "PureCore/PureCoreLib.h"
+#include "PureCore/NodeList.h"
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace PureCore {
+// spare chunk retention of pool, spare chunks over max are released at once,
+// spare chunks over min are released one by one every decay when trim
+struct PoolRetention {
+    size_t mMinSpare = 1;   // spare chunks never released by trim
+    size_t mMaxSpare = 4;   // spare chunks kept by free
+    int64_t mDecay = 1000;  // elapsed between two release by trim, unit is decided by the trim caller
+};
+
+// pool attaches to the trimmer list of the thread first uses it, trim_thread() trims pools of the calling thread
+class PURECORE_API PoolTrimmer : public Node {
+public:
+    PoolTrimmer();
+    virtual ~PoolTrimmer();
+
+    virtual void trim(int64_t elapsed) = 0;
+
+    static void trim_thread(int64_t elapsed);
+
+protected:
+    void attach() {
+        if (!mAttached) {
+            attach_thread();
+        }
+    }
+
+private:
+    void attach_thread();
+
+private:
+    bool mAttached;  // in trimmer list of a thread
+};
+
+}  // namespace PureCore
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "PureCore/PureCoreLib.h"
+#include "PureCore/NodeList.h"
+#include "PureCore/Memory/PoolStat.h"
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace PureCore {
+class SlabChunk;
+
+// same api with FixedAllocator, but chunk size is configurable, such as 64KB or 2MB, not limit by 255 blocks
+class PURECORE_API SlabAllocator {
+public:
+    enum ESizeConst {
+        MinChunkSize = 4 * 1024,
+        HugePageSize = 2 * 1024 * 1024,
+        MinChunkBlocks = 8,
+    };
+
+public:
+    SlabAllocator(size_t blockSize, size_t chunkSize, bool hugePage = false);
+    ~SlabAllocator();
+
+    void* allocate();
+    void deallocate(void* p);
+
+    size_t get_full_count() const;
+    size_t get_empty_count() const;
+    size_t get_chunk_size() const;
+    size_t get_chunk_blocks() const;
+
+    void gc(bool all);
+
+    // stat owned by caller, must outlive the allocator
+    void set_stat(PoolStat* stat);
+
+private:
+    int create_chunk();
+    void destroy_chunk(SlabChunk* pChunk);
+
+private:
+    size_t mBlockSize;      // block size
+    size_t mChunkSize;      // chunk size, power of 2
+    uint32_t mCountBlocks;  // block count a chunk
+    bool mHugePage;         // try huge page
+    size_t mFullCount;      // full count
+    size_t mEmptyCount;     // empty chunk count
+    NodeList mFullList;     // full list
+    NodeList mFreeList;     // free chunk list
+    NodeList mEmptyList;    // empty chunk list
+    PoolStat* mStat;        // stat, nullable
+    PURE_DISABLE_COPY(SlabAllocator)
+};
+
+}  // namespace PureCore
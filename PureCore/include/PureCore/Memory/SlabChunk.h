@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "PureCore/PureCoreLib.h"
+#include "PureCore/NodeList.h"
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace PureCore {
+// chunk memory is aligned by chunk size, header and free bitmap at the chunk front
+class PURECORE_API SlabChunk : public Node {
+public:
+    ~SlabChunk();
+
+    void* allocate(size_t blockSize);
+    int deallocate(void* p, size_t blockSize);
+
+    uint32_t free_count() const;
+    uint32_t block_count() const;
+
+    static SlabChunk* create(size_t blockSize, size_t chunkSize, bool hugePage);
+    static void destroy(SlabChunk* chunk);
+    static SlabChunk* self(void* p, size_t chunkSize);
+    static uint32_t calc_block_count(size_t blockSize, size_t chunkSize);
+
+private:
+    SlabChunk(size_t chunkSize, uint32_t countBlocks, bool hugePage);
+    static size_t head_size(uint32_t countBlocks);
+
+private:
+    size_t mChunkSize;        // chunk size
+    uint8_t* mData;           // first block
+    uint64_t* mBitmap;        // free bitmap, 1 is free
+    uint32_t mCountBlocks;    // block count
+    uint32_t mCountAvBlocks;  // free block count
+    uint32_t mHint;           // first bitmap word may has free block
+    bool mHugePage;           // map by huge page
+
+    PURE_DISABLE_COPY(SlabChunk)
+};
+
+}  // namespace PureCore
@@ -24,6 +24,7 @@
 
 #include "PureCore/PureCoreLib.h"
 #include "PureCore/Memory/FixedAllocator.h"
+#include "PureCore/Memory/MediumAllocator.h"
 
 #include <stdint.h>
 
@@ -32,12 +33,13 @@ class PURECORE_API SmallAllocator {
 public:
     enum ESizeConst {
         BigObjectSize = PURE_BIG_SIZE,
+        MediumObjectSize = PURE_MEDIUM_SIZE,
         OffSet = 1 << PURE_ALIGN_BIT,
         OffSetBit = PURE_ALIGN_BIT,
     };
 
 public:
-    SmallAllocator();
+    explicit SmallAllocator(const char* name = "SmallAllocator");
     ~SmallAllocator();
 
     void* allocate(size_t size);
@@ -48,6 +50,8 @@ public:
 
 private:
     FixedAllocator* mPool[(BigObjectSize + OffSet - 1) / OffSet];
+    PoolStat mStat;           // shared by all size class, miss means big object from system
+    MediumAllocator mMedium;  // object bigger than BigObjectSize and not bigger than MediumObjectSize
 
     PURE_DISABLE_COPY(SmallAllocator)
 };
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "PureCore/PureCoreLib.h"
+#include "PureCore/Memory/SlabAllocator.h"
+
+#include <cstddef>
+#include <stdint.h>
+#include <stddef.h>
+
+namespace PureCore {
+class ThreadCacheHeap;
+// thread caching front end of SmallAllocator, every thread owns a heap with magazines per size class,
+// block free by other thread return to owner heap by lock free remote list, blocks are aligned by max_align_t
+class PURECORE_API ThreadCacheAllocator {
+public:
+    enum ESizeConst {
+        BigObjectSize = PURE_BIG_SIZE,
+        OffSet = 1 << PURE_ALIGN_BIT,
+        OffSetBit = PURE_ALIGN_BIT,
+        ClassCount = (BigObjectSize + OffSet - 1) / OffSet,
+        Align = alignof(std::max_align_t),
+        HeadSize = (sizeof(void*) + Align - 1) / Align * Align,
+        MagazineSize = 64,
+        ChunkSize = 16 * 1024,
+    };
+
+public:
+    ThreadCacheAllocator() = default;
+    ~ThreadCacheAllocator() = default;
+
+    static void* allocate(size_t size);
+    static void deallocate(void* p, size_t size);
+    static void* reallocate(void* p, size_t osize, size_t nsize);
+
+    // collect remote free blocks and release empty chunks of this thread, reclaim heaps of exited threads
+    static void gc(bool all);
+
+private:
+    friend class ThreadCacheHolder;
+    static ThreadCacheHeap* local_heap();
+    static ThreadCacheHeap* adopt_heap();
+    static void abandon_heap(ThreadCacheHeap* heap);
+    static void reclaim_heaps();
+
+    PURE_DISABLE_COPY(ThreadCacheAllocator)
+};
+
+}  // namespace PureCore
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "PureCore/PureCoreLib.h"
+#include "PureCore/Geometry.h"
+#include "PureCore/GridMap.h"
+#include "PureCore/InlineFunction.h"
+
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace PureCore {
+class Task;
+class TaskRange;
+
+enum EPathFlag {
+    PathJps = 1,      // jump point search, plain A* without it
+    PathSmooth = 2,   // drop the waypoints the path can see past
+    PathNoCache = 4,  // search again even when the cache holds the path
+};
+
+// 8 way search on a GridMap, a diagonal step needs both side cells walkable. the open list, the cell states and
+// the cache are kept between queries, one finder must not be used by two threads at once
+class PURECORE_API PathFinder {
+public:
+    explicit PathFinder(size_t cacheSize = 64);
+    ~PathFinder() = default;
+
+    // path gets the waypoints from start to goal, both included, cells between two waypoints lie on a straight line.
+    // return ErrorPathNotFound when goal can't be reached
+    int find_path(const GridMap& map, const IntPoint& start, const IntPoint& goal, std::vector<IntPoint>& path,
+                  uint32_t flags = PathJps | PathSmooth);
+
+    // lru cache of recent paths by start cell, goal cell and flags, emptied when the map changes
+    size_t cache_size() const;
+    void set_cache_size(size_t size);
+    void clear_cache();
+    uint64_t cache_hits() const;
+    // nodes popped from the open list by the last search
+    size_t expanded() const;
+
+private:
+    struct PathCell {
+        uint32_t mGen;
+        uint32_t mG;
+        uint32_t mParent;
+    };
+    struct OpenItem {
+        uint32_t mF;
+        uint32_t mG;
+        uint32_t mIdx;
+    };
+    // smaller f first, then bigger g which is nearer the goal
+    static bool open_greater(const OpenItem& a, const OpenItem& b) { return a.mF != b.mF ? a.mF > b.mF : a.mG < b.mG; }
+    struct CacheEntry {
+        uint64_t mKey;
+        int mErr;
+        std::vector<IntPoint> mPath;
+    };
+
+    int search(const GridMap& map, const IntPoint& start, const IntPoint& goal, std::vector<IntPoint>& path, uint32_t flags);
+    void reset(const GridMap& map);
+    void open(uint32_t idx, uint32_t parent, uint32_t g, const IntPoint& p, const IntPoint& goal);
+    void expand_astar(const GridMap& map, const IntPoint& p, uint32_t idx, uint32_t g, const IntPoint& goal);
+    void expand_jps(const GridMap& map, const IntPoint& p, uint32_t idx, uint32_t g, const IntPoint& goal);
+    static bool jump(const GridMap& map, IntPoint p, int32_t dx, int32_t dy, const IntPoint& goal, IntPoint& out);
+    static void smooth(const GridMap& map, std::vector<IntPoint>& path);
+
+private:
+    int32_t mWidth = 0;
+    int32_t mHeight = 0;
+    uint32_t mGen = 0;
+    std::vector<PathCell> mCells;
+    std::vector<OpenItem> mOpen;
+    size_t mExpanded = 0;
+
+    size_t mCacheSize;
+    uint64_t mCacheStamp = 0;
+    uint64_t mCacheHits = 0;
+    std::list<CacheEntry> mCacheList;  // most recent first
+    std::unordered_map<uint64_t, std::list<CacheEntry>::iterator> mCacheMap;
+
+    PURE_DISABLE_COPY(PathFinder)
+};
+
+class PathBatch;
+typedef InlineFunction<void(PathBatch& batch), 48> PathBatchCallback;
+
+// many searches on the task pool, each worker owns a PathFinder kept for later runs, so keep a batch for many frames
+class PURECORE_API PathBatch {
+public:
+    explicit PathBatch(size_t cacheSize = 64);
+    ~PathBatch();
+
+    // fail with ErrorTaskAlreadyRunning while running
+    int add(const IntPoint& start, const IntPoint& goal, uint32_t flags = PathJps | PathSmooth);
+    int clear();
+    size_t size() const;
+    bool is_running() const;
+    // result of request index after the run finished
+    int error(size_t index) const;
+    const std::vector<IntPoint>& path(size_t index) const;
+
+    // search in the task threads, done is called by Task::update once all finished. the map must stay unchanged and
+    // the batch alive until then
+    int run(Task& task, const GridMap& map, PathBatchCallback done);
+    // search in the task threads and the calling thread, return when all finished
+    int run_wait(Task& task, const GridMap& map);
+
+private:
+    struct PathRequest {
+        IntPoint mStart;
+        IntPoint mGoal;
+        uint32_t mFlags;
+        int mErr;
+        std::vector<IntPoint> mPath;
+    };
+    void prepare(const GridMap& map, size_t workers);
+    void work(size_t worker);
+    void finish();
+
+private:
+    size_t mCacheSize;
+    size_t mCount = 0;
+    std::vector<PathRequest> mRequests;  // kept past clear to reuse the paths
+    std::vector<std::unique_ptr<PathFinder>> mFinders;
+    std::unique_ptr<TaskRange> mRange;
+    const GridMap* mMap = nullptr;
+    size_t mPending = 0;
+    bool mRunning = false;
+    PathBatchCallback mDone;
+
+    PURE_DISABLE_COPY(PathBatch)
+};
+
+}  // namespace PureCore
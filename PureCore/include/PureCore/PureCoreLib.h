@@ -74,6 +74,9 @@
 #if !defined(PURE_BIG_SIZE)
 #define PURE_BIG_SIZE 1024  // big object size
 #endif
+#if !defined(PURE_MEDIUM_SIZE)
+#define PURE_MEDIUM_SIZE (256 * 1024)  // medium object size, bigger object alloc by system
+#endif
 #if !defined(PURE_ALIGN_BIT)
 #define PURE_ALIGN_BIT 3  // memory align
 #endif
@@ -26,11 +26,14 @@
 #include "PureCore/Memory/ObjectPool.h"
 #include "PureCore/Geometry.h"
 
+#include <algorithm>
 #include <array>
-#include <unordered_map>
 #include <functional>
+#include <unordered_map>
+#include <utility>
 
 namespace PureCore {
+class StaticRectTree;
 struct PURECORE_API QuadObject {
     int64_t mObjID = 0;
     IntABox mABox{};
@@ -45,7 +48,10 @@ public:
 
 private:
     void add_obj(QuadObject* obj);
-    void remove_obj(QuadNode* parent, QuadObject* obj);
+    // box is the box obj was added with
+    void remove_obj(QuadNode* parent, QuadObject* obj, const IntABox& box);
+    // obj box changed from oldBox, only quadrants it leaves or enters are touched
+    void update_obj(QuadObject* obj, const IntABox& oldBox);
     void try_merge();
     void split();
     int quadrant_box(ArrayRef<IntABox>& arr) const;
@@ -58,6 +64,8 @@ private:
     QuadTree* mTree;
     std::array<QuadNode*, 4> mChildren{};
     std::vector<QuadObject*> mObjs;
+    // boxes of mObjs in the same order, for the batch tests
+    IntABoxArray mObjBoxes;
     IntABox mABox{};
 };
 
@@ -78,13 +86,71 @@ public:
     bool is_collide_circle(const IntCircle& cir);
     bool is_collide_sector(const IntSector& sec);
     bool is_collide_obox(const IntOBox& obox);
+    // append colliding objs to out and return the count appended, results survive later queries
+    size_t query_abox(const IntABox& box, std::vector<QuadObject*>& out);
+    size_t query_circle(const IntCircle& cir, std::vector<QuadObject*>& out);
+    size_t query_sector(const IntSector& sec, std::vector<QuadObject*>& out);
+    size_t query_obox(const IntOBox& obox, std::vector<QuadObject*>& out);
+    // append up to k objs nearest to p, nearest first, radius < 0 means no limit
+    size_t knn(const IntPoint& p, size_t k, std::vector<QuadObject*>& out, int32_t radius = -1);
+    // nearest obj within radius, nullptr when none
+    QuadObject* nearest(const IntPoint& p, int32_t radius = -1);
+    const std::vector<QuadObject*>& collide_line(const IntLine& line);
+    bool is_collide_line(const IntLine& line);
+    size_t query_line(const IntLine& line, std::vector<QuadObject*>& out);
+    // first obj hit walking from from to to, false when the segment hits nothing
+    bool first_hit_raycast(const IntPoint& from, const IntPoint& to, RayHit& hit);
+    // hits[i] is the first hit of rays[i] from mMin to mMax, mObjID is 0 for a miss. return the count of rays hitting
+    size_t first_hit_raycast_many(const IntLine* rays, size_t count, RayHit* hits);
+
+    // visitor(QuadObject*) is called once for each obj colliding box and passing check(const IntABox&),
+    // it returns false to stop. the tree must not be changed while visiting
+    template <typename Check, typename Visitor>
+    void visit(const IntABox& box, Check&& check, Visitor&& visitor);
+    template <typename Visitor>
+    void visit_abox(const IntABox& box, Visitor&& visitor);
+    template <typename Visitor>
+    void visit_circle(const IntCircle& cir, Visitor&& visitor);
+    template <typename Visitor>
+    void visit_sector(const IntSector& sec, Visitor&& visitor);
+    template <typename Visitor>
+    void visit_obox(const IntOBox& obox, Visitor&& visitor);
+    template <typename Visitor>
+    void visit_line(const IntLine& line, Visitor&& visitor);
+    // ordered along the segment, visitor(QuadObject*, double t) gets each obj hit by line once, by the fraction t where
+    // line enters it, until it returns false
+    template <typename Visitor>
+    void visit_ray(const IntLine& line, Visitor&& visitor);
+    // best first, visitor(QuadObject*, int64_t dist2) is called nearest first until it returns false
+    template <typename Visitor>
+    void visit_nearest(const IntPoint& p, int32_t radius, Visitor&& visitor);
+
     int insert(int64_t objID, const IntABox& box);
     int remove(int64_t objID);
+    // move obj in place, insert when not found
+    int update(int64_t objID, const IntABox& box);
+    // freeze the objs into out, whose const queries are safe from many threads while this tree keeps changing
+    int snapshot(StaticRectTree& out, uint32_t maxElem = 16) const;
 
 private:
-    const std::vector<QuadObject*>& collide(const IntABox& box, size_t limit, const std::function<bool(const IntABox& dst)> check = nullptr);
+    struct NearItem {
+        int64_t mDist;
+        QuadNode* mNode;
+        QuadObject* mObj;
+    };
+    static bool near_greater(const NearItem& a, const NearItem& b) { return a.mDist > b.mDist; }
+    struct RayItem {
+        double mT;
+        QuadNode* mNode;
+        QuadObject* mObj;
+    };
+    // nodes come before objs at the same t, and copies of one obj from several leaves pop back to back
+    static bool ray_greater(const RayItem& a, const RayItem& b) {
+        return a.mT != b.mT ? a.mT > b.mT : std::greater<QuadObject*>()(a.mObj, b.mObj);
+    }
 
-private:
+    // an obj in several leaves is reported by the one leaf holding p, p is clamped into the tree box
+    bool is_owner(const QuadNode* leaf, const IntPoint& p) const;
     std::vector<QuadNode*>& use_cache();
 
     QuadNode* get_node();
@@ -96,11 +162,173 @@ private:
     QuadNode* mRoot = nullptr;
     uint32_t mMaxElem;
     std::unordered_map<int64_t, QuadObject*> mObjs;
-    ObjectPool<QuadNode, 128> mNodePool;
-    ObjectPool<QuadObject, 128> mObjPool;
+    ObjectPool<QuadNode, 64 * 1024, SlabAllocator> mNodePool{"QuadNode"};
+    ObjectPool<QuadObject, 64 * 1024, SlabAllocator> mObjPool{"QuadObject"};
     std::vector<QuadNode*> mCache;
     std::vector<QuadObject*> mResult;
+    std::vector<NearItem> mNearHeap;
+    std::vector<RayItem> mRayHeap;
 
     PURE_DISABLE_COPY(QuadTree)
 };
+
+template <typename Check, typename Visitor>
+void QuadTree::visit(const IntABox& box, Check&& check, Visitor&& visitor) {
+    if (!box.intersect(mRoot->mABox)) {
+        return;
+    }
+    // visitors may query again, they push and pop above base
+    auto& searchCache = use_cache();
+    size_t base = searchCache.size();
+    searchCache.push_back(mRoot);
+    while (searchCache.size() > base) {
+        QuadNode* node = searchCache.back();
+        searchCache.pop_back();
+        if (!node->is_leaf()) {
+            for (auto c : node->mChildren) {
+                if (box.intersect(c->mABox)) {
+                    searchCache.push_back(c);
+                }
+            }
+            continue;
+        }
+        auto& boxes = node->mObjBoxes;
+        for (size_t off = 0; off < boxes.size(); off += 64) {
+            size_t n = std::min<size_t>(boxes.size() - off, 64);
+            uint64_t bits = intersect_abox_bits(box, boxes.min_x() + off, boxes.min_y() + off, boxes.max_x() + off, boxes.max_y() + off, n);
+            for (size_t i = 0; bits != 0; ++i, bits >>= 1) {
+                if ((bits & 1) == 0) {
+                    continue;
+                }
+                QuadObject* o = node->mObjs[off + i];
+                IntPoint p{std::max(o->mABox.mMin.mX, box.mMin.mX), std::max(o->mABox.mMin.mY, box.mMin.mY)};
+                if (!is_owner(node, p) || !check(o->mABox)) {
+                    continue;
+                }
+                if (!visitor(o)) {
+                    searchCache.resize(base);
+                    return;
+                }
+            }
+        }
+    }
+}
+
+template <typename Visitor>
+void QuadTree::visit_abox(const IntABox& box, Visitor&& visitor) {
+    visit(box, [](const IntABox&) { return true; }, std::forward<Visitor>(visitor));
+}
+
+template <typename Visitor>
+void QuadTree::visit_circle(const IntCircle& cir, Visitor&& visitor) {
+    visit(cir.get_bounding(), [&cir](const IntABox& dst) { return dst.intersect_circle(cir); }, std::forward<Visitor>(visitor));
+}
+
+template <typename Visitor>
+void QuadTree::visit_sector(const IntSector& sec, Visitor&& visitor) {
+    visit(sec.get_bounding(), [&sec](const IntABox& dst) { return dst.intersect_sector(sec); }, std::forward<Visitor>(visitor));
+}
+
+template <typename Visitor>
+void QuadTree::visit_obox(const IntOBox& obox, Visitor&& visitor) {
+    visit(obox.get_bounding(), [&obox](const IntABox& dst) { return dst.intersect_obox(obox); }, std::forward<Visitor>(visitor));
+}
+
+template <typename Visitor>
+void QuadTree::visit_line(const IntLine& line, Visitor&& visitor) {
+    visit(line.get_bounding(), [&line](const IntABox& dst) {
+        double t = 0.0;
+        return dst.line_enter(line, t);
+    }, std::forward<Visitor>(visitor));
+}
+
+template <typename Visitor>
+void QuadTree::visit_ray(const IntLine& line, Visitor&& visitor) {
+    double t = 0.0;
+    if (!mRoot->mABox.line_enter(line, t)) {
+        return;
+    }
+    // a local heap keeps nested queries in the visitor safe, the member one is reused when free
+    std::vector<RayItem> localHeap;
+    auto& heap = mRayHeap.empty() ? mRayHeap : localHeap;
+    heap.push_back(RayItem{t, mRoot, nullptr});
+    QuadObject* last = nullptr;
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), ray_greater);
+        RayItem item = heap.back();
+        heap.pop_back();
+        if (item.mObj != nullptr) {
+            if (item.mObj == last) {
+                continue;
+            }
+            last = item.mObj;
+            if (!visitor(item.mObj, item.mT)) {
+                break;
+            }
+            continue;
+        }
+        QuadNode* node = item.mNode;
+        if (!node->is_leaf()) {
+            for (auto c : node->mChildren) {
+                if (c->mABox.line_enter(line, t)) {
+                    heap.push_back(RayItem{t, c, nullptr});
+                    std::push_heap(heap.begin(), heap.end(), ray_greater);
+                }
+            }
+            continue;
+        }
+        // only leaves entered no later than the obj push it, so all its copies sit in the heap together
+        for (auto o : node->mObjs) {
+            if (o->mABox.line_enter(line, t) && t >= item.mT) {
+                heap.push_back(RayItem{t, nullptr, o});
+                std::push_heap(heap.begin(), heap.end(), ray_greater);
+            }
+        }
+    }
+    heap.clear();
+}
+
+template <typename Visitor>
+void QuadTree::visit_nearest(const IntPoint& p, int32_t radius, Visitor&& visitor) {
+    int64_t maxDist = radius < 0 ? INT64_MAX : int64_t(radius) * radius;
+    // a local heap keeps nested queries in the visitor safe, the member one is reused when free
+    std::vector<NearItem> localHeap;
+    auto& heap = mNearHeap.empty() ? mNearHeap : localHeap;
+    heap.push_back(NearItem{mRoot->mABox.dist2_point(p), mRoot, nullptr});
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), near_greater);
+        NearItem item = heap.back();
+        heap.pop_back();
+        if (item.mDist > maxDist) {
+            break;
+        }
+        if (item.mObj != nullptr) {
+            if (!visitor(item.mObj, item.mDist)) {
+                break;
+            }
+            continue;
+        }
+        QuadNode* node = item.mNode;
+        if (!node->is_leaf()) {
+            for (auto c : node->mChildren) {
+                int64_t dist = c->mABox.dist2_point(p);
+                if (dist <= maxDist) {
+                    heap.push_back(NearItem{dist, c, nullptr});
+                    std::push_heap(heap.begin(), heap.end(), near_greater);
+                }
+            }
+            continue;
+        }
+        for (auto o : node->mObjs) {
+            // the point of o closest to p decides the owner leaf
+            IntPoint c{std::min(std::max(p.mX, o->mABox.mMin.mX), o->mABox.mMax.mX), std::min(std::max(p.mY, o->mABox.mMin.mY), o->mABox.mMax.mY)};
+            int64_t dist = o->mABox.dist2_point(p);
+            if (dist <= maxDist && is_owner(node, c)) {
+                heap.push_back(NearItem{dist, nullptr, o});
+                std::push_heap(heap.begin(), heap.end(), near_greater);
+            }
+        }
+    }
+    heap.clear();
+}
 }  // namespace PureCore
@@ -25,6 +25,7 @@
 #include "PureCore/PureCoreLib.h"
 #include "PureCore/IncrIDGen.h"
 #include "PureCore/TimerNode.h"
+#include "PureCore/TimerGroup.h"
 #include "PureCore/Memory/ObjectPool.h"
 
 #include <unordered_map>
@@ -42,21 +43,29 @@ public:
 
     void update(int64_t delta);
 
-    int64_t add_timer(int32_t timerType, int64_t startTime, int64_t interval, int64_t times, TimerCallback callback, bool nextFromNow = false);
+    // owner is not 0 means the timer is in the group of owner
+    int64_t add_timer(int32_t timerType, int64_t startTime, int64_t interval, int64_t times, TimerCallback callback, bool nextFromNow = false,
+                      int64_t owner = 0);
     bool remove_timer(int64_t timerID);
     void clear_timer();
 
+    // remove all timers of owner, return removed count
+    size_t remove_group(int64_t owner);
+    size_t get_group_count(int64_t owner) const;
+
 private:
     void add_timer_node(TimerNode* timer);
+    void remove_sort_node(TimerNode* timer);
 
 private:
     int64_t mNow;
 
     std::multimap<int64_t, TimerNode*> mSortTimers;
     std::unordered_map<int64_t, TimerNode*> mTimers;
+    TimerGroup mGroups;
 
     IncrIDGen mIDGen;
-    ObjectPool<TimerNode, 255> mPool;
+    ObjectPool<TimerNode, 64 * 1024, SlabAllocator> mPool{"RBTimerNode"};
 
     PURE_DISABLE_COPY(RBTimer)
 };
@@ -26,11 +26,15 @@
 #include "PureCore/Memory/ObjectPool.h"
 #include "PureCore/Geometry.h"
 
+#include <algorithm>
+#include <deque>
 #include <vector>
 #include <unordered_map>
 #include <functional>
+#include <utility>
 
 namespace PureCore {
+class StaticRectTree;
 class RectTree;
 class PURECORE_API RectNode {
 public:
@@ -38,15 +42,19 @@ public:
     RectNode(RectTree* tree);
     ~RectNode();
 
+    // box in tree, it is fattened for an object
     const IntABox& abox() const;
     int64_t obj_id() const;
+    const IntABox& obj_abox() const;
 
 private:
-    void set_obj(int64_t objID, const IntABox& box);
+    void set_obj(int64_t objID, const IntABox& box, const IntABox& fatBox);
     void check_objs(std::vector<RectNode*>& result, size_t limit, const std::function<bool(const IntABox& dst)>& check);
     RectNode* choose_subtree(const IntABox& box, int32_t depth, std::vector<RectNode*>& path);
     RectNode* get_child(size_t idx);
     void calc_abox();
+    // copy child boxes into mChildBoxes, called on every node a change passes through
+    void sync_boxes();
     IntABox dist_abox(size_t s, size_t e);
     void extend(const IntABox& box);
     void choose_split_axis(int64_t minElem);
@@ -57,10 +65,12 @@ private:
 private:
     RectTree* mTree;
     std::vector<RectNode*> mChildren;
+    IntABoxArray mChildBoxes;
     bool mLeaf = true;
     int32_t mDepth = 0;
     int64_t mObjID = 0;
     IntABox mABox{};
+    IntABox mObjBox{};
 };
 
 class PURECORE_API RectTree {
@@ -71,6 +81,10 @@ public:
 
     void clear();
 
+    // objects are stored with boxes grown by margin, an update inside the grown box does not change the tree
+    void set_fatten(int32_t margin);
+    int32_t get_fatten() const;
+
     const std::vector<RectNode*>& all_objs();
     const std::vector<RectNode*>& collide_abox(const IntABox& box);
     const std::vector<RectNode*>& collide_circle(const IntCircle& cir);
@@ -80,13 +94,66 @@ public:
     bool is_collide_circle(const IntCircle& cir);
     bool is_collide_sector(const IntSector& sec);
     bool is_collide_obox(const IntOBox& obox);
+    // append colliding objs to out and return the count appended, results survive later queries
+    size_t query_abox(const IntABox& box, std::vector<RectNode*>& out);
+    size_t query_circle(const IntCircle& cir, std::vector<RectNode*>& out);
+    size_t query_sector(const IntSector& sec, std::vector<RectNode*>& out);
+    size_t query_obox(const IntOBox& obox, std::vector<RectNode*>& out);
+    // append up to k objs nearest to p, nearest first, radius < 0 means no limit
+    size_t knn(const IntPoint& p, size_t k, std::vector<RectNode*>& out, int32_t radius = -1);
+    // nearest obj within radius, nullptr when none
+    RectNode* nearest(const IntPoint& p, int32_t radius = -1);
+    const std::vector<RectNode*>& collide_line(const IntLine& line);
+    bool is_collide_line(const IntLine& line);
+    size_t query_line(const IntLine& line, std::vector<RectNode*>& out);
+    // first obj hit walking from from to to, false when the segment hits nothing
+    bool first_hit_raycast(const IntPoint& from, const IntPoint& to, RayHit& hit);
+    // hits[i] is the first hit of rays[i] from mMin to mMax, mObjID is 0 for a miss. return the count of rays hitting
+    size_t first_hit_raycast_many(const IntLine* rays, size_t count, RayHit* hits);
+
+    // visitor(RectNode*) is called for each obj colliding box and passing check(const IntABox&),
+    // it returns false to stop. the tree must not be changed while visiting
+    template <typename Check, typename Visitor>
+    void visit(const IntABox& box, Check&& check, Visitor&& visitor);
+    template <typename Visitor>
+    void visit_abox(const IntABox& box, Visitor&& visitor);
+    template <typename Visitor>
+    void visit_circle(const IntCircle& cir, Visitor&& visitor);
+    template <typename Visitor>
+    void visit_sector(const IntSector& sec, Visitor&& visitor);
+    template <typename Visitor>
+    void visit_obox(const IntOBox& obox, Visitor&& visitor);
+    template <typename Visitor>
+    void visit_line(const IntLine& line, Visitor&& visitor);
+    // ordered along the segment, visitor(RectNode*, double t) gets each obj hit by line once, by the fraction t where
+    // line enters it, until it returns false
+    template <typename Visitor>
+    void visit_ray(const IntLine& line, Visitor&& visitor);
+    // best first, visitor(RectNode*, int64_t dist2) is called nearest first until it returns false
+    template <typename Visitor>
+    void visit_nearest(const IntPoint& p, int32_t radius, Visitor&& visitor);
+
     int insert(int64_t objID, const IntABox& box);
     int remove(int64_t objID);
+    // move obj in place, insert when not found
+    int update(int64_t objID, const IntABox& box);
+    // freeze the objs into out, whose const queries are safe from many threads while this tree keeps changing
+    int snapshot(StaticRectTree& out, uint32_t maxElem = 16) const;
 
 private:
-    const std::vector<RectNode*>& collide(const IntABox& box, size_t limit, const std::function<bool(const IntABox& dst)> check = nullptr);
+    struct NearItem {
+        int64_t mDist;
+        RectNode* mNode;
+        bool mIsObj;
+    };
+    static bool near_greater(const NearItem& a, const NearItem& b) { return a.mDist > b.mDist; }
+    struct RayItem {
+        double mT;
+        RectNode* mNode;
+        bool mIsObj;
+    };
+    static bool ray_greater(const RayItem& a, const RayItem& b) { return a.mT > b.mT; }
 
-private:
     std::vector<RectNode*>& use_cache();
     void unuse_cache();
 
@@ -94,6 +161,7 @@ private:
     void free_node(RectNode* node);
 
     void split(const std::vector<RectNode*>& insertPath, int32_t depth);
+    bool find_path(RectNode* item, std::vector<RectNode*>& path);
     int remove_node(RectNode* item);
     void merge_node(const std::vector<RectNode*>& path);
 
@@ -101,13 +169,150 @@ private:
     RectNode* mRoot = nullptr;
     uint32_t mMaxElem;
     uint32_t mMinElem;
+    int32_t mFatten = 0;
     std::unordered_map<int64_t, RectNode*> mObjs;
-    ObjectPool<RectNode, 128> mPool;
+    ObjectPool<RectNode, 64 * 1024, SlabAllocator> mPool{"RectNode"};
     std::vector<RectNode*> mResult;
-    std::vector<std::vector<RectNode*>> mCache;
+    // deque keeps references from use_cache valid while nested queries grow it
+    std::deque<std::vector<RectNode*>> mCache;
     size_t mCacheNext = 0;
     std::vector<int64_t> mCacheIndexes;
+    std::vector<NearItem> mNearHeap;
+    std::vector<RayItem> mRayHeap;
 
     PURE_DISABLE_COPY(RectTree)
 };
+
+template <typename Check, typename Visitor>
+void RectTree::visit(const IntABox& box, Check&& check, Visitor&& visitor) {
+    if (!box.intersect(mRoot->mABox)) {
+        return;
+    }
+    auto& searchCache = use_cache();
+    searchCache.push_back(mRoot);
+    while (!searchCache.empty()) {
+        RectNode* node = searchCache.back();
+        searchCache.pop_back();
+        auto& boxes = node->mChildBoxes;
+        for (size_t off = 0; off < boxes.size(); off += 64) {
+            size_t n = std::min<size_t>(boxes.size() - off, 64);
+            uint64_t bits = intersect_abox_bits(box, boxes.min_x() + off, boxes.min_y() + off, boxes.max_x() + off, boxes.max_y() + off, n);
+            for (size_t i = 0; bits != 0; ++i, bits >>= 1) {
+                if ((bits & 1) == 0) {
+                    continue;
+                }
+                RectNode* c = node->mChildren[off + i];
+                if (!node->mLeaf) {
+                    searchCache.push_back(c);
+                    continue;
+                }
+                if (!box.intersect(c->mObjBox) || !check(c->mObjBox)) {
+                    continue;
+                }
+                if (!visitor(c)) {
+                    unuse_cache();
+                    return;
+                }
+            }
+        }
+    }
+    unuse_cache();
+}
+
+template <typename Visitor>
+void RectTree::visit_abox(const IntABox& box, Visitor&& visitor) {
+    visit(box, [](const IntABox&) { return true; }, std::forward<Visitor>(visitor));
+}
+
+template <typename Visitor>
+void RectTree::visit_circle(const IntCircle& cir, Visitor&& visitor) {
+    visit(cir.get_bounding(), [&cir](const IntABox& dst) { return dst.intersect_circle(cir); }, std::forward<Visitor>(visitor));
+}
+
+template <typename Visitor>
+void RectTree::visit_sector(const IntSector& sec, Visitor&& visitor) {
+    visit(sec.get_bounding(), [&sec](const IntABox& dst) { return dst.intersect_sector(sec); }, std::forward<Visitor>(visitor));
+}
+
+template <typename Visitor>
+void RectTree::visit_obox(const IntOBox& obox, Visitor&& visitor) {
+    visit(obox.get_bounding(), [&obox](const IntABox& dst) { return dst.intersect_obox(obox); }, std::forward<Visitor>(visitor));
+}
+
+template <typename Visitor>
+void RectTree::visit_line(const IntLine& line, Visitor&& visitor) {
+    visit(line.get_bounding(), [&line](const IntABox& dst) {
+        double t = 0.0;
+        return dst.line_enter(line, t);
+    }, std::forward<Visitor>(visitor));
+}
+
+template <typename Visitor>
+void RectTree::visit_ray(const IntLine& line, Visitor&& visitor) {
+    double t = 0.0;
+    if (mRoot->mChildren.empty() || !mRoot->mABox.line_enter(line, t)) {
+        return;
+    }
+    // a local heap keeps nested queries in the visitor safe, the member one is reused when free
+    std::vector<RayItem> localHeap;
+    auto& heap = mRayHeap.empty() ? mRayHeap : localHeap;
+    heap.push_back(RayItem{t, mRoot, false});
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), ray_greater);
+        RayItem item = heap.back();
+        heap.pop_back();
+        if (item.mIsObj) {
+            if (!visitor(item.mNode, item.mT)) {
+                break;
+            }
+            continue;
+        }
+        RectNode* node = item.mNode;
+        for (auto c : node->mChildren) {
+            // tree boxes bound the object boxes below them
+            const IntABox& box = node->mLeaf ? c->mObjBox : c->mABox;
+            if (box.line_enter(line, t)) {
+                heap.push_back(RayItem{t, c, node->mLeaf});
+                std::push_heap(heap.begin(), heap.end(), ray_greater);
+            }
+        }
+    }
+    heap.clear();
+}
+
+template <typename Visitor>
+void RectTree::visit_nearest(const IntPoint& p, int32_t radius, Visitor&& visitor) {
+    if (mRoot->mChildren.empty()) {
+        return;
+    }
+    int64_t maxDist = radius < 0 ? INT64_MAX : int64_t(radius) * radius;
+    // a local heap keeps nested queries in the visitor safe, the member one is reused when free
+    std::vector<NearItem> localHeap;
+    auto& heap = mNearHeap.empty() ? mNearHeap : localHeap;
+    heap.push_back(NearItem{mRoot->mABox.dist2_point(p), mRoot, false});
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), near_greater);
+        NearItem item = heap.back();
+        heap.pop_back();
+        if (item.mDist > maxDist) {
+            break;
+        }
+        if (item.mIsObj) {
+            if (!visitor(item.mNode, item.mDist)) {
+                break;
+            }
+            continue;
+        }
+        RectNode* node = item.mNode;
+        for (auto c : node->mChildren) {
+            // tree boxes bound the object boxes below them
+            int64_t dist = node->mLeaf ? c->mObjBox.dist2_point(p) : c->mABox.dist2_point(p);
+            if (dist <= maxDist) {
+                heap.push_back(NearItem{dist, c, node->mLeaf});
+                std::push_heap(heap.begin(), heap.end(), near_greater);
+            }
+        }
+    }
+    heap.clear();
+}
 }  // namespace PureCore
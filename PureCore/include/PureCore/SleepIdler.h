@@ -25,6 +25,7 @@
 #include <stdint.h>
 
 namespace PureCore {
+class ChannelWaker;
 class PURECORE_API SleepIdler {
 public:
     SleepIdler();
@@ -35,6 +36,10 @@ public:
     bool set_offset(int64_t ms);
     int64_t get_offset() const;
 
+    // frame_end blocks on waker until notified or the suggest delta passed instead of sleep and yeild
+    void set_waker(ChannelWaker* waker);
+    ChannelWaker* get_waker() const;
+
     void frame_begin();
     int64_t frame_check(int64_t needDelta);
     void frame_end(int64_t suggestDelta = 10);
@@ -48,5 +53,6 @@ private:
     int64_t mStart = 0;
     int64_t mLastNow = 0;
     int64_t mOffset = 0;
+    ChannelWaker* mWaker = nullptr;
 };
 }  // namespace PureCore
@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "PureCore/PureCoreLib.h"
+#include "PureCore/Geometry.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace PureCore {
+// an object of StaticRectTree
+struct PURECORE_API StaticRectItem {
+    int64_t obj_id() const { return mObjID; }
+    const IntABox& abox() const { return mABox; }
+
+    int64_t mObjID = 0;
+    IntABox mABox{};
+};
+
+// node of StaticRectTree, mFirst is the first child node for inner nodes and the first item for leaves,
+// children are always stored before their parent
+struct PURECORE_API StaticRectNode {
+    IntABox mABox{};
+    uint32_t mFirst = 0;
+    uint32_t mCount = 0;
+};
+
+// read only rtree packed by sort tile recursive, nodes and items live in two flat arrays without pointers.
+// leaves come first and the root is the last node, the same layout is written by save and used in place by attach.
+// const queries keep their scratch in thread locals, so any number of threads may run them on one tree at once,
+// QuadTree::snapshot and RectTree::snapshot freeze a live tree into one for worker threads
+class PURECORE_API StaticRectTree {
+public:
+    StaticRectTree() = default;
+    ~StaticRectTree() = default;
+
+    void clear();
+    // items are reordered into leaf order, every node holds up to maxElem children
+    int build(std::vector<StaticRectItem> items, uint32_t maxElem = 16);
+    int save(const char* path) const;
+    int load(const char* path);
+    // use a saved image in place, e.g. a mmapped file, data must be 8 bytes aligned and outlive the tree
+    int attach(const void* data, size_t size);
+
+    size_t size() const;
+    const StaticRectItem* items() const;
+    size_t node_size() const;
+    const StaticRectNode* nodes() const;
+
+    // collide_* and all_objs return a member vector, they are for the owner thread only
+    const std::vector<const StaticRectItem*>& all_objs();
+    const std::vector<const StaticRectItem*>& collide_abox(const IntABox& box);
+    const std::vector<const StaticRectItem*>& collide_circle(const IntCircle& cir);
+    const std::vector<const StaticRectItem*>& collide_sector(const IntSector& sec);
+    const std::vector<const StaticRectItem*>& collide_obox(const IntOBox& obox);
+    bool is_collide_abox(const IntABox& box) const;
+    bool is_collide_circle(const IntCircle& cir) const;
+    bool is_collide_sector(const IntSector& sec) const;
+    bool is_collide_obox(const IntOBox& obox) const;
+    // append colliding objs to out and return the count appended, results survive later queries
+    size_t query_abox(const IntABox& box, std::vector<const StaticRectItem*>& out) const;
+    size_t query_circle(const IntCircle& cir, std::vector<const StaticRectItem*>& out) const;
+    size_t query_sector(const IntSector& sec, std::vector<const StaticRectItem*>& out) const;
+    size_t query_obox(const IntOBox& obox, std::vector<const StaticRectItem*>& out) const;
+    // append up to k objs nearest to p, nearest first, radius < 0 means no limit
+    size_t knn(const IntPoint& p, size_t k, std::vector<const StaticRectItem*>& out, int32_t radius = -1) const;
+    // nearest obj within radius, nullptr when none
+    const StaticRectItem* nearest(const IntPoint& p, int32_t radius = -1) const;
+    const std::vector<const StaticRectItem*>& collide_line(const IntLine& line);
+    bool is_collide_line(const IntLine& line) const;
+    size_t query_line(const IntLine& line, std::vector<const StaticRectItem*>& out) const;
+    // first obj hit walking from from to to, false when the segment hits nothing
+    bool first_hit_raycast(const IntPoint& from, const IntPoint& to, RayHit& hit) const;
+    // hits[i] is the first hit of rays[i] from mMin to mMax, mObjID is 0 for a miss. return the count of rays hitting
+    size_t first_hit_raycast_many(const IntLine* rays, size_t count, RayHit* hits) const;
+
+    // visitor(const StaticRectItem*) is called for each obj colliding box and passing check(const IntABox&),
+    // it returns false to stop
+    template <typename Check, typename Visitor>
+    void visit(const IntABox& box, Check&& check, Visitor&& visitor) const;
+    template <typename Visitor>
+    void visit_abox(const IntABox& box, Visitor&& visitor) const;
+    template <typename Visitor>
+    void visit_circle(const IntCircle& cir, Visitor&& visitor) const;
+    template <typename Visitor>
+    void visit_sector(const IntSector& sec, Visitor&& visitor) const;
+    template <typename Visitor>
+    void visit_obox(const IntOBox& obox, Visitor&& visitor) const;
+    template <typename Visitor>
+    void visit_line(const IntLine& line, Visitor&& visitor) const;
+    // ordered along the segment, visitor(const StaticRectItem*, double t) gets each obj hit by line once, by the fraction t where
+    // line enters it, until it returns false
+    template <typename Visitor>
+    void visit_ray(const IntLine& line, Visitor&& visitor) const;
+    // best first, visitor(const StaticRectItem*, int64_t dist2) is called nearest first until it returns false
+    template <typename Visitor>
+    void visit_nearest(const IntPoint& p, int32_t radius, Visitor&& visitor) const;
+
+private:
+    struct NearItem {
+        int64_t mDist;
+        uint32_t mIdx;
+        bool mIsObj;
+    };
+    static bool near_greater(const NearItem& a, const NearItem& b) { return a.mDist > b.mDist; }
+    struct RayItem {
+        double mT;
+        uint32_t mIdx;
+        bool mIsObj;
+    };
+    static bool ray_greater(const RayItem& a, const RayItem& b) { return a.mT > b.mT; }
+
+    int check_layout() const;
+    // scratch of the calling thread, nested queries push and pop above the size they found
+    static std::vector<uint32_t>& thread_stack();
+    static std::vector<NearItem>& thread_heap();
+    static std::vector<RayItem>& thread_ray_heap();
+
+private:
+    const StaticRectNode* mNodes = nullptr;
+    size_t mNodeCount = 0;
+    size_t mLeafCount = 0;
+    const StaticRectItem* mItems = nullptr;
+    size_t mItemCount = 0;
+    // storage of built or loaded trees, attached trees leave them empty
+    std::vector<StaticRectNode> mOwnNodes;
+    std::vector<StaticRectItem> mOwnItems;
+    std::vector<const StaticRectItem*> mResult;
+
+    PURE_DISABLE_COPY(StaticRectTree)
+};
+
+template <typename Check, typename Visitor>
+void StaticRectTree::visit(const IntABox& box, Check&& check, Visitor&& visitor) const {
+    if (mNodeCount == 0 || !box.intersect(mNodes[mNodeCount - 1].mABox)) {
+        return;
+    }
+    auto& stack = thread_stack();
+    size_t base = stack.size();
+    stack.push_back(uint32_t(mNodeCount - 1));
+    while (stack.size() > base) {
+        const StaticRectNode& node = mNodes[stack.back()];
+        bool leaf = stack.back() < mLeafCount;
+        stack.pop_back();
+        if (!leaf) {
+            for (uint32_t i = node.mFirst; i < node.mFirst + node.mCount; ++i) {
+                if (box.intersect(mNodes[i].mABox)) {
+                    stack.push_back(i);
+                }
+            }
+            continue;
+        }
+        for (uint32_t i = node.mFirst; i < node.mFirst + node.mCount; ++i) {
+            const StaticRectItem* item = mItems + i;
+            if (!box.intersect(item->mABox) || !check(item->mABox)) {
+                continue;
+            }
+            if (!visitor(item)) {
+                stack.resize(base);
+                return;
+            }
+        }
+    }
+}
+
+template <typename Visitor>
+void StaticRectTree::visit_abox(const IntABox& box, Visitor&& visitor) const {
+    visit(box, [](const IntABox&) { return true; }, std::forward<Visitor>(visitor));
+}
+
+template <typename Visitor>
+void StaticRectTree::visit_circle(const IntCircle& cir, Visitor&& visitor) const {
+    visit(cir.get_bounding(), [&cir](const IntABox& dst) { return dst.intersect_circle(cir); }, std::forward<Visitor>(visitor));
+}
+
+template <typename Visitor>
+void StaticRectTree::visit_sector(const IntSector& sec, Visitor&& visitor) const {
+    visit(sec.get_bounding(), [&sec](const IntABox& dst) { return dst.intersect_sector(sec); }, std::forward<Visitor>(visitor));
+}
+
+template <typename Visitor>
+void StaticRectTree::visit_obox(const IntOBox& obox, Visitor&& visitor) const {
+    visit(obox.get_bounding(), [&obox](const IntABox& dst) { return dst.intersect_obox(obox); }, std::forward<Visitor>(visitor));
+}
+
+template <typename Visitor>
+void StaticRectTree::visit_line(const IntLine& line, Visitor&& visitor) const {
+    visit(line.get_bounding(), [&line](const IntABox& dst) {
+        double t = 0.0;
+        return dst.line_enter(line, t);
+    }, std::forward<Visitor>(visitor));
+}
+
+template <typename Visitor>
+void StaticRectTree::visit_ray(const IntLine& line, Visitor&& visitor) const {
+    double t = 0.0;
+    if (mNodeCount == 0 || !mNodes[mNodeCount - 1].mABox.line_enter(line, t)) {
+        return;
+    }
+    auto& heap = thread_ray_heap();
+    size_t base = heap.size();
+    heap.push_back(RayItem{t, uint32_t(mNodeCount - 1), false});
+    while (heap.size() > base) {
+        std::pop_heap(heap.begin() + base, heap.end(), ray_greater);
+        RayItem item = heap.back();
+        heap.pop_back();
+        if (item.mIsObj) {
+            if (!visitor(mItems + item.mIdx, item.mT)) {
+                break;
+            }
+            continue;
+        }
+        const StaticRectNode& node = mNodes[item.mIdx];
+        bool leaf = item.mIdx < mLeafCount;
+        for (uint32_t i = node.mFirst; i < node.mFirst + node.mCount; ++i) {
+            const IntABox& box = leaf ? mItems[i].mABox : mNodes[i].mABox;
+            if (box.line_enter(line, t)) {
+                heap.push_back(RayItem{t, i, leaf});
+                std::push_heap(heap.begin() + base, heap.end(), ray_greater);
+            }
+        }
+    }
+    heap.resize(base);
+}
+
+template <typename Visitor>
+void StaticRectTree::visit_nearest(const IntPoint& p, int32_t radius, Visitor&& visitor) const {
+    if (mNodeCount == 0) {
+        return;
+    }
+    int64_t maxDist = radius < 0 ? INT64_MAX : int64_t(radius) * radius;
+    auto& heap = thread_heap();
+    size_t base = heap.size();
+    heap.push_back(NearItem{mNodes[mNodeCount - 1].mABox.dist2_point(p), uint32_t(mNodeCount - 1), false});
+    while (heap.size() > base) {
+        std::pop_heap(heap.begin() + base, heap.end(), near_greater);
+        NearItem item = heap.back();
+        heap.pop_back();
+        if (item.mDist > maxDist) {
+            break;
+        }
+        if (item.mIsObj) {
+            if (!visitor(mItems + item.mIdx, item.mDist)) {
+                break;
+            }
+            continue;
+        }
+        const StaticRectNode& node = mNodes[item.mIdx];
+        bool leaf = item.mIdx < mLeafCount;
+        for (uint32_t i = node.mFirst; i < node.mFirst + node.mCount; ++i) {
+            int64_t dist = leaf ? mItems[i].mABox.dist2_point(p) : mNodes[i].mABox.dist2_point(p);
+            if (dist <= maxDist) {
+                heap.push_back(NearItem{dist, i, leaf});
+                std::push_heap(heap.begin() + base, heap.end(), near_greater);
+            }
+        }
+    }
+    heap.resize(base);
+}
+
+}  // namespace PureCore
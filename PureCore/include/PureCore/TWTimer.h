@@ -25,11 +25,14 @@
 #include "PureCore/PureCoreLib.h"
 #include "PureCore/IncrIDGen.h"
 #include "PureCore/TimerNode.h"
+#include "PureCore/TimerGroup.h"
 #include "PureCore/NodeList.h"
 #include "PureCore/Memory/ObjectPool.h"
 
+#include <map>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 namespace PureCore {
 class TWTimerNode : public TimerNode, public Node {
@@ -76,6 +79,9 @@ private:
     PURE_DISABLE_COPY(TimerWheel)
 };
 
+// batch callback receives all due slack timers of timerType in one slack window
+typedef InlineFunction<void(int32_t timerType, const std::vector<int64_t>& timerIDs), 40> TimerBatchCallback;
+
 class PURECORE_API TWTimer {
 public:
     TWTimer();
@@ -86,14 +92,28 @@ public:
 
     void update(int64_t delta);
 
-    int64_t add_timer(int32_t timerType, int64_t startTime, int64_t interval, int64_t times, TimerCallback callback, bool nextFromNow = false);
+    // owner is not 0 means the timer is in the group of owner
+    int64_t add_timer(int32_t timerType, int64_t startTime, int64_t interval, int64_t times, TimerCallback callback, bool nextFromNow = false,
+                      int64_t owner = 0);
     bool remove_timer(int64_t timerID);
     void clear_timer();
 
+    // slack timer deadline is rounded up to a multiple of slack, it is kept out of the wheels
+    // and due timers of the same timerType and deadline fire together by the batch callback of timerType
+    int64_t add_slack_timer(int32_t timerType, int64_t startTime, int64_t interval, int64_t times, int64_t slack, bool nextFromNow = false,
+                            int64_t owner = 0);
+    void set_batch_callback(int32_t timerType, TimerBatchCallback callback);
+
+    // remove all timers of owner, return removed count
+    size_t remove_group(int64_t owner);
+    size_t get_group_count(int64_t owner) const;
+
 private:
     void try_trigger_timer(NodeList* timerStep);
     void try_turn_wheel(int64_t now);
+    void try_trigger_batch();
     void add_timer_node(TWTimerNode* timer);
+    void add_batch_node(TWTimerNode* timer);
 
 private:
     int64_t mNow;
@@ -101,10 +121,15 @@ private:
     TimerWheel mWheels[4];
     NodeList mOverflowWheel;
 
+    std::map<std::pair<int64_t, int32_t>, NodeList> mBatches;  // slack timers by deadline and timer type
+    std::unordered_map<int32_t, TimerBatchCallback> mBatchCallbacks;
+    std::vector<int64_t> mBatchIDs;
+
     std::unordered_map<int64_t, TWTimerNode*> mTimers;
+    TimerGroup mGroups;
 
     IncrIDGen mIDGen;
-    ObjectPool<TWTimerNode, 255> mPool;
+    ObjectPool<TWTimerNode, 64 * 1024, SlabAllocator> mPool;
 
     PURE_DISABLE_COPY(TWTimer)
 };
@@ -24,18 +24,50 @@
 
 #include "PureCore/PureCoreLib.h"
 #include "PureCore/Thread.h"
-#include "PureCore/NodeList.h"
+#include "PureCore/InlineFunction.h"
+#include "PureCore/Memory/ObjectRecycler.h"
 
-#include <functional>
+#include <atomic>
+#include <vector>
 #include <mutex>
 #include <condition_variable>
 
 namespace PureCore {
 class Task;
+class TaskNode;
+
+// task function is stored inline in TaskNode, captures must fit in 48 bytes
+typedef InlineFunction<void(), 48> TaskFunc;
+
+// Chase-Lev deque, owner push and pop at bottom, other threads steal at top
+class TaskDeque {
+public:
+    enum ETaskDequeConst {
+        Capacity = 4096,
+        Mask = Capacity - 1,
+    };
+
+    TaskDeque() = default;
+    ~TaskDeque() = default;
+
+    // return false when full
+    bool push(TaskNode* node);
+    TaskNode* pop();
+    TaskNode* steal();
+    bool empty() const;
+
+private:
+    alignas(64) std::atomic<int64_t> mTop{};
+    alignas(64) std::atomic<int64_t> mBottom{};
+    std::atomic<TaskNode*> mBuffer[Capacity]{};
+
+    PURE_DISABLE_COPY(TaskDeque)
+};
+
 class TaskThread : public Thread {
 private:
     friend class Task;
-    TaskThread(Task& task);
+    TaskThread(Task& task, uint32_t index);
     virtual ~TaskThread() = default;
 
 protected:
@@ -43,22 +75,37 @@ protected:
 
 private:
     Task& mTask;
+    uint32_t mIndex;  // index in task threads
+    uint32_t mSeed;   // random seed of steal victim
+    TaskDeque mDeque;
 
     PURE_DISABLE_COPY(TaskThread)
 };
 
-class TaskNode : public Node {
+// recycled to the thread created it by ObjectRecycler
+class TaskNode : public RecycleObject {
+public:
+    TaskNode() = default;
+    ~TaskNode() = default;
+
+    void clear();
+
 private:
     friend class Task;
-    TaskNode(std::function<void()> func);
-    virtual ~TaskNode() = default;
+    static TaskNode* create(TaskFunc&& func, TaskFunc&& done);
+    static void destroy(TaskNode* node);
 
 private:
-    std::function<void()> mFunc;
+    TaskFunc mFunc;                        // run in task thread
+    TaskFunc mDone;                        // run in the thread calling Task::update after mFunc
+    TaskNode* mNext = nullptr;             // next node in lock free list
+    std::atomic<size_t>* mJoin = nullptr;  // count of TaskJoin, decrease after mFunc
 
     PURE_DISABLE_COPY(TaskNode)
 };
 
+// work stealing thread pool, every thread owns a deque, tasks added by other threads go to a lock free inject list,
+// idle threads steal from the others
 class PURECORE_API Task {
 public:
     Task(uint32_t size);
@@ -66,19 +113,69 @@ public:
 
     int run();
     void stop(int64_t timeout);
-    int add_task(std::function<void()> func);
+    int add_task(TaskFunc func);
+    // done is called by update in the logic thread after func finished
+    int add_task(TaskFunc func, TaskFunc done);
+    // post func to run by update in the logic thread
+    int post_update(TaskFunc func);
+
+    // run done functions in the calling thread, return run count
+    size_t update();
+    // run one queued task in the calling thread, return false when no task
+    bool run_one();
+
+    uint32_t get_size() const;
+    // the calling thread is a thread of this task
+    bool is_task_thread() const;
 
 private:
     friend void TaskThread::work();
-    void work();
+    friend class TaskJoin;
+    void work(TaskThread& thread);
+
+    int add_join_task(TaskFunc&& func, std::atomic<size_t>* join);
+    int add_node(TaskNode* node);
+    TaskNode* get_node(TaskThread& thread);
+    TaskNode* get_inject_node(TaskThread& thread);
+    TaskNode* get_outside_node();
+    TaskNode* steal_node(TaskThread* thread, uint32_t& seed);
+    void run_node(TaskNode* node);
+    bool has_node() const;
+    void notify();
+    void clear_nodes();
+    void drop_node(TaskNode* node);
+
+    static void push_list(std::atomic<TaskNode*>& list, TaskNode* head, TaskNode* tail);
 
 private:
+    uint32_t mSize;
     std::vector<TaskThread*> mThreades;
     std::mutex mMutex;
     std::condition_variable mCondition;
-    NodeList mNodes;
+    std::atomic<TaskNode*> mInject{};  // tasks added by other threads, newest first
+    std::atomic<TaskNode*> mDone{};    // done functions for update, newest first
+    std::atomic<uint32_t> mSleeping{};
     std::atomic<bool> mRunning{};
-    std::atomic<uint32_t> mRunningTask{};
+
+    PURE_DISABLE_COPY(Task)
+};
+
+// join handle of a task set, the waiting thread runs queued tasks until the tasks added by the join finished
+class PURECORE_API TaskJoin {
+public:
+    explicit TaskJoin(Task& task);
+    ~TaskJoin();
+
+    // func runs in place when the task is not running
+    int add_task(TaskFunc func);
+    void wait();
+    bool is_done() const;
+
+private:
+    Task& mTask;
+    std::atomic<size_t> mCount{};
+
+    PURE_DISABLE_COPY(TaskJoin)
 };
 
 }  // namespace PureCore
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "PureCore/PureCoreLib.h"
+#include "PureCore/Task.h"
+
+#include <atomic>
+#include <vector>
+#include <utility>
+
+namespace PureCore {
+// hand out chunks of [begin, end), chunk size shrinks with the left range and never below grain
+class TaskRange {
+public:
+    TaskRange(size_t begin, size_t end, size_t grain, size_t workers)
+        : mCursor(begin), mEnd(end), mGrain(grain > 0 ? grain : 1), mWorkers(workers > 0 ? workers : 1) {}
+    ~TaskRange() = default;
+
+    bool next(size_t& first, size_t& last) {
+        size_t cursor = mCursor.load(std::memory_order_relaxed);
+        while (cursor < mEnd) {
+            size_t left = mEnd - cursor;
+            size_t size = left / (mWorkers * 2);
+            if (size < mGrain) {
+                size = mGrain;
+            }
+            if (size > left) {
+                size = left;
+            }
+            if (mCursor.compare_exchange_weak(cursor, cursor + size, std::memory_order_relaxed)) {
+                first = cursor;
+                last = cursor + size;
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    std::atomic<size_t> mCursor;
+    size_t mEnd;
+    size_t mGrain;
+    size_t mWorkers;
+
+    PURE_DISABLE_COPY(TaskRange)
+};
+
+// run func(first, last) over chunks of [begin, end) in task threads and the calling thread, return after all chunks finished
+template <typename Func>
+void parallel_for(Task& task, size_t begin, size_t end, size_t grain, Func&& func) {
+    if (begin >= end) {
+        return;
+    }
+    grain = grain > 0 ? grain : 1;
+    size_t workers = size_t(task.get_size()) + 1;
+    TaskRange range(begin, end, grain, workers);
+    auto body = [&range, &func]() {
+        size_t first = 0;
+        size_t last = 0;
+        while (range.next(first, last)) {
+            func(first, last);
+        }
+    };
+
+    size_t chunks = (end - begin + grain - 1) / grain;
+    TaskJoin join(task);
+    for (size_t i = 1; i < workers && i < chunks; ++i) {
+        join.add_task([&body]() { body(); });
+    }
+    body();
+    join.wait();
+}
+
+// value of one worker in parallel_reduce, a cache line each to avoid false sharing, also works for bool unlike vector<bool>
+template <typename T>
+struct alignas(64) TaskReduceSlot {
+    T mValue;
+};
+
+// func(first, last, value) accumulates chunk [first, last) into value, every worker starts from identity,
+// the values of the workers are combined by reduce(a, b)
+template <typename T, typename Func, typename Reduce>
+T parallel_reduce(Task& task, size_t begin, size_t end, size_t grain, const T& identity, Func&& func, Reduce&& reduce) {
+    if (begin >= end) {
+        return identity;
+    }
+    grain = grain > 0 ? grain : 1;
+    size_t workers = size_t(task.get_size()) + 1;
+    size_t chunks = (end - begin + grain - 1) / grain;
+    size_t count = workers < chunks ? workers : chunks;
+    std::vector<TaskReduceSlot<T>> values(count, TaskReduceSlot<T>{identity});
+    TaskRange range(begin, end, grain, workers);
+    auto body = [&range, &func](T& value) {
+        size_t first = 0;
+        size_t last = 0;
+        while (range.next(first, last)) {
+            func(first, last, value);
+        }
+    };
+
+    TaskJoin join(task);
+    for (size_t i = 1; i < count; ++i) {
+        join.add_task([&body, &values, i]() { body(values[i].mValue); });
+    }
+    body(values[0].mValue);
+    join.wait();
+
+    T result = std::move(values[0].mValue);
+    for (size_t i = 1; i < count; ++i) {
+        result = reduce(result, values[i].mValue);
+    }
+    return result;
+}
+
+}  // namespace PureCore
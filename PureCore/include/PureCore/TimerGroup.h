@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "PureCore/PureCoreLib.h"
+#include "PureCore/TimerNode.h"
+
+#include <unordered_map>
+
+namespace PureCore {
+// timers of the same owner are linked by an intrusive list in TimerNode
+class PURECORE_API TimerGroup {
+public:
+    TimerGroup() = default;
+    ~TimerGroup() = default;
+
+    void add(TimerNode* timer, int64_t owner);
+    void remove(TimerNode* timer);
+    void clear();
+
+    TimerNode* get_front(int64_t owner) const;
+    size_t get_count(int64_t owner) const;
+
+private:
+    struct Group {
+        TimerNode* mHead = nullptr;  // first timer
+        size_t mCount = 0;           // timer count
+    };
+    std::unordered_map<int64_t, Group> mGroups;
+
+    PURE_DISABLE_COPY(TimerGroup)
+};
+
+}  // namespace PureCore
@@ -23,19 +23,22 @@
 #pragma once
 
 #include "PureCore/PureCoreLib.h"
-
-#include <functional>
+#include "PureCore/InlineFunction.h"
 
 namespace PureCore {
 
-typedef std::function<bool(int64_t timerID, int32_t timerType, int64_t leftTimes)> TimerCallback;
+// timer callback is stored inline in TimerNode, captures must fit in 40 bytes
+// use TimerCallback(func, ctx) for a raw function with context
+typedef InlineFunction<bool(int64_t timerID, int32_t timerType, int64_t leftTimes), 40> TimerCallback;
 
 class PURECORE_API TimerNode {
 public:
     TimerNode();
     virtual ~TimerNode();
 
-    int init(int64_t timerID, int32_t timerType, int64_t startTime, int64_t interval, int64_t times, TimerCallback callback, bool nextFromNow);
+    // slack is not 0 means the deadline is rounded up to a multiple of slack, callback can be empty for batch timer
+    int init(int64_t timerID, int32_t timerType, int64_t startTime, int64_t interval, int64_t times, TimerCallback&& callback, bool nextFromNow,
+             int64_t slack = 0);
     void release();
 
     void time_out();
@@ -44,13 +47,17 @@ public:
     int32_t get_timer_type() const;
     int64_t get_next_time() const;
     int64_t get_left_times() const;
-    TimerCallback get_callback() const;
+    int64_t get_slack() const;
+    const TimerCallback& get_callback() const;
+    int64_t get_owner() const;
+    TimerNode* get_group_next() const;
 
     bool remove_if_calling();
 
     void next_time(int64_t now);
 
 private:
+    friend class TimerGroup;
     int64_t mTimerID;
     int32_t mTimerType;
     TimerCallback mCallback;
@@ -60,6 +67,11 @@ private:
     int64_t mLeftTimes;
     bool mCalling;
     bool mNextFromNow;
+    int64_t mSlack;
+
+    int64_t mOwner;         // owner of timer group, 0 is no group
+    TimerNode* mGroupPre;   // pre timer of same owner
+    TimerNode* mGroupNext;  // next timer of same owner
 
     PURE_DISABLE_COPY(TimerNode)
 };
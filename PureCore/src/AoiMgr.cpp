@@ -0,0 +1,375 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "PureCore/AoiMgr.h"
+#include "PureCore/CoreErrorDesc.h"
+
+#include <algorithm>
+
+namespace PureCore {
+static inline int64_t aoi_dist2(const AoiEntity* a, const AoiEntity* b) {
+    int64_t dx = int64_t(a->pos().mX) - b->pos().mX;
+    int64_t dy = int64_t(a->pos().mY) - b->pos().mY;
+    return dx * dx + dy * dy;
+}
+
+static inline bool aoi_sees(const AoiEntity* watcher, const AoiEntity* target) {
+    return aoi_dist2(watcher, target) <= int64_t(watcher->radius()) * watcher->radius();
+}
+
+static inline bool aoi_less(const AoiEntity* a, const AoiEntity* b) { return a->obj_id() < b->obj_id(); }
+
+static void aoi_erase_sorted(std::vector<AoiEntity*>& vec, AoiEntity* e) {
+    auto iter = std::lower_bound(vec.begin(), vec.end(), e, aoi_less);
+    if (iter != vec.end() && *iter == e) {
+        vec.erase(iter);
+    }
+}
+
+static void aoi_erase_unsorted(std::vector<AoiEntity*>& vec, AoiEntity* e) {
+    for (size_t i = 0; i < vec.size(); ++i) {
+        if (vec[i] == e) {
+            vec[i] = vec.back();
+            vec.pop_back();
+            return;
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////
+// AoiEntity
+//////////////////////////////////////////////////////////////////////////
+int64_t AoiEntity::obj_id() const { return mObjID; }
+
+const IntPoint& AoiEntity::pos() const { return mPos; }
+
+int32_t AoiEntity::radius() const { return mRadius; }
+
+const std::vector<AoiEntity*>& AoiEntity::seen() const { return mSeen; }
+
+const std::vector<AoiEntity*>& AoiEntity::watchers() const { return mWatchers; }
+
+///////////////////////////////////////////////////////////////////////////
+// AoiMgr
+//////////////////////////////////////////////////////////////////////////
+AoiMgr::~AoiMgr() { clear(); }
+
+int AoiMgr::init(const IntABox& box, int32_t cellSize) {
+    if (cellSize <= 0 || box.mMax.mX < box.mMin.mX || box.mMax.mY < box.mMin.mY) {
+        return ErrorInvalidArg;
+    }
+    clear();
+    mABox = box;
+    mCellSize = cellSize;
+    mCols = int32_t((int64_t(box.mMax.mX) - box.mMin.mX) / cellSize + 1);
+    mRows = int32_t((int64_t(box.mMax.mY) - box.mMin.mY) / cellSize + 1);
+    mCells.clear();
+    mCells.resize(size_t(mCols) * mRows);
+    return Success;
+}
+
+void AoiMgr::clear() {
+    for (auto& iter : mObjs) {
+        mPool.free(iter.second);
+    }
+    mObjs.clear();
+    for (auto& cell : mCells) {
+        cell.clear();
+    }
+    mMaxRadius = 0;
+    mRemovedCount = 0;
+    mDirty.clear();
+    mNewSeen.clear();
+    mEnters.clear();
+    mLeaves.clear();
+    mMoves.clear();
+}
+
+int AoiMgr::add(int64_t objID, const IntPoint& pos, int32_t radius) {
+    if (objID <= 0 || mCells.empty()) {
+        return ErrorInvalidArg;
+    }
+    radius = std::max(int32_t(0), radius);
+    auto iter = mObjs.find(objID);
+    if (iter != mObjs.end() && !iter->second->mRemoved) {
+        set_radius(objID, radius);
+        return move(objID, pos);
+    }
+    AoiEntity* e = nullptr;
+    if (iter != mObjs.end()) {
+        // removed and added again in one tick, keep the links so the update sees a move
+        e = iter->second;
+        e->mRemoved = false;
+        --mRemovedCount;
+    } else {
+        e = mPool.get();
+        e->mObjID = objID;
+        e->mAdded = true;
+        mObjs.insert(std::make_pair(objID, e));
+    }
+    e->mPos = clamp_pos(pos);
+    e->mRadius = radius;
+    e->mMoved = true;
+    mMaxRadius = std::max(mMaxRadius, radius);
+    add_to_cell(e);
+    mark_dirty(e);
+    return Success;
+}
+
+int AoiMgr::remove(int64_t objID) {
+    auto e = find(objID);
+    if (e == nullptr) {
+        return ErrorAoiObjNotFound;
+    }
+    remove_from_cell(e);
+    e->mRemoved = true;
+    ++mRemovedCount;
+    mark_dirty(e);
+    return Success;
+}
+
+int AoiMgr::move(int64_t objID, const IntPoint& pos) {
+    auto e = find(objID);
+    if (e == nullptr) {
+        return ErrorAoiObjNotFound;
+    }
+    auto newPos = clamp_pos(pos);
+    if (newPos.mX == e->mPos.mX && newPos.mY == e->mPos.mY) {
+        return Success;
+    }
+    e->mPos = newPos;
+    if (cell_index(newPos) != e->mCell) {
+        remove_from_cell(e);
+        add_to_cell(e);
+    }
+    e->mMoved = true;
+    mark_dirty(e);
+    return Success;
+}
+
+int AoiMgr::set_radius(int64_t objID, int32_t radius) {
+    auto e = find(objID);
+    if (e == nullptr) {
+        return ErrorAoiObjNotFound;
+    }
+    radius = std::max(int32_t(0), radius);
+    if (radius == e->mRadius) {
+        return Success;
+    }
+    e->mRadius = radius;
+    mMaxRadius = std::max(mMaxRadius, radius);
+    mark_dirty(e);
+    return Success;
+}
+
+AoiEntity* AoiMgr::find(int64_t objID) const {
+    auto iter = mObjs.find(objID);
+    if (iter == mObjs.end() || iter->second->mRemoved) {
+        return nullptr;
+    }
+    return iter->second;
+}
+
+size_t AoiMgr::get_watcher_ids(int64_t objID, std::vector<int64_t>& out) const {
+    auto e = find(objID);
+    if (e == nullptr) {
+        return 0;
+    }
+    for (auto w : e->mWatchers) {
+        out.push_back(w->mObjID);
+    }
+    return e->mWatchers.size();
+}
+
+size_t AoiMgr::size() const { return mObjs.size() - mRemovedCount; }
+
+void AoiMgr::update() {
+    mEnters.clear();
+    mLeaves.clear();
+    mMoves.clear();
+    for (auto e : mDirty) {
+        if (e->mRemoved) {
+            unlink(e);
+        }
+    }
+    // dirty watchers rebuild their whole view, so pairs of two dirty entities are settled here
+    for (auto e : mDirty) {
+        if (!e->mRemoved) {
+            update_watcher(e);
+        }
+    }
+    // clean watchers only need a look at the targets that moved
+    for (auto e : mDirty) {
+        if (!e->mRemoved && e->mMoved) {
+            update_target(e);
+        }
+    }
+    for (auto e : mDirty) {
+        if (e->mRemoved) {
+            mObjs.erase(e->mObjID);
+            mPool.free(e);
+            continue;
+        }
+        if (e->mMoved && !e->mAdded && !e->mWatchers.empty()) {
+            mMoves.push_back(e);
+        }
+        e->mDirty = false;
+        e->mAdded = false;
+        e->mMoved = false;
+    }
+    mDirty.clear();
+    mRemovedCount = 0;
+}
+
+const std::vector<AoiPair>& AoiMgr::enters() const { return mEnters; }
+
+const std::vector<AoiPair>& AoiMgr::leaves() const { return mLeaves; }
+
+const std::vector<AoiEntity*>& AoiMgr::moves() const { return mMoves; }
+
+template <typename Func>
+void AoiMgr::scan_cells(const IntPoint& pos, int32_t radius, Func&& func) {
+    int64_t minX = std::max(int64_t(0), (int64_t(pos.mX) - radius - mABox.mMin.mX) / mCellSize);
+    int64_t maxX = std::min(int64_t(mCols) - 1, (int64_t(pos.mX) + radius - mABox.mMin.mX) / mCellSize);
+    int64_t minY = std::max(int64_t(0), (int64_t(pos.mY) - radius - mABox.mMin.mY) / mCellSize);
+    int64_t maxY = std::min(int64_t(mRows) - 1, (int64_t(pos.mY) + radius - mABox.mMin.mY) / mCellSize);
+    for (int64_t y = minY; y <= maxY; ++y) {
+        for (int64_t x = minX; x <= maxX; ++x) {
+            for (auto e : mCells[size_t(y * mCols + x)]) {
+                func(e);
+            }
+        }
+    }
+}
+
+int32_t AoiMgr::cell_index(const IntPoint& pos) const {
+    int32_t x = int32_t((int64_t(pos.mX) - mABox.mMin.mX) / mCellSize);
+    int32_t y = int32_t((int64_t(pos.mY) - mABox.mMin.mY) / mCellSize);
+    return y * mCols + x;
+}
+
+IntPoint AoiMgr::clamp_pos(const IntPoint& pos) const {
+    return IntPoint{std::min(std::max(pos.mX, mABox.mMin.mX), mABox.mMax.mX), std::min(std::max(pos.mY, mABox.mMin.mY), mABox.mMax.mY)};
+}
+
+void AoiMgr::add_to_cell(AoiEntity* e) {
+    e->mCell = cell_index(e->mPos);
+    auto& cell = mCells[e->mCell];
+    e->mCellPos = uint32_t(cell.size());
+    cell.push_back(e);
+}
+
+void AoiMgr::remove_from_cell(AoiEntity* e) {
+    if (e->mCell < 0) {
+        return;
+    }
+    auto& cell = mCells[e->mCell];
+    auto last = cell.back();
+    cell[e->mCellPos] = last;
+    last->mCellPos = e->mCellPos;
+    cell.pop_back();
+    e->mCell = -1;
+}
+
+void AoiMgr::mark_dirty(AoiEntity* e) {
+    if (!e->mDirty) {
+        e->mDirty = true;
+        mDirty.push_back(e);
+    }
+}
+
+void AoiMgr::update_watcher(AoiEntity* e) {
+    auto& newSeen = mNewSeen;
+    newSeen.clear();
+    if (e->mRadius > 0) {
+        scan_cells(e->mPos, e->mRadius, [e, &newSeen](AoiEntity* t) {
+            if (t != e && aoi_sees(e, t)) {
+                newSeen.push_back(t);
+            }
+        });
+        std::sort(newSeen.begin(), newSeen.end(), aoi_less);
+    }
+    // both sorted by id, walk them together
+    auto& oldSeen = e->mSeen;
+    size_t i = 0;
+    size_t j = 0;
+    while (i < oldSeen.size() || j < newSeen.size()) {
+        if (j == newSeen.size() || (i < oldSeen.size() && aoi_less(oldSeen[i], newSeen[j]))) {
+            aoi_erase_unsorted(oldSeen[i]->mWatchers, e);
+            mLeaves.push_back(AoiPair{e->mObjID, oldSeen[i]->mObjID});
+            ++i;
+        } else if (i == oldSeen.size() || aoi_less(newSeen[j], oldSeen[i])) {
+            newSeen[j]->mWatchers.push_back(e);
+            mEnters.push_back(AoiPair{e->mObjID, newSeen[j]->mObjID});
+            ++j;
+        } else {
+            ++i;
+            ++j;
+        }
+    }
+    oldSeen.swap(newSeen);
+}
+
+void AoiMgr::update_target(AoiEntity* e) {
+    if (mMaxRadius > 0) {
+        scan_cells(e->mPos, mMaxRadius, [this, e](AoiEntity* w) {
+            if (w == e || w->mDirty || w->mRadius <= 0 || !aoi_sees(w, e)) {
+                return;
+            }
+            auto iter = std::lower_bound(w->mSeen.begin(), w->mSeen.end(), e, aoi_less);
+            if (iter != w->mSeen.end() && *iter == e) {
+                return;
+            }
+            w->mSeen.insert(iter, e);
+            e->mWatchers.push_back(w);
+            mEnters.push_back(AoiPair{w->mObjID, e->mObjID});
+        });
+    }
+    auto& watchers = e->mWatchers;
+    for (size_t i = 0; i < watchers.size();) {
+        auto w = watchers[i];
+        if (w->mDirty || aoi_sees(w, e)) {
+            ++i;
+            continue;
+        }
+        aoi_erase_sorted(w->mSeen, e);
+        mLeaves.push_back(AoiPair{w->mObjID, e->mObjID});
+        watchers[i] = watchers.back();
+        watchers.pop_back();
+    }
+}
+
+void AoiMgr::unlink(AoiEntity* e) {
+    for (auto w : e->mWatchers) {
+        aoi_erase_sorted(w->mSeen, e);
+        if (!w->mRemoved) {
+            mLeaves.push_back(AoiPair{w->mObjID, e->mObjID});
+        }
+    }
+    for (auto t : e->mSeen) {
+        aoi_erase_unsorted(t->mWatchers, e);
+    }
+    e->mWatchers.clear();
+    e->mSeen.clear();
+}
+
+}  // namespace PureCore
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "PureCore/CoreErrorDesc.h"
+#include "PureCore/Buffer/ArenaBuffer.h"
+
+namespace PureCore {
+ArenaBuffer::ArenaBuffer(FrameArena &arena) : DynamicBuffer(), mArena(arena) {}
+
+ArenaBuffer::~ArenaBuffer() {
+    // memory own by arena
+    mBuffer.reset(nullptr, 0);
+    mView.clear();
+}
+
+int ArenaBuffer::resize_buffer(size_t size) {
+    if (mBuffer.size() >= size) {
+        return Success;
+    }
+
+    char *newBuffer = (char *)mArena.reallocate(mBuffer.data(), mBuffer.size(), size, 1);
+    if (!newBuffer) {
+        return ErrorMemoryNotEnough;
+    }
+    size_t readPos = mView.read_pos();
+    size_t writePos = mView.write_pos();
+    mBuffer.reset(newBuffer, size);
+    mView.reset(mBuffer);
+    if (writePos > size) {
+        writePos = size;
+    }
+    if (readPos > writePos) {
+        readPos = writePos;
+    }
+    mView.write_pos(writePos);
+    mView.read_pos(readPos);
+    return Success;
+}
+
+//////////////////////////////////////////////////////////////
+// ArenaBufferHandle
+/////////////////////////////////////////////////////////////
+ArenaBufferHandle::ArenaBufferHandle(FrameArena &arena, size_t size) : mArena(&arena), mBuffer(arena.new_buffer(size)), mFrame(arena.get_frame()) {}
+
+bool ArenaBufferHandle::valid() const { return mBuffer != nullptr && mArena->get_frame() == mFrame; }
+
+ArenaBuffer *ArenaBufferHandle::get() const { return valid() ? mBuffer : nullptr; }
+
+uint64_t ArenaBufferHandle::get_frame() const { return mFrame; }
+
+}  // namespace PureCore
@@ -0,0 +1,278 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "PureCore/Buffer/ChainBuffer.h"
+#include "PureCore/CoreErrorDesc.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace PureCore {
+///////////////////////////////////////////////////////////////////////////
+// ChainSegment
+//////////////////////////////////////////////////////////////////////////
+// free segments of the default size, a segment released after the cache died at thread exit is freed directly
+struct ChainSegmentCache {
+    ~ChainSegmentCache();
+    std::vector<ChainSegment*> mSegments;
+};
+enum EChainCacheState { ChainCacheUnused, ChainCacheAlive, ChainCacheDead };
+static thread_local int tlCacheState = ChainCacheUnused;
+static thread_local ChainSegmentCache tlCache;
+
+// null once the cache of this thread is destroyed
+static ChainSegmentCache* local_cache() {
+    if (tlCacheState == ChainCacheUnused) {
+        // first touch constructs it and registers the destructor
+        tlCache.mSegments.reserve(ChainSegment::CacheCount);
+        tlCacheState = ChainCacheAlive;
+    }
+    return tlCacheState == ChainCacheAlive ? &tlCache : nullptr;
+}
+
+ChainSegmentCache::~ChainSegmentCache() {
+    tlCacheState = ChainCacheDead;
+    for (auto seg : mSegments) {
+        seg->~ChainSegment();
+        ::free(seg);
+    }
+    mSegments.clear();
+}
+
+ChainSegment::ChainSegment(uint32_t capacity) : mRef(1), mCapacity(capacity) {}
+
+ChainSegment* ChainSegment::create(size_t capacity) {
+    if (capacity == 0 || capacity > UINT32_MAX) {
+        return nullptr;
+    }
+    ChainSegmentCache* cache = capacity == DefaultSize ? local_cache() : nullptr;
+    if (cache != nullptr && !cache->mSegments.empty()) {
+        ChainSegment* seg = cache->mSegments.back();
+        cache->mSegments.pop_back();
+        seg->mRef.store(1, std::memory_order_relaxed);
+        seg->mSize = 0;
+        return seg;
+    }
+    void* p = ::malloc(sizeof(ChainSegment) + capacity);
+    if (p == nullptr) {
+        return nullptr;
+    }
+    return new (p) ChainSegment(uint32_t(capacity));
+}
+
+void ChainSegment::retain() { mRef.fetch_add(1, std::memory_order_relaxed); }
+
+void ChainSegment::release() {
+    if (mRef.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+    }
+    ChainSegmentCache* cache = mCapacity == DefaultSize ? local_cache() : nullptr;
+    if (cache != nullptr && cache->mSegments.size() < CacheCount) {
+        cache->mSegments.push_back(this);
+        return;
+    }
+    this->~ChainSegment();
+    ::free(this);
+}
+
+char* ChainSegment::data() { return reinterpret_cast<char*>(this + 1); }
+
+size_t ChainSegment::capacity() const { return mCapacity; }
+
+uint32_t ChainSegment::ref_count() const { return mRef.load(std::memory_order_relaxed); }
+
+bool ChainSegment::unique() const { return mRef.load(std::memory_order_acquire) == 1; }
+
+///////////////////////////////////////////////////////////////////////////
+// ChainBuffer
+//////////////////////////////////////////////////////////////////////////
+ChainBuffer::ChainBuffer(size_t segmentSize)
+    : mSegmentSize(segmentSize > 0 && segmentSize <= UINT32_MAX ? segmentSize : size_t(ChainSegment::DefaultSize)) {}
+
+ChainBuffer::~ChainBuffer() { clear(); }
+
+void ChainBuffer::swap(ChainBuffer& dest) {
+    std::swap(mSegmentSize, dest.mSegmentSize);
+    std::swap(mSize, dest.mSize);
+    std::swap(mHead, dest.mHead);
+    mSlices.swap(dest.mSlices);
+    std::swap(mTail, dest.mTail);
+}
+
+void ChainBuffer::clear() {
+    for (size_t i = mHead; i < mSlices.size(); ++i) {
+        mSlices[i].mSegment->release();
+    }
+    mSlices.clear();
+    mHead = 0;
+    mSize = 0;
+    if (mTail != nullptr) {
+        mTail->release();
+        mTail = nullptr;
+    }
+}
+
+bool ChainBuffer::empty() const { return mSize == 0; }
+
+size_t ChainBuffer::size() const { return mSize; }
+
+size_t ChainBuffer::slice_count() const { return mSlices.size() - mHead; }
+
+const ChainSlice& ChainBuffer::slice(size_t idx) const { return mSlices[mHead + idx]; }
+
+int ChainBuffer::write(DataRef data) {
+    const char* src = data.data();
+    size_t left = data.size();
+    if (left == 0) {
+        return Success;
+    }
+    // fill the rest of the tail segment, bytes past its size are not in any slice even after the slices are flushed
+    if (mTail != nullptr && mTail->mSize < mTail->mCapacity) {
+        size_t n = std::min<size_t>(left, mTail->mCapacity - mTail->mSize);
+        uint32_t offset = mTail->mSize;
+        memcpy(mTail->data() + offset, src, n);
+        mTail->mSize += uint32_t(n);
+        mTail->retain();
+        push_slice(mTail, offset, uint32_t(n));
+        mSize += n;
+        src += n;
+        left -= n;
+    }
+    while (left > 0) {
+        ChainSegment* seg = ChainSegment::create(mSegmentSize);
+        if (seg == nullptr) {
+            return ErrorMemoryNotEnough;
+        }
+        size_t n = std::min<size_t>(left, mSegmentSize);
+        memcpy(seg->data(), src, n);
+        seg->mSize = uint32_t(n);
+        push_slice(seg, 0, uint32_t(n));
+        // the chain keeps its own reference on the tail
+        seg->retain();
+        if (mTail != nullptr) {
+            mTail->release();
+        }
+        mTail = seg;
+        mSize += n;
+        src += n;
+        left -= n;
+    }
+    return Success;
+}
+
+int ChainBuffer::append(const ChainBuffer& other) {
+    // index loop, other may be this chain
+    size_t end = other.mSlices.size();
+    for (size_t i = other.mHead; i < end; ++i) {
+        ChainSlice s = other.mSlices[i];
+        s.mSegment->retain();
+        push_slice(s.mSegment, s.mOffset, s.mLength);
+        mSize += s.mLength;
+    }
+    return Success;
+}
+
+int ChainBuffer::append(ChainSegment* segment, size_t offset, size_t len) {
+    if (segment == nullptr) {
+        return ErrorNullPointer;
+    }
+    if (offset > segment->capacity() || len > segment->capacity() - offset) {
+        return ErrorInvalidArg;
+    }
+    if (len == 0) {
+        return Success;
+    }
+    segment->retain();
+    push_slice(segment, uint32_t(offset), uint32_t(len));
+    mSize += len;
+    return Success;
+}
+
+size_t ChainBuffer::move_front(ChainBuffer& dest, size_t count) {
+    if (&dest == this) {
+        return 0;
+    }
+    size_t bytes = 0;
+    size_t end = mHead + std::min(count, slice_count());
+    for (; mHead < end; ++mHead) {
+        ChainSlice& s = mSlices[mHead];
+        dest.push_slice(s.mSegment, s.mOffset, s.mLength);
+        dest.mSize += s.mLength;
+        bytes += s.mLength;
+    }
+    mSize -= bytes;
+    compact();
+    return bytes;
+}
+
+size_t ChainBuffer::peek(DataRef* out, size_t count) const {
+    size_t n = std::min(count, slice_count());
+    for (size_t i = 0; i < n; ++i) {
+        const ChainSlice& s = mSlices[mHead + i];
+        out[i] = DataRef(s.mSegment->data() + s.mOffset, s.mLength);
+    }
+    return n;
+}
+
+void ChainBuffer::consume(size_t size) {
+    while (size > 0 && mHead < mSlices.size()) {
+        ChainSlice& s = mSlices[mHead];
+        if (s.mLength > size) {
+            s.mOffset += uint32_t(size);
+            s.mLength -= uint32_t(size);
+            mSize -= size;
+            break;
+        }
+        size -= s.mLength;
+        mSize -= s.mLength;
+        s.mSegment->release();
+        ++mHead;
+    }
+    compact();
+}
+
+void ChainBuffer::push_slice(ChainSegment* segment, uint32_t offset, uint32_t len) {
+    // the slice owns one reference, a slice continuing the last one merges and drops it
+    if (mHead < mSlices.size()) {
+        ChainSlice& back = mSlices.back();
+        if (back.mSegment == segment && back.mOffset + back.mLength == offset) {
+            back.mLength += len;
+            segment->release();
+            return;
+        }
+    }
+    mSlices.push_back(ChainSlice{segment, offset, len});
+}
+
+void ChainBuffer::compact() {
+    if (mHead == mSlices.size()) {
+        mSlices.clear();
+        mHead = 0;
+    } else if (mHead >= 32 && mHead * 2 >= mSlices.size()) {
+        mSlices.erase(mSlices.begin(), mSlices.begin() + mHead);
+        mHead = 0;
+    }
+}
+
+}  // namespace PureCore
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "PureCore/Channel.h"
+#include "PureCore/CoreErrorDesc.h"
+
+#ifdef __linux__
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+#include <chrono>
+
+namespace PureCore {
+ChannelWaker::~ChannelWaker() { release(); }
+
+int ChannelWaker::init() {
+#ifdef __linux__
+    if (mFd >= 0) {
+        return Success;
+    }
+    mFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (mFd < 0) {
+        return ErrorCreateWakerFailed;
+    }
+#endif
+    return Success;
+}
+
+void ChannelWaker::release() {
+#ifdef __linux__
+    if (mFd >= 0) {
+        close(mFd);
+        mFd = -1;
+    }
+#endif
+    std::lock_guard<std::mutex> lock(mMutex);
+    mNotified = false;
+}
+
+void ChannelWaker::notify() {
+#ifdef __linux__
+    if (mFd >= 0) {
+        uint64_t value = 1;
+        ssize_t ret = write(mFd, &value, sizeof(value));
+        (void)ret;
+        return;
+    }
+#endif
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mNotified = true;
+    }
+    mCond.notify_one();
+}
+
+bool ChannelWaker::wait(int64_t ms) {
+#ifdef __linux__
+    if (mFd >= 0) {
+        uint64_t value = 0;
+        if (read(mFd, &value, sizeof(value)) == sizeof(value)) {
+            return true;
+        }
+        pollfd pfd{};
+        pfd.fd = mFd;
+        pfd.events = POLLIN;
+        if (poll(&pfd, 1, ms < 0 ? -1 : int(ms)) <= 0) {
+            return false;
+        }
+        return read(mFd, &value, sizeof(value)) == sizeof(value);
+    }
+#endif
+    std::unique_lock<std::mutex> lock(mMutex);
+    if (ms < 0) {
+        mCond.wait(lock, [this]() { return mNotified; });
+    } else if (!mCond.wait_for(lock, std::chrono::milliseconds(ms), [this]() { return mNotified; })) {
+        return false;
+    }
+    mNotified = false;
+    return true;
+}
+
+int ChannelWaker::get_fd() const { return mFd; }
+
+}  // namespace PureCore
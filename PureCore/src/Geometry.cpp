@@ -133,7 +133,9 @@ bool IntLine::intersect(const IntLine& l) const {
     return line_is_turn(mMin, l.mMin, l.mMax) != line_is_turn(mMax, l.mMin, l.mMax) && line_is_turn(mMin, mMax, l.mMin) != line_is_turn(mMin, mMax, l.mMax);
 }
 
-IntABox IntLine::get_bounding() const { return IntABox{mMin, mMax}; }
+IntABox IntLine::get_bounding() const {
+    return IntABox{std::min(mMin.mX, mMax.mX), std::min(mMin.mY, mMax.mY), std::max(mMin.mX, mMax.mX), std::max(mMin.mY, mMax.mY)};
+}
 
 ///////////////////////////////////////////////////////////////////////////
 // IntCircle
@@ -260,9 +262,9 @@ bool IntABox::intersect_circle(const IntCircle& cc) const {
     } else if (cc.mCenter.mY > mMax.mY) {
         minY = mMax.mY;
     }
-    int32_t dX = cc.mCenter.mX - minX;
-    int32_t dY = cc.mCenter.mY - minY;
-    return (dX * dX + dY * dY) <= (cc.mRadius * cc.mRadius);
+    int64_t dX = int64_t(cc.mCenter.mX) - minX;
+    int64_t dY = int64_t(cc.mCenter.mY) - minY;
+    return (dX * dX + dY * dY) <= (int64_t(cc.mRadius) * cc.mRadius);
 }
 
 bool IntABox::intersect_sector(const IntSector& sec) const {
@@ -339,6 +341,61 @@ IntPoint IntABox::size() const { return IntPoint{mMax.mX - mMin.mX, mMax.mY - mM
 
 IntPoint IntABox::half_size() const { return IntPoint{(mMax.mX - mMin.mX) / 2, (mMax.mY - mMin.mY) / 2}; }
 
+IntABox IntABox::expand(int32_t margin) const {
+    if (margin <= 0) {
+        return *this;
+    }
+    auto sub = [margin](int32_t v) { return int32_t(std::max(int64_t(INT32_MIN), int64_t(v) - margin)); };
+    auto add = [margin](int32_t v) { return int32_t(std::min(int64_t(INT32_MAX), int64_t(v) + margin)); };
+    return IntABox{{sub(mMin.mX), sub(mMin.mY)}, {add(mMax.mX), add(mMax.mY)}};
+}
+
+int64_t IntABox::dist2_point(const IntPoint& p) const {
+    int64_t dx = 0;
+    int64_t dy = 0;
+    if (p.mX < mMin.mX) {
+        dx = int64_t(mMin.mX) - p.mX;
+    } else if (p.mX > mMax.mX) {
+        dx = int64_t(p.mX) - mMax.mX;
+    }
+    if (p.mY < mMin.mY) {
+        dy = int64_t(mMin.mY) - p.mY;
+    } else if (p.mY > mMax.mY) {
+        dy = int64_t(p.mY) - mMax.mY;
+    }
+    return dx * dx + dy * dy;
+}
+
+// slab test, int32 deltas are exact in double
+bool IntABox::line_enter(const IntLine& l, double& t) const {
+    double enter = 0.0;
+    double leave = 1.0;
+    const int32_t origin[2] = {l.mMin.mX, l.mMin.mY};
+    const double delta[2] = {double(l.mMax.mX) - l.mMin.mX, double(l.mMax.mY) - l.mMin.mY};
+    const int32_t low[2] = {mMin.mX, mMin.mY};
+    const int32_t high[2] = {mMax.mX, mMax.mY};
+    for (int i = 0; i < 2; ++i) {
+        if (delta[i] == 0.0) {
+            if (origin[i] < low[i] || origin[i] > high[i]) {
+                return false;
+            }
+            continue;
+        }
+        double t1 = (double(low[i]) - origin[i]) / delta[i];
+        double t2 = (double(high[i]) - origin[i]) / delta[i];
+        if (t1 > t2) {
+            std::swap(t1, t2);
+        }
+        enter = std::max(enter, t1);
+        leave = std::min(leave, t2);
+        if (enter > leave) {
+            return false;
+        }
+    }
+    t = enter;
+    return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////
 // IntOBox
 //////////////////////////////////////////////////////////////////////////
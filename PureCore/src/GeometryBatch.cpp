@@ -0,0 +1,356 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "PureCore/Geometry.h"
+
+#include <algorithm>
+#include <atomic>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define PURE_GEOMETRY_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define PURE_TARGET(t)
+#else
+#define PURE_TARGET(t) __attribute__((target(t)))
+#endif
+#endif
+
+namespace PureCore {
+///////////////////////////////////////////////////////////////////////////
+// IntABoxArray
+//////////////////////////////////////////////////////////////////////////
+size_t IntABoxArray::size() const { return mSize; }
+
+bool IntABoxArray::empty() const { return mSize == 0; }
+
+void IntABoxArray::clear() { mSize = 0; }
+
+void IntABoxArray::reserve(size_t n) {
+    if (n <= mCapacity) {
+        return;
+    }
+    std::vector<int32_t> data(n * 4);
+    for (size_t col = 0; col < 4; ++col) {
+        std::copy_n(mData.data() + col * mCapacity, mSize, data.data() + col * n);
+    }
+    mData.swap(data);
+    mCapacity = n;
+}
+
+void IntABoxArray::push_back(const IntABox& box) {
+    if (mSize == mCapacity) {
+        reserve(mCapacity < 4 ? 4 : mCapacity * 2);
+    }
+    set(mSize++, box);
+}
+
+void IntABoxArray::set(size_t idx, const IntABox& box) {
+    int32_t* data = mData.data();
+    data[idx] = box.mMin.mX;
+    data[idx + mCapacity] = box.mMin.mY;
+    data[idx + mCapacity * 2] = box.mMax.mX;
+    data[idx + mCapacity * 3] = box.mMax.mY;
+}
+
+IntABox IntABoxArray::get(size_t idx) const {
+    const int32_t* data = mData.data();
+    return IntABox{data[idx], data[idx + mCapacity], data[idx + mCapacity * 2], data[idx + mCapacity * 3]};
+}
+
+void IntABoxArray::swap_remove(size_t idx) {
+    set(idx, get(mSize - 1));
+    --mSize;
+}
+
+///////////////////////////////////////////////////////////////////////////
+// kernels, each one tests at most 64 boxes and returns the hit bits
+//////////////////////////////////////////////////////////////////////////
+typedef uint64_t (*ABoxKernel)(const IntABox&, const int32_t*, const int32_t*, const int32_t*, const int32_t*, size_t);
+typedef uint64_t (*CircleKernel)(const IntCircle&, const IntABox&, const int32_t*, const int32_t*, const int32_t*, const int32_t*, size_t);
+
+static uint64_t abox_scalar(const IntABox& box, const int32_t* minX, const int32_t* minY, const int32_t* maxX, const int32_t* maxY, size_t n) {
+    uint64_t bits = 0;
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t hit = minX[i] <= box.mMax.mX && minY[i] <= box.mMax.mY && maxX[i] >= box.mMin.mX && maxY[i] >= box.mMin.mY;
+        bits |= hit << i;
+    }
+    return bits;
+}
+
+// bound is the circle bounding box, a box passing it is close enough for the squares to fit int64
+static uint64_t circle_scalar(const IntCircle& cir, const IntABox& bound, const int32_t* minX, const int32_t* minY, const int32_t* maxX, const int32_t* maxY,
+                              size_t n) {
+    int64_t r2 = int64_t(cir.mRadius) * cir.mRadius;
+    uint64_t bits = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (minX[i] <= bound.mMax.mX && minY[i] <= bound.mMax.mY && maxX[i] >= bound.mMin.mX && maxY[i] >= bound.mMin.mY) {
+            int64_t dx = int64_t(cir.mCenter.mX) - std::min(std::max(cir.mCenter.mX, minX[i]), maxX[i]);
+            int64_t dy = int64_t(cir.mCenter.mY) - std::min(std::max(cir.mCenter.mY, minY[i]), maxY[i]);
+            bits |= uint64_t(dx * dx + dy * dy <= r2) << i;
+        }
+    }
+    return bits;
+}
+
+#ifdef PURE_GEOMETRY_X86
+PURE_TARGET("sse4.2")
+static uint64_t abox_sse42(const IntABox& box, const int32_t* minX, const int32_t* minY, const int32_t* maxX, const int32_t* maxY, size_t n) {
+    const __m128i qMinX = _mm_set1_epi32(box.mMin.mX);
+    const __m128i qMinY = _mm_set1_epi32(box.mMin.mY);
+    const __m128i qMaxX = _mm_set1_epi32(box.mMax.mX);
+    const __m128i qMaxY = _mm_set1_epi32(box.mMax.mY);
+    uint64_t bits = 0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i miss = _mm_cmpgt_epi32(_mm_loadu_si128((const __m128i*)(minX + i)), qMaxX);
+        miss = _mm_or_si128(miss, _mm_cmpgt_epi32(_mm_loadu_si128((const __m128i*)(minY + i)), qMaxY));
+        miss = _mm_or_si128(miss, _mm_cmpgt_epi32(qMinX, _mm_loadu_si128((const __m128i*)(maxX + i))));
+        miss = _mm_or_si128(miss, _mm_cmpgt_epi32(qMinY, _mm_loadu_si128((const __m128i*)(maxY + i))));
+        bits |= uint64_t(~_mm_movemask_ps(_mm_castsi128_ps(miss)) & 0xF) << i;
+    }
+    if (i < n) {
+        bits |= abox_scalar(box, minX + i, minY + i, maxX + i, maxY + i, n - i) << i;
+    }
+    return bits;
+}
+
+PURE_TARGET("sse4.2")
+static uint64_t circle_sse42(const IntCircle& cir, const IntABox& bound, const int32_t* minX, const int32_t* minY, const int32_t* maxX, const int32_t* maxY,
+                             size_t n) {
+    const __m128i qMinX = _mm_set1_epi32(bound.mMin.mX);
+    const __m128i qMinY = _mm_set1_epi32(bound.mMin.mY);
+    const __m128i qMaxX = _mm_set1_epi32(bound.mMax.mX);
+    const __m128i qMaxY = _mm_set1_epi32(bound.mMax.mY);
+    const __m128i cx = _mm_set1_epi32(cir.mCenter.mX);
+    const __m128i cy = _mm_set1_epi32(cir.mCenter.mY);
+    const __m128i r2 = _mm_set1_epi64x(int64_t(cir.mRadius) * cir.mRadius);
+    uint64_t bits = 0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i bMinX = _mm_loadu_si128((const __m128i*)(minX + i));
+        __m128i bMinY = _mm_loadu_si128((const __m128i*)(minY + i));
+        __m128i bMaxX = _mm_loadu_si128((const __m128i*)(maxX + i));
+        __m128i bMaxY = _mm_loadu_si128((const __m128i*)(maxY + i));
+        __m128i miss = _mm_cmpgt_epi32(bMinX, qMaxX);
+        miss = _mm_or_si128(miss, _mm_cmpgt_epi32(bMinY, qMaxY));
+        miss = _mm_or_si128(miss, _mm_cmpgt_epi32(qMinX, bMaxX));
+        miss = _mm_or_si128(miss, _mm_cmpgt_epi32(qMinY, bMaxY));
+        // lanes past the bound test have |d| <= radius, so 32 bit deltas are exact there
+        __m128i dx = _mm_sub_epi32(cx, _mm_min_epi32(_mm_max_epi32(cx, bMinX), bMaxX));
+        __m128i dy = _mm_sub_epi32(cy, _mm_min_epi32(_mm_max_epi32(cy, bMinY), bMaxY));
+        __m128i evenD2 = _mm_add_epi64(_mm_mul_epi32(dx, dx), _mm_mul_epi32(dy, dy));
+        __m128i oddX = _mm_srli_epi64(dx, 32);
+        __m128i oddY = _mm_srli_epi64(dy, 32);
+        __m128i oddD2 = _mm_add_epi64(_mm_mul_epi32(oddX, oddX), _mm_mul_epi32(oddY, oddY));
+        __m128i far = _mm_blend_epi16(_mm_cmpgt_epi64(evenD2, r2), _mm_cmpgt_epi64(oddD2, r2), 0xCC);
+        miss = _mm_or_si128(miss, far);
+        bits |= uint64_t(~_mm_movemask_ps(_mm_castsi128_ps(miss)) & 0xF) << i;
+    }
+    if (i < n) {
+        bits |= circle_scalar(cir, bound, minX + i, minY + i, maxX + i, maxY + i, n - i) << i;
+    }
+    return bits;
+}
+
+PURE_TARGET("avx2")
+static uint64_t abox_avx2(const IntABox& box, const int32_t* minX, const int32_t* minY, const int32_t* maxX, const int32_t* maxY, size_t n) {
+    const __m256i qMinX = _mm256_set1_epi32(box.mMin.mX);
+    const __m256i qMinY = _mm256_set1_epi32(box.mMin.mY);
+    const __m256i qMaxX = _mm256_set1_epi32(box.mMax.mX);
+    const __m256i qMaxY = _mm256_set1_epi32(box.mMax.mY);
+    uint64_t bits = 0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i miss = _mm256_cmpgt_epi32(_mm256_loadu_si256((const __m256i*)(minX + i)), qMaxX);
+        miss = _mm256_or_si256(miss, _mm256_cmpgt_epi32(_mm256_loadu_si256((const __m256i*)(minY + i)), qMaxY));
+        miss = _mm256_or_si256(miss, _mm256_cmpgt_epi32(qMinX, _mm256_loadu_si256((const __m256i*)(maxX + i))));
+        miss = _mm256_or_si256(miss, _mm256_cmpgt_epi32(qMinY, _mm256_loadu_si256((const __m256i*)(maxY + i))));
+        bits |= uint64_t(~_mm256_movemask_ps(_mm256_castsi256_ps(miss)) & 0xFF) << i;
+    }
+    // the tail stays scalar, calling the non vex sse4.2 kernel here pays the avx to sse transition
+    if (i < n) {
+        bits |= abox_scalar(box, minX + i, minY + i, maxX + i, maxY + i, n - i) << i;
+    }
+    return bits;
+}
+
+PURE_TARGET("avx2")
+static uint64_t circle_avx2(const IntCircle& cir, const IntABox& bound, const int32_t* minX, const int32_t* minY, const int32_t* maxX, const int32_t* maxY,
+                            size_t n) {
+    const __m256i qMinX = _mm256_set1_epi32(bound.mMin.mX);
+    const __m256i qMinY = _mm256_set1_epi32(bound.mMin.mY);
+    const __m256i qMaxX = _mm256_set1_epi32(bound.mMax.mX);
+    const __m256i qMaxY = _mm256_set1_epi32(bound.mMax.mY);
+    const __m256i cx = _mm256_set1_epi32(cir.mCenter.mX);
+    const __m256i cy = _mm256_set1_epi32(cir.mCenter.mY);
+    const __m256i r2 = _mm256_set1_epi64x(int64_t(cir.mRadius) * cir.mRadius);
+    uint64_t bits = 0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i bMinX = _mm256_loadu_si256((const __m256i*)(minX + i));
+        __m256i bMinY = _mm256_loadu_si256((const __m256i*)(minY + i));
+        __m256i bMaxX = _mm256_loadu_si256((const __m256i*)(maxX + i));
+        __m256i bMaxY = _mm256_loadu_si256((const __m256i*)(maxY + i));
+        __m256i miss = _mm256_cmpgt_epi32(bMinX, qMaxX);
+        miss = _mm256_or_si256(miss, _mm256_cmpgt_epi32(bMinY, qMaxY));
+        miss = _mm256_or_si256(miss, _mm256_cmpgt_epi32(qMinX, bMaxX));
+        miss = _mm256_or_si256(miss, _mm256_cmpgt_epi32(qMinY, bMaxY));
+        __m256i dx = _mm256_sub_epi32(cx, _mm256_min_epi32(_mm256_max_epi32(cx, bMinX), bMaxX));
+        __m256i dy = _mm256_sub_epi32(cy, _mm256_min_epi32(_mm256_max_epi32(cy, bMinY), bMaxY));
+        __m256i evenD2 = _mm256_add_epi64(_mm256_mul_epi32(dx, dx), _mm256_mul_epi32(dy, dy));
+        __m256i oddX = _mm256_srli_epi64(dx, 32);
+        __m256i oddY = _mm256_srli_epi64(dy, 32);
+        __m256i oddD2 = _mm256_add_epi64(_mm256_mul_epi32(oddX, oddX), _mm256_mul_epi32(oddY, oddY));
+        __m256i far = _mm256_blend_epi32(_mm256_cmpgt_epi64(evenD2, r2), _mm256_cmpgt_epi64(oddD2, r2), 0xAA);
+        miss = _mm256_or_si256(miss, far);
+        bits |= uint64_t(~_mm256_movemask_ps(_mm256_castsi256_ps(miss)) & 0xFF) << i;
+    }
+    if (i < n) {
+        bits |= circle_scalar(cir, bound, minX + i, minY + i, maxX + i, maxY + i, n - i) << i;
+    }
+    return bits;
+}
+
+static int detect_level() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4] = {0};
+    __cpuid(info, 0);
+    int maxLeaf = info[0];
+    __cpuid(info, 1);
+    bool sse42 = (info[2] & (1 << 20)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx2 = false;
+    if (maxLeaf >= 7 && osxsave && (_xgetbv(0) & 0x6) == 0x6) {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+    }
+#else
+    __builtin_cpu_init();
+    bool sse42 = __builtin_cpu_supports("sse4.2");
+    bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+    return avx2 ? 2 : (sse42 ? 1 : 0);
+}
+#else
+static int detect_level() { return 0; }
+#endif
+
+// the pointers start at the resolvers, the first call swaps in the kernels of this cpu
+static uint64_t abox_resolve(const IntABox& box, const int32_t* minX, const int32_t* minY, const int32_t* maxX, const int32_t* maxY, size_t n);
+static uint64_t circle_resolve(const IntCircle& cir, const IntABox& bound, const int32_t* minX, const int32_t* minY, const int32_t* maxX,
+                               const int32_t* maxY, size_t n);
+
+static std::atomic<int> sLevel{-1};
+static std::atomic<ABoxKernel> sABoxKernel{abox_resolve};
+static std::atomic<CircleKernel> sCircleKernel{circle_resolve};
+
+static int resolve_kernels() {
+    int level = detect_level();
+    ABoxKernel aboxKernel = abox_scalar;
+    CircleKernel circleKernel = circle_scalar;
+#ifdef PURE_GEOMETRY_X86
+    if (level == 2) {
+        aboxKernel = abox_avx2;
+        circleKernel = circle_avx2;
+    } else if (level == 1) {
+        aboxKernel = abox_sse42;
+        circleKernel = circle_sse42;
+    }
+#endif
+    sABoxKernel.store(aboxKernel, std::memory_order_relaxed);
+    sCircleKernel.store(circleKernel, std::memory_order_relaxed);
+    sLevel.store(level, std::memory_order_relaxed);
+    return level;
+}
+
+static uint64_t abox_resolve(const IntABox& box, const int32_t* minX, const int32_t* minY, const int32_t* maxX, const int32_t* maxY, size_t n) {
+    resolve_kernels();
+    return sABoxKernel.load(std::memory_order_relaxed)(box, minX, minY, maxX, maxY, n);
+}
+
+static uint64_t circle_resolve(const IntCircle& cir, const IntABox& bound, const int32_t* minX, const int32_t* minY, const int32_t* maxX,
+                               const int32_t* maxY, size_t n) {
+    resolve_kernels();
+    return sCircleKernel.load(std::memory_order_relaxed)(cir, bound, minX, minY, maxX, maxY, n);
+}
+
+static size_t write_mask(uint64_t bits, size_t count, uint8_t* mask) {
+    for (size_t j = 0; j < count; ++j) {
+        mask[j] = uint8_t((bits >> j) & 1u);
+    }
+    size_t hits = 0;
+    for (; bits != 0; bits &= bits - 1) {
+        ++hits;
+    }
+    return hits;
+}
+
+uint64_t intersect_abox_bits(const IntABox& box, const int32_t* minX, const int32_t* minY, const int32_t* maxX, const int32_t* maxY, size_t n) {
+    return sABoxKernel.load(std::memory_order_relaxed)(box, minX, minY, maxX, maxY, n);
+}
+
+uint64_t intersect_circle_bits(const IntCircle& cir, const int32_t* minX, const int32_t* minY, const int32_t* maxX, const int32_t* maxY, size_t n) {
+    return sCircleKernel.load(std::memory_order_relaxed)(cir, cir.get_bounding(), minX, minY, maxX, maxY, n);
+}
+
+size_t intersect_abox_many(const IntABox& box, const int32_t* minX, const int32_t* minY, const int32_t* maxX, const int32_t* maxY, size_t n, uint8_t* mask) {
+    ABoxKernel kernel = sABoxKernel.load(std::memory_order_relaxed);
+    size_t hits = 0;
+    for (size_t i = 0; i < n; i += 64) {
+        size_t count = std::min<size_t>(n - i, 64);
+        hits += write_mask(kernel(box, minX + i, minY + i, maxX + i, maxY + i, count), count, mask + i);
+    }
+    return hits;
+}
+
+size_t intersect_abox_many(const IntABox& box, const IntABoxArray& boxes, uint8_t* mask) {
+    return intersect_abox_many(box, boxes.min_x(), boxes.min_y(), boxes.max_x(), boxes.max_y(), boxes.size(), mask);
+}
+
+size_t intersect_circle_many(const IntCircle& cir, const int32_t* minX, const int32_t* minY, const int32_t* maxX, const int32_t* maxY, size_t n,
+                             uint8_t* mask) {
+    CircleKernel kernel = sCircleKernel.load(std::memory_order_relaxed);
+    IntABox bound = cir.get_bounding();
+    size_t hits = 0;
+    for (size_t i = 0; i < n; i += 64) {
+        size_t count = std::min<size_t>(n - i, 64);
+        hits += write_mask(kernel(cir, bound, minX + i, minY + i, maxX + i, maxY + i, count), count, mask + i);
+    }
+    return hits;
+}
+
+size_t intersect_circle_many(const IntCircle& cir, const IntABoxArray& boxes, uint8_t* mask) {
+    return intersect_circle_many(cir, boxes.min_x(), boxes.min_y(), boxes.max_x(), boxes.max_y(), boxes.size(), mask);
+}
+
+const char* geometry_batch_level() {
+    static const char* names[] = {"scalar", "sse4.2", "avx2"};
+    int level = sLevel.load(std::memory_order_relaxed);
+    if (level < 0) {
+        level = resolve_kernels();
+    }
+    return names[level];
+}
+
+}  // namespace PureCore
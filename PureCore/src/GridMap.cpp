@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "PureCore/GridMap.h"
+#include "PureCore/CoreErrorDesc.h"
+#include "PureCore/OsHelper.h"
+#include "PureCore/Buffer/DynamicBuffer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace PureCore {
+static const uint32_t sGridMapMagic = 0x4D475250;  // "PRGM"
+static const uint32_t sGridMapVersion = 1;
+static const int32_t sGridMapMaxSide = 32768;
+
+static std::atomic<uint64_t> sGridMapStamp{};
+
+// file image: header then the rows without borders, native endian like StaticRectTree
+struct GridMapHeader {
+    uint32_t mMagic;
+    uint32_t mVersion;
+    int32_t mWidth;
+    int32_t mHeight;
+};
+
+// all bits of a line of size cells set from size on
+static void block_padding(uint64_t* line, size_t words, int32_t size) {
+    if (size % 64 != 0) {
+        line[words - 1] |= ~uint64_t(0) << (size % 64);
+    }
+}
+
+int GridMap::init(int32_t width, int32_t height) {
+    if (width <= 0 || height <= 0 || width > sGridMapMaxSide || height > sGridMapMaxSide) {
+        return ErrorInvalidArg;
+    }
+    mWidth = width;
+    mHeight = height;
+    mRowWords = (size_t(width) + 63) / 64;
+    mColumnWords = (size_t(height) + 63) / 64;
+    mRows.assign((size_t(height) + 2) * mRowWords, 0);
+    mColumns.assign((size_t(width) + 2) * mColumnWords, 0);
+    std::fill(mRows.begin(), mRows.begin() + mRowWords, ~uint64_t(0));
+    std::fill(mRows.end() - mRowWords, mRows.end(), ~uint64_t(0));
+    for (int32_t y = 0; y < height; ++y) {
+        block_padding(&mRows[(size_t(y) + 1) * mRowWords], mRowWords, width);
+    }
+    std::fill(mColumns.begin(), mColumns.begin() + mColumnWords, ~uint64_t(0));
+    std::fill(mColumns.end() - mColumnWords, mColumns.end(), ~uint64_t(0));
+    for (int32_t x = 0; x < width; ++x) {
+        block_padding(&mColumns[(size_t(x) + 1) * mColumnWords], mColumnWords, height);
+    }
+    touch();
+    return Success;
+}
+
+void GridMap::clear() {
+    mWidth = 0;
+    mHeight = 0;
+    mRowWords = 0;
+    mColumnWords = 0;
+    mRows.clear();
+    mColumns.clear();
+    touch();
+}
+
+int32_t GridMap::width() const { return mWidth; }
+
+int32_t GridMap::height() const { return mHeight; }
+
+bool GridMap::is_block(int32_t x, int32_t y) const {
+    if (x < 0 || y < 0 || x >= mWidth || y >= mHeight) {
+        return true;
+    }
+    return (row(y)[x >> 6] >> (x & 63)) & 1;
+}
+
+bool GridMap::is_walkable(int32_t x, int32_t y) const { return !is_block(x, y); }
+
+int GridMap::set_block(int32_t x, int32_t y, bool block) {
+    if (x < 0 || y < 0 || x >= mWidth || y >= mHeight) {
+        return ErrorInvalidArg;
+    }
+    set_bit(x, y, block);
+    touch();
+    return Success;
+}
+
+int GridMap::set_block_abox(const IntABox& box, bool block) {
+    int32_t minX = std::max(box.mMin.mX, 0);
+    int32_t minY = std::max(box.mMin.mY, 0);
+    int32_t maxX = std::min(box.mMax.mX, mWidth - 1);
+    int32_t maxY = std::min(box.mMax.mY, mHeight - 1);
+    if (minX > maxX || minY > maxY) {
+        return ErrorInvalidArg;
+    }
+    for (int32_t y = minY; y <= maxY; ++y) {
+        for (int32_t x = minX; x <= maxX; ++x) {
+            set_bit(x, y, block);
+        }
+    }
+    touch();
+    return Success;
+}
+
+bool GridMap::line_of_sight(const IntLine& line) const {
+    // supercover walk of the cells under the segment, integer errors are doubled to stay exact at cell edges
+    int32_t x = line.mMin.mX;
+    int32_t y = line.mMin.mY;
+    if (is_block(x, y) || is_block(line.mMax.mX, line.mMax.mY)) {
+        return false;
+    }
+    int64_t dx = int64_t(line.mMax.mX) - x;
+    int64_t dy = int64_t(line.mMax.mY) - y;
+    int32_t stepX = dx < 0 ? -1 : 1;
+    int32_t stepY = dy < 0 ? -1 : 1;
+    dx = dx < 0 ? -dx : dx;
+    dy = dy < 0 ? -dy : dy;
+    int64_t ddx = dx * 2;
+    int64_t ddy = dy * 2;
+    if (ddx >= ddy) {
+        int64_t err = dx;
+        int64_t prev = err;
+        for (int64_t i = 0; i < dx; ++i) {
+            x += stepX;
+            err += ddy;
+            if (err > ddx) {
+                y += stepY;
+                err -= ddx;
+                // the segment also crossed the cell below, the one behind, or both at a corner
+                if (err + prev <= ddx && is_block(x, y - stepY)) {
+                    return false;
+                }
+                if (err + prev >= ddx && is_block(x - stepX, y)) {
+                    return false;
+                }
+            }
+            if (is_block(x, y)) {
+                return false;
+            }
+            prev = err;
+        }
+    } else {
+        int64_t err = dy;
+        int64_t prev = err;
+        for (int64_t i = 0; i < dy; ++i) {
+            y += stepY;
+            err += ddx;
+            if (err > ddy) {
+                x += stepX;
+                err -= ddy;
+                if (err + prev <= ddy && is_block(x - stepX, y)) {
+                    return false;
+                }
+                if (err + prev >= ddy && is_block(x, y - stepY)) {
+                    return false;
+                }
+            }
+            if (is_block(x, y)) {
+                return false;
+            }
+            prev = err;
+        }
+    }
+    return true;
+}
+
+uint64_t GridMap::stamp() const { return mStamp; }
+
+int GridMap::save(const char* path) const {
+    GridMapHeader header{sGridMapMagic, sGridMapVersion, mWidth, mHeight};
+    size_t bytes = size_t(mHeight) * mRowWords * sizeof(uint64_t);
+    std::vector<char> image(sizeof(header) + bytes);
+    memcpy(image.data(), &header, sizeof(header));
+    if (bytes > 0) {
+        memcpy(image.data() + sizeof(header), &mRows[mRowWords], bytes);
+    }
+    return write_file(DataRef(image.data(), image.size()), path);
+}
+
+int GridMap::load(const char* path) {
+    clear();
+    DynamicBuffer buffer;
+    int err = read_file(buffer, path);
+    if (err != Success) {
+        return err;
+    }
+    DataRef data = buffer.data();
+    GridMapHeader header{};
+    if (data.size() < sizeof(header)) {
+        return ErrorInvalidData;
+    }
+    memcpy(&header, data.data(), sizeof(header));
+    if (header.mMagic != sGridMapMagic || header.mVersion != sGridMapVersion) {
+        return ErrorInvalidData;
+    }
+    err = init(header.mWidth, header.mHeight);
+    if (err != Success) {
+        return ErrorInvalidData;
+    }
+    size_t bytes = size_t(mHeight) * mRowWords * sizeof(uint64_t);
+    if (data.size() != sizeof(header) + bytes) {
+        clear();
+        return ErrorInvalidData;
+    }
+    memcpy(&mRows[mRowWords], data.data() + sizeof(header), bytes);
+    // rebuild the columns from the rows, padding bits may be anything in a foreign image
+    for (int32_t y = 0; y < mHeight; ++y) {
+        uint64_t* line = &mRows[(size_t(y) + 1) * mRowWords];
+        block_padding(line, mRowWords, mWidth);
+        for (size_t w = 0; w < mRowWords; ++w) {
+            uint64_t bits = line[w];
+            for (int32_t x = int32_t(w * 64); bits != 0 && x < mWidth; ++x, bits >>= 1) {
+                if (bits & 1) {
+                    mColumns[(size_t(x) + 1) * mColumnWords + (y >> 6)] |= uint64_t(1) << (y & 63);
+                }
+            }
+        }
+    }
+    touch();
+    return Success;
+}
+
+const uint64_t* GridMap::row(int32_t y) const { return &mRows[(size_t(y) + 1) * mRowWords]; }
+
+const uint64_t* GridMap::column(int32_t x) const { return &mColumns[(size_t(x) + 1) * mColumnWords]; }
+
+size_t GridMap::row_words() const { return mRowWords; }
+
+size_t GridMap::column_words() const { return mColumnWords; }
+
+void GridMap::set_bit(int32_t x, int32_t y, bool block) {
+    uint64_t& r = mRows[(size_t(y) + 1) * mRowWords + (x >> 6)];
+    uint64_t& c = mColumns[(size_t(x) + 1) * mColumnWords + (y >> 6)];
+    if (block) {
+        r |= uint64_t(1) << (x & 63);
+        c |= uint64_t(1) << (y & 63);
+    } else {
+        r &= ~(uint64_t(1) << (x & 63));
+        c &= ~(uint64_t(1) << (y & 63));
+    }
+}
+
+void GridMap::touch() { mStamp = sGridMapStamp.fetch_add(1, std::memory_order_relaxed) + 1; }
+
+}  // namespace PureCore
@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "PureCore/CoreErrorDesc.h"
+#include "PureCore/HeapTimer.h"
+
+namespace PureCore {
+HeapTimer::HeapTimer() : mNow(0), mHeap(), mTimers(), mIDGen() {}
+
+HeapTimer::~HeapTimer() { release(); }
+
+void HeapTimer::init() {
+    release();
+    mNow = 0;
+}
+
+void HeapTimer::release() {
+    mNow = 0;
+    mHeap.clear();
+    mGroups.clear();
+    for (auto iter = mTimers.begin(); iter != mTimers.end(); ++iter) {
+        mPool.free(iter->second);
+    }
+    mTimers.clear();
+}
+
+void HeapTimer::update(int64_t delta) {
+    if (delta <= 0) {
+        return;
+    }
+
+    mNow += delta;
+    while (!mHeap.empty() && mHeap.front().mNextTime <= mNow && mHeap.front().mTimer->get_left_times() != 0) {
+        HeapTimerNode* node = mHeap.front().mTimer;
+        remove_heap_node(node);
+        node->time_out();
+        if (node->get_left_times() == 0) {
+            remove_timer(node->get_timer_id());
+        } else {
+            node->next_time(mNow);
+            add_heap_node(node);
+        }
+    }
+}
+
+int64_t HeapTimer::add_timer(int32_t timerType, int64_t startTime, int64_t interval, int64_t times, TimerCallback callback, bool nextFromNow,
+                             int64_t owner) {
+    if (callback == nullptr || times == 0 || startTime + interval <= 0) {
+        return 0;
+    }
+    int64_t timerID = mIDGen.gen_id();
+    HeapTimerNode* timer = mPool.get();
+    int err = timer->init(timerID, timerType, mNow + startTime, interval, times, std::move(callback), nextFromNow);
+    if (err != Success) {
+        mPool.free(timer);
+        return 0;
+    }
+
+    if (!mTimers.insert(std::make_pair(timer->get_timer_id(), timer)).second) {
+        mPool.free(timer);
+        return 0;
+    }
+
+    mGroups.add(timer, owner);
+    add_heap_node(timer);
+    return timer->get_timer_id();
+}
+
+bool HeapTimer::remove_timer(int64_t timerID) {
+    auto iter = mTimers.find(timerID);
+    if (iter == mTimers.end()) {
+        return false;
+    }
+    HeapTimerNode* timer = iter->second;
+    if (timer->remove_if_calling()) {
+        return true;
+    }
+    mTimers.erase(iter);
+    mGroups.remove(timer);
+    remove_heap_node(timer);
+    mPool.free(timer);
+    return true;
+}
+
+void HeapTimer::clear_timer() {
+    mGroups.clear();
+    for (auto iter = mTimers.begin(); iter != mTimers.end();) {
+        mPool.free(iter->second);
+        iter = mTimers.erase(iter);
+    }
+    mHeap.clear();
+}
+
+size_t HeapTimer::remove_group(int64_t owner) {
+    size_t count = 0;
+    TimerNode* timer = mGroups.get_front(owner);
+    while (timer != nullptr) {
+        TimerNode* next = timer->get_group_next();
+        ++count;
+        // calling timer is removed after callback return
+        if (!timer->remove_if_calling()) {
+            mGroups.remove(timer);
+            mTimers.erase(timer->get_timer_id());
+            remove_heap_node(static_cast<HeapTimerNode*>(timer));
+            mPool.free(static_cast<HeapTimerNode*>(timer));
+        }
+        timer = next;
+    }
+    return count;
+}
+
+size_t HeapTimer::get_group_count(int64_t owner) const { return mGroups.get_count(owner); }
+
+void HeapTimer::add_heap_node(HeapTimerNode* timer) {
+    mHeap.push_back(HeapEntry{timer->get_next_time(), timer});
+    timer->mHeapIndex = mHeap.size() - 1;
+    sift_up(timer->mHeapIndex);
+}
+
+void HeapTimer::remove_heap_node(HeapTimerNode* timer) {
+    size_t index = timer->mHeapIndex;
+    if (index >= mHeap.size() || mHeap[index].mTimer != timer) {
+        return;
+    }
+    timer->mHeapIndex = InvalidIndex;
+    HeapEntry last = mHeap.back();
+    mHeap.pop_back();
+    if (index == mHeap.size()) {
+        return;
+    }
+    set_heap_node(index, last);
+    sift_down(index);
+    sift_up(last.mTimer->mHeapIndex);
+}
+
+void HeapTimer::sift_up(size_t index) {
+    HeapEntry timer = mHeap[index];
+    while (index > 0) {
+        size_t parent = (index - 1) / HeapArity;
+        if (!is_before(timer, mHeap[parent])) {
+            break;
+        }
+        set_heap_node(index, mHeap[parent]);
+        index = parent;
+    }
+    set_heap_node(index, timer);
+}
+
+void HeapTimer::sift_down(size_t index) {
+    HeapEntry timer = mHeap[index];
+    size_t size = mHeap.size();
+    while (true) {
+        size_t first = index * HeapArity + 1;
+        if (first >= size) {
+            break;
+        }
+        size_t last = first + HeapArity < size ? first + HeapArity : size;
+        size_t child = first;
+        for (size_t i = first + 1; i < last; ++i) {
+            if (is_before(mHeap[i], mHeap[child])) {
+                child = i;
+            }
+        }
+        if (!is_before(mHeap[child], timer)) {
+            break;
+        }
+        set_heap_node(index, mHeap[child]);
+        index = child;
+    }
+    set_heap_node(index, timer);
+}
+
+void HeapTimer::set_heap_node(size_t index, const HeapEntry& entry) {
+    mHeap[index] = entry;
+    entry.mTimer->mHeapIndex = index;
+}
+
+bool HeapTimer::is_before(const HeapEntry& a, const HeapEntry& b) {
+    // same time is fired by add order
+    if (a.mNextTime != b.mNextTime) {
+        return a.mNextTime < b.mNextTime;
+    }
+    return a.mTimer->get_timer_id() < b.mTimer->get_timer_id();
+}
+
+}  // namespace PureCore
@@ -31,21 +31,17 @@ namespace PureCore {
 // FixedAllocator
 ///////////////////////////////////////////////////////////////
 FixedAllocator::FixedAllocator(size_t blockSize, uint8_t countBlocks)
-    : mBlockSize(blockSize), mCountBlocks(countBlocks), mFullCount(0u), mEmptyCount(0u), mFullList(), mFreeList(), mEmptyList() {}
+    : mBlockSize(blockSize), mCountBlocks(countBlocks), mFullCount(0u), mEmptyCount(0u), mFullList(), mFreeList(), mEmptyList(), mStat(nullptr) {}
 
 FixedAllocator::~FixedAllocator() {
-    MemoryChunk *pChunk = nullptr;
     while (mFullList.get_front() != nullptr) {
-        pChunk = mFullList.pop_front_t<MemoryChunk>();
-        delete pChunk;
+        destroy_chunk(mFullList.pop_front_t<MemoryChunk>());
     }
     while (mFreeList.get_front() != nullptr) {
-        pChunk = mFreeList.pop_front_t<MemoryChunk>();
-        delete pChunk;
+        destroy_chunk(mFreeList.pop_front_t<MemoryChunk>());
     }
     while (mEmptyList.get_front() != nullptr) {
-        pChunk = mEmptyList.pop_front_t<MemoryChunk>();
-        delete pChunk;
+        destroy_chunk(mEmptyList.pop_front_t<MemoryChunk>());
     }
 
     mFullList.clear();
@@ -77,6 +73,10 @@ void *FixedAllocator::allocate() {
     if (p == nullptr) {
         return p;
     }
+    if (mStat != nullptr) {
+        mStat->add_allocated(1);
+        mStat->add_free(-1);
+    }
     if (emptyBefore) {  // before empty
         pChunk->leave();
         mFreeList.push_back(pChunk);
@@ -103,9 +103,22 @@ int FixedAllocator::create_chunk() {
 
     ++mEmptyCount;
     mEmptyList.push_back(pChunk);
+    if (mStat != nullptr) {
+        mStat->add_chunks(1, int64_t(mBlockSize * mCountBlocks + sizeof(MemoryChunk)));
+        mStat->add_free(mCountBlocks);
+    }
     return Success;
 }
 
+void FixedAllocator::destroy_chunk(MemoryChunk *pChunk) {
+    if (mStat != nullptr) {
+        mStat->add_chunks(-1, -int64_t(mBlockSize * mCountBlocks + sizeof(MemoryChunk)));
+        mStat->add_free(-int64_t(pChunk->free_count()));
+        mStat->add_allocated(int64_t(pChunk->free_count()) - mCountBlocks);
+    }
+    delete pChunk;
+}
+
 void FixedAllocator::deallocate(void *p) {
     MemoryChunk *pChunk = MemoryChunk::self(p, mBlockSize);
     if (pChunk == nullptr) {
@@ -117,6 +130,10 @@ void FixedAllocator::deallocate(void *p) {
         PureError("FixedAllocator::deallocate failed {}", get_error_desc(err));
         return;
     }
+    if (mStat != nullptr) {
+        mStat->add_allocated(-1);
+        mStat->add_free(1);
+    }
     if (fullBefore) {  // full before
         pChunk->leave();
         mFreeList.push_back(pChunk);
@@ -133,18 +150,20 @@ size_t FixedAllocator::get_full_count() const { return mFullCount; }
 
 size_t FixedAllocator::get_empty_count() const { return mEmptyCount; }
 
+void FixedAllocator::set_stat(PoolStat *stat) { mStat = stat; }
+
 void FixedAllocator::gc(bool all) {
     if (all) {
-        MemoryChunk *pChunk = mEmptyList.get_front_t<MemoryChunk>();
+        MemoryChunk *pChunk = mEmptyList.pop_front_t<MemoryChunk>();
         while (pChunk != nullptr) {
-            delete pChunk;
+            destroy_chunk(pChunk);
             --mEmptyCount;
-            pChunk = mEmptyList.get_front_t<MemoryChunk>();
+            pChunk = mEmptyList.pop_front_t<MemoryChunk>();
         }
     } else {
         MemoryChunk *pChunk = mEmptyList.pop_front_t<MemoryChunk>();
         if (pChunk != nullptr) {
-            delete pChunk;
+            destroy_chunk(pChunk);
             --mEmptyCount;
         }
     }
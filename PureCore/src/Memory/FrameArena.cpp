@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "PureCore/CoreErrorDesc.h"
+#include "PureCore/Memory/FrameArena.h"
+#include "PureCore/Buffer/ArenaBuffer.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+namespace PureCore {
+//////////////////////////////////////////////////////////////
+// FrameArena
+/////////////////////////////////////////////////////////////
+FrameArena::FrameArena(size_t blockSize)
+    : mBlock(nullptr), mBlockSize(blockSize), mUsed(0), mCapacity(0), mHighWater(0), mFrame(0), mLast(nullptr) {
+    if (mBlockSize < 1024) {
+        mBlockSize = 1024;
+    }
+}
+
+FrameArena::~FrameArena() { release(); }
+
+void* FrameArena::allocate(size_t size, size_t align) {
+    if (size == 0) {
+        size = 1;
+    }
+    if (align == 0 || (align & (align - 1)) != 0) {
+        align = DefaultAlign;
+    }
+    if (mBlock != nullptr) {
+        uintptr_t cur = reinterpret_cast<uintptr_t>(block_data(mBlock) + mBlock->mUsed);
+        uintptr_t aligned = (cur + align - 1) & ~(uintptr_t(align) - 1);
+        if (aligned + size <= reinterpret_cast<uintptr_t>(block_data(mBlock) + mBlock->mSize)) {
+            size_t used = aligned - cur + size;
+            mBlock->mUsed += used;
+            mUsed += used;
+            mLast = reinterpret_cast<uint8_t*>(aligned);
+            return mLast;
+        }
+    }
+    size_t blockSize = size + align > mBlockSize ? size + align : mBlockSize;
+    Block* block = new_block(blockSize);
+    if (block == nullptr) {
+        return nullptr;
+    }
+    block->mNext = mBlock;
+    mBlock = block;
+    return allocate(size, align);
+}
+
+void* FrameArena::reallocate(void* p, size_t osize, size_t nsize, size_t align) {
+    if (p == nullptr) {
+        return allocate(nsize, align);
+    }
+    if (nsize <= osize) {
+        return p;
+    }
+    uint8_t* real = static_cast<uint8_t*>(p);
+    if (real == mLast && mBlock != nullptr && real + nsize <= block_data(mBlock) + mBlock->mSize) {
+        mBlock->mUsed += nsize - osize;
+        mUsed += nsize - osize;
+        return p;
+    }
+    void* np = allocate(nsize, align);
+    if (np == nullptr) {
+        return nullptr;
+    }
+    memcpy(np, p, osize);
+    return np;
+}
+
+ArenaBuffer* FrameArena::new_buffer(size_t size) {
+    void* p = allocate(sizeof(ArenaBuffer), alignof(ArenaBuffer));
+    if (p == nullptr) {
+        return nullptr;
+    }
+    ArenaBuffer* buffer = new (p) ArenaBuffer(*this);
+    if (size > 0 && buffer->resize_buffer(size) != Success) {
+        return nullptr;
+    }
+    return buffer;
+}
+
+void FrameArena::reset() {
+    if (mUsed > mHighWater) {
+        mHighWater = mUsed;
+    }
+    if (mBlock != nullptr && mBlock->mNext != nullptr) {
+        size_t capacity = mCapacity;
+        free_blocks();
+        mBlock = new_block(capacity);
+    } else if (mBlock != nullptr) {
+        mBlock->mUsed = 0;
+    }
+    mUsed = 0;
+    mLast = nullptr;
+    ++mFrame;
+}
+
+void FrameArena::release() {
+    free_blocks();
+    ++mFrame;
+}
+
+void FrameArena::free_blocks() {
+    while (mBlock != nullptr) {
+        Block* next = mBlock->mNext;
+        ::free(mBlock);
+        mBlock = next;
+    }
+    mUsed = 0;
+    mCapacity = 0;
+    mLast = nullptr;
+}
+
+size_t FrameArena::get_used() const { return mUsed; }
+
+size_t FrameArena::get_capacity() const { return mCapacity; }
+
+size_t FrameArena::get_high_water() const { return mUsed > mHighWater ? mUsed : mHighWater; }
+
+uint64_t FrameArena::get_frame() const { return mFrame; }
+
+FrameArena::Block* FrameArena::new_block(size_t size) {
+    size_t total = sizeof(Block) + DefaultAlign + size;
+    Block* block = static_cast<Block*>(::malloc(total));
+    if (block == nullptr) {
+        return nullptr;
+    }
+    block->mNext = nullptr;
+    block->mSize = total - (block_data(block) - reinterpret_cast<uint8_t*>(block));
+    block->mUsed = 0;
+    mCapacity += block->mSize;
+    return block;
+}
+
+uint8_t* FrameArena::block_data(Block* block) {
+    uintptr_t p = reinterpret_cast<uintptr_t>(block) + sizeof(Block);
+    return reinterpret_cast<uint8_t*>((p + DefaultAlign - 1) & ~uintptr_t(DefaultAlign - 1));
+}
+
+}  // namespace PureCore
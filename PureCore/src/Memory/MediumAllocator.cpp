@@ -0,0 +1,439 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "PureCore/CoreErrorDesc.h"
+#include "PureCore/PureLog.h"
+#include "PureCore/Memory/MediumAllocator.h"
+
+#include <new>
+#include <string.h>
+
+namespace PureCore {
+static_assert((MediumAllocator::MinSize & (MediumAllocator::MinSize - 1)) == 0, "PURE_BIG_SIZE must be power of 2");
+static_assert(MediumAllocator::MinSize < MediumAllocator::SpanMaxSize, "PURE_BIG_SIZE too big for MediumAllocator");
+static_assert(MediumAllocator::MaxSize <= MediumAllocator::SegmentSize / 2, "PURE_MEDIUM_SIZE too big for MediumAllocator");
+
+//////////////////////////////////////////////////////////////
+// MediumSpan
+/////////////////////////////////////////////////////////////
+// page run in segment, a span of size class carves blocks from the pages, a page run span is one medium object
+struct MediumSpan : public Node {
+    MediumSpan() = default;
+    ~MediumSpan() override { leave(); }
+
+    uint8_t* mFreeBlock = nullptr;  // free block list
+    size_t mBlockSize = 0;          // block size, 0 is page run
+    uint16_t mStart = 0;            // start page in segment
+    uint16_t mPages = 0;            // page count, 0 is unused
+    uint16_t mBlockCount = 0;       // block count
+    uint16_t mFreeCount = 0;        // free block count
+    uint16_t mCarved = 0;           // blocks ever used, blocks after it are never touched
+    uint16_t mClass = 0;            // size class
+};
+
+//////////////////////////////////////////////////////////////
+// MediumSegment
+/////////////////////////////////////////////////////////////
+// header at the front of segment memory, segment is aligned by segment size
+class MediumSegment {
+public:
+    enum ESizeConst {
+        Pages = MediumAllocator::SegmentPages,
+        Words = Pages / 64,
+    };
+
+public:
+    MediumSegment();
+    ~MediumSegment() = default;
+
+    uint8_t* page(uint32_t index) { return reinterpret_cast<uint8_t*>(this) + (size_t(index) << MediumAllocator::PageBit); }
+    bool empty() const { return mFreePages == Pages - head_pages(); }
+
+    int find_pages(uint32_t count) const;
+    bool is_free(uint32_t start, uint32_t count) const;
+    void use_pages(uint32_t start, uint32_t count, uint16_t owner);
+    void free_pages(uint32_t start, uint32_t count);
+
+    static MediumSegment* self(void* p);
+    static uint32_t head_pages();
+
+public:
+    uint64_t mFreeBitmap[Words];  // free page bitmap, 1 is free
+    uint16_t mPageSpan[Pages];    // start page of the span owns the page
+    MediumSpan mSpans[Pages];     // span indexed by start page
+    uint32_t mFreePages;          // free page count
+
+    PURE_DISABLE_COPY(MediumSegment)
+};
+
+MediumSegment::MediumSegment() : mFreePages(Pages) {
+    memset(mFreeBitmap, 0xff, sizeof(mFreeBitmap));
+    memset(mPageSpan, 0, sizeof(mPageSpan));
+    use_pages(0, head_pages(), 0);
+    mFreePages = Pages - head_pages();
+}
+
+int MediumSegment::find_pages(uint32_t count) const {
+    uint32_t run = 0;
+    for (uint32_t i = head_pages(); i < Pages; ++i) {
+        uint64_t word = mFreeBitmap[i >> 6];
+        if (word == 0) {
+            run = 0;
+            i |= 63;
+            continue;
+        }
+        if ((word >> (i & 63)) & 1) {
+            if (++run == count) {
+                return int(i + 1 - count);
+            }
+        } else {
+            run = 0;
+        }
+    }
+    return -1;
+}
+
+bool MediumSegment::is_free(uint32_t start, uint32_t count) const {
+    if (start + count > Pages) {
+        return false;
+    }
+    for (uint32_t i = start; i < start + count; ++i) {
+        if (((mFreeBitmap[i >> 6] >> (i & 63)) & 1) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void MediumSegment::use_pages(uint32_t start, uint32_t count, uint16_t owner) {
+    for (uint32_t i = start; i < start + count; ++i) {
+        mFreeBitmap[i >> 6] &= ~(uint64_t(1) << (i & 63));
+        mPageSpan[i] = owner;
+    }
+    mFreePages -= count;
+}
+
+void MediumSegment::free_pages(uint32_t start, uint32_t count) {
+    for (uint32_t i = start; i < start + count; ++i) {
+        mFreeBitmap[i >> 6] |= uint64_t(1) << (i & 63);
+    }
+    mFreePages += count;
+}
+
+MediumSegment* MediumSegment::self(void* p) {
+    return reinterpret_cast<MediumSegment*>(reinterpret_cast<uintptr_t>(p) & ~uintptr_t(MediumAllocator::SegmentSize - 1));
+}
+
+uint32_t MediumSegment::head_pages() { return uint32_t((sizeof(MediumSegment) + MediumAllocator::PageSize - 1) >> MediumAllocator::PageBit); }
+
+//////////////////////////////////////////////////////////////
+// MediumAllocator
+/////////////////////////////////////////////////////////////
+MediumAllocator::MediumAllocator() : mSegments(), mEmptySegments(0), mStat(nullptr) {}
+
+MediumAllocator::~MediumAllocator() {
+    while (!mSegments.empty()) {
+        delete_segment(mSegments.size() - 1);
+    }
+}
+
+void* MediumAllocator::allocate(size_t size) {
+    if (size > MaxSize) {
+        return nullptr;
+    }
+    if (size <= SpanMaxSize) {
+        return allocate_block(class_index(size));
+    }
+    return allocate_run(size);
+}
+
+void MediumAllocator::deallocate(void* p, size_t size) {
+    if (p == nullptr) {
+        return;
+    }
+    MediumSpan* span = span_of(p);
+    if (span->mPages == 0) {
+        PureError("MediumAllocator::deallocate `{}` size {} failed, not found span", p, size);
+        return;
+    }
+    if (span->mBlockSize != 0) {
+        deallocate_block(span, p);
+    } else {
+        deallocate_run(span);
+    }
+}
+
+void* MediumAllocator::reallocate(void* p, size_t osize, size_t nsize) {
+    if (p == nullptr) {
+        return allocate(nsize);
+    }
+    if (nsize == 0) {
+        deallocate(p, osize);
+        return nullptr;
+    }
+    MediumSpan* span = span_of(p);
+    if (span->mBlockSize != 0) {
+        if (nsize <= SpanMaxSize && class_index(nsize) == span->mClass) {
+            return p;
+        }
+    } else if (nsize > SpanMaxSize && nsize <= MaxSize && resize_run(span, nsize)) {
+        return p;
+    }
+
+    void* np = allocate(nsize);
+    if (np == nullptr) {
+        return nullptr;
+    }
+    memcpy(np, p, osize < nsize ? osize : nsize);
+    deallocate(p, osize);
+    return np;
+}
+
+size_t MediumAllocator::get_segment_count() const { return mSegments.size(); }
+
+void MediumAllocator::gc(bool all) {
+    // release the empty span kept by every size class
+    for (size_t i = 0; i < ClassCount; ++i) {
+        for (NodeIter iter = mPartial[i].begin(); iter != mPartial[i].end();) {
+            MediumSpan* span = iter->cast<MediumSpan>();
+            ++iter;
+            if (span->mFreeCount == span->mBlockCount) {
+                span->leave();
+                if (mStat != nullptr) {
+                    mStat->add_free(-int64_t(span->mBlockCount));
+                }
+                delete_span(span);
+            }
+        }
+    }
+    if (all) {
+        for (size_t i = mSegments.size(); i > 0; --i) {
+            if (mSegments[i - 1]->empty()) {
+                delete_segment(i - 1);
+            }
+        }
+    }
+}
+
+void MediumAllocator::set_stat(PoolStat* stat) { mStat = stat; }
+
+size_t MediumAllocator::class_index(size_t size) {
+    if (size <= MinSize) {
+        return 0;
+    }
+    uint32_t minBit = bit_log2(MinSize);
+    uint32_t bit = minBit;
+    while (((size - 1) >> (bit + 1)) != 0) {
+        ++bit;
+    }
+    size_t base = size_t(1) << bit;
+    return (size_t(bit - minBit) << ClassStepBit) + ((size - 1 - base) >> (bit - ClassStepBit));
+}
+
+size_t MediumAllocator::class_size(size_t index) {
+    uint32_t bit = bit_log2(MinSize) + uint32_t(index >> ClassStepBit);
+    size_t step = (index & ((size_t(1) << ClassStepBit) - 1)) + 1;
+    return (size_t(1) << bit) + (step << (bit - ClassStepBit));
+}
+
+void* MediumAllocator::allocate_block(size_t index) {
+    MediumSpan* span = mPartial[index].get_front_t<MediumSpan>();
+    if (span == nullptr) {
+        size_t blockSize = class_size(index);
+        uint32_t pages = uint32_t((blockSize * SpanMinBlocks + PageSize - 1) >> PageBit);
+        span = new_span(pages);
+        if (span == nullptr) {
+            return nullptr;
+        }
+        span->mBlockSize = blockSize;
+        span->mClass = uint16_t(index);
+        span->mBlockCount = uint16_t((size_t(pages) << PageBit) / blockSize);
+        span->mFreeCount = span->mBlockCount;
+        span->mCarved = 0;
+        span->mFreeBlock = nullptr;
+        mPartial[index].push_back(span);
+        if (mStat != nullptr) {
+            mStat->add_free(span->mBlockCount);
+        }
+    }
+
+    uint8_t* p = span->mFreeBlock;
+    if (p != nullptr) {
+        memcpy(&span->mFreeBlock, p, sizeof(p));
+    } else {
+        p = MediumSegment::self(span)->page(span->mStart) + span->mCarved * span->mBlockSize;
+        ++span->mCarved;
+    }
+    if (--span->mFreeCount == 0) {  // now full
+        span->leave();
+    }
+    if (mStat != nullptr) {
+        mStat->add_allocated(1);
+        mStat->add_free(-1);
+    }
+    return p;
+}
+
+void MediumAllocator::deallocate_block(MediumSpan* span, void* p) {
+    uint8_t* block = static_cast<uint8_t*>(p);
+    uint8_t* data = MediumSegment::self(span)->page(span->mStart);
+    if (block < data || size_t(block - data) % span->mBlockSize != 0 || size_t(block - data) / span->mBlockSize >= span->mCarved) {
+        PureError("MediumAllocator::deallocate_block failed {}", get_error_desc(ErrorInvalidMemory));
+        return;
+    }
+    memcpy(block, &span->mFreeBlock, sizeof(block));
+    span->mFreeBlock = block;
+    NodeList& list = mPartial[span->mClass];
+    if (span->mFreeCount++ == 0) {  // full before
+        list.push_back(span);
+    }
+    if (mStat != nullptr) {
+        mStat->add_allocated(-1);
+        mStat->add_free(1);
+    }
+    // keep the only span of the class to avoid map and unmap repeatedly
+    if (span->mFreeCount == span->mBlockCount && (list.get_front() != span || list.get_back() != span)) {
+        span->leave();
+        if (mStat != nullptr) {
+            mStat->add_free(-int64_t(span->mBlockCount));
+        }
+        delete_span(span);
+    }
+}
+
+void* MediumAllocator::allocate_run(size_t size) {
+    MediumSpan* span = new_span(uint32_t((size + PageSize - 1) >> PageBit));
+    if (span == nullptr) {
+        return nullptr;
+    }
+    span->mBlockSize = 0;
+    if (mStat != nullptr) {
+        mStat->add_allocated(1);
+    }
+    return MediumSegment::self(span)->page(span->mStart);
+}
+
+void MediumAllocator::deallocate_run(MediumSpan* span) {
+    if (mStat != nullptr) {
+        mStat->add_allocated(-1);
+    }
+    delete_span(span);
+}
+
+bool MediumAllocator::resize_run(MediumSpan* span, size_t size) {
+    MediumSegment* seg = MediumSegment::self(span);
+    uint32_t pages = uint32_t((size + PageSize - 1) >> PageBit);
+    if (pages < span->mPages) {
+        seg->free_pages(span->mStart + pages, span->mPages - pages);
+        span->mPages = uint16_t(pages);
+        return true;
+    }
+    if (pages > span->mPages) {
+        uint32_t end = span->mStart + span->mPages;
+        if (!seg->is_free(end, pages - span->mPages)) {
+            return false;
+        }
+        seg->use_pages(end, pages - span->mPages, span->mStart);
+        span->mPages = uint16_t(pages);
+    }
+    return true;
+}
+
+MediumSpan* MediumAllocator::new_span(uint32_t pages) {
+    MediumSegment* seg = nullptr;
+    int start = -1;
+    for (size_t i = 0; i < mSegments.size(); ++i) {
+        if (mSegments[i]->mFreePages < pages) {
+            continue;
+        }
+        start = mSegments[i]->find_pages(pages);
+        if (start >= 0) {
+            seg = mSegments[i];
+            break;
+        }
+    }
+    if (seg == nullptr) {
+        bool hugePage = false;
+        void* mem = map_aligned_pages(SegmentSize, hugePage);
+        if (mem == nullptr) {
+            PureError("MediumAllocator::new_span failed {}", get_error_desc(ErrorAllocMemoryFailed));
+            return nullptr;
+        }
+        seg = new (mem) MediumSegment();
+        mSegments.push_back(seg);
+        ++mEmptySegments;
+        start = int(MediumSegment::head_pages());
+        if (mStat != nullptr) {
+            mStat->add_chunks(1, SegmentSize);
+        }
+    }
+    if (seg->empty()) {
+        --mEmptySegments;
+    }
+    seg->use_pages(uint32_t(start), pages, uint16_t(start));
+    MediumSpan* span = &seg->mSpans[start];
+    span->mStart = uint16_t(start);
+    span->mPages = uint16_t(pages);
+    return span;
+}
+
+void MediumAllocator::delete_span(MediumSpan* span) {
+    MediumSegment* seg = MediumSegment::self(span);
+    seg->free_pages(span->mStart, span->mPages);
+    span->mPages = 0;
+    span->mBlockSize = 0;
+    span->mFreeBlock = nullptr;
+    if (!seg->empty()) {
+        return;
+    }
+    // keep one empty segment
+    if (++mEmptySegments > 1) {
+        for (size_t i = 0; i < mSegments.size(); ++i) {
+            if (mSegments[i] == seg) {
+                delete_segment(i);
+                break;
+            }
+        }
+    }
+}
+
+void MediumAllocator::delete_segment(size_t index) {
+    MediumSegment* seg = mSegments[index];
+    if (seg->empty()) {
+        --mEmptySegments;
+    }
+    mSegments[index] = mSegments.back();
+    mSegments.pop_back();
+    seg->~MediumSegment();
+    unmap_aligned_pages(seg, SegmentSize);
+    if (mStat != nullptr) {
+        mStat->add_chunks(-1, -int64_t(SegmentSize));
+    }
+}
+
+MediumSpan* MediumAllocator::span_of(void* p) {
+    MediumSegment* seg = MediumSegment::self(p);
+    size_t page = (reinterpret_cast<uint8_t*>(p) - reinterpret_cast<uint8_t*>(seg)) >> PageBit;
+    return &seg->mSpans[seg->mPageSpan[page]];
+}
+
+}  // namespace PureCore
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "PureCore/Memory/PageMemory.h"
+
+#ifdef _WIN32
+#include <malloc.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace PureCore {
+#ifdef _WIN32
+void* map_aligned_pages(size_t size, bool& hugePage) {
+    hugePage = false;
+    return _aligned_malloc(size, size);
+}
+
+void unmap_aligned_pages(void* p, size_t) { _aligned_free(p); }
+#else
+static void* map_aligned(size_t size, int flags) {
+    // map double size, then unmap head and tail to align by size
+    uint8_t* p = static_cast<uint8_t*>(::mmap(nullptr, size * 2, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0));
+    if (p == MAP_FAILED) {
+        return nullptr;
+    }
+    size_t head = (size - (reinterpret_cast<uintptr_t>(p) & (size - 1))) & (size - 1);
+    if (head > 0) {
+        ::munmap(p, head);
+    }
+    ::munmap(p + head + size, size - head);
+    return p + head;
+}
+
+void* map_aligned_pages(size_t size, bool& hugePage) {
+    void* p = nullptr;
+#ifdef MAP_HUGETLB
+    if (hugePage) {
+        p = map_aligned(size, MAP_HUGETLB);
+        if (p != nullptr) {
+            return p;
+        }
+    }
+#endif
+    p = map_aligned(size, 0);
+#ifdef MADV_HUGEPAGE
+    if (p != nullptr && hugePage) {
+        ::madvise(p, size, MADV_HUGEPAGE);
+    }
+#endif
+    hugePage = false;
+    return p;
+}
+
+void unmap_aligned_pages(void* p, size_t size) { ::munmap(p, size); }
+#endif
+
+}  // namespace PureCore
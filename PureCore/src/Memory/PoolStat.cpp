@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "PureCore/PureLog.h"
+#include "PureCore/Memory/PoolStat.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace PureCore {
+//////////////////////////////////////////////////////////////
+// PoolStat
+/////////////////////////////////////////////////////////////
+PoolStat::PoolStat(const char* name) : mName(name != nullptr ? name : "") { PoolRegistry::inst()->add(this); }
+
+PoolStat::~PoolStat() { PoolRegistry::inst()->remove(this); }
+
+PoolStatInfo PoolStat::info() const {
+    PoolStatInfo info;
+    info.mName = mName;
+    info.mAllocated = mAllocated.load(std::memory_order_relaxed);
+    info.mFree = mFree.load(std::memory_order_relaxed);
+    info.mChunks = mChunks.load(std::memory_order_relaxed);
+    info.mBytes = mBytes.load(std::memory_order_relaxed);
+    info.mHit = mHit.load(std::memory_order_relaxed);
+    info.mMiss = mMiss.load(std::memory_order_relaxed);
+    info.mHighWater = mHighWater.load(std::memory_order_relaxed);
+    info.mInstances = 1;
+    return info;
+}
+
+//////////////////////////////////////////////////////////////
+// PoolRegistry
+/////////////////////////////////////////////////////////////
+// never destroy, thread local pools may destroy after static destroy
+PoolRegistry* PoolRegistry::inst() {
+    static PoolRegistry* sInst = new PoolRegistry();
+    return sInst;
+}
+
+void PoolRegistry::add(PoolStat* stat) {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mStats.push_back(stat);
+}
+
+void PoolRegistry::remove(PoolStat* stat) {
+    std::unique_lock<std::mutex> lock(mMutex);
+    auto iter = std::find(mStats.begin(), mStats.end(), stat);
+    if (iter != mStats.end()) {
+        *iter = mStats.back();
+        mStats.pop_back();
+    }
+}
+
+std::vector<PoolStatInfo> PoolRegistry::get_stats() const {
+    std::vector<PoolStatInfo> stats;
+    std::unordered_map<std::string, size_t> indexes;
+    std::unique_lock<std::mutex> lock(mMutex);
+    for (PoolStat* stat : mStats) {
+        auto iter = indexes.find(stat->name());
+        if (iter == indexes.end()) {
+            indexes.emplace(stat->name(), stats.size());
+            stats.push_back(stat->info());
+            continue;
+        }
+        PoolStatInfo info = stat->info();
+        PoolStatInfo& merged = stats[iter->second];
+        merged.mAllocated += info.mAllocated;
+        merged.mFree += info.mFree;
+        merged.mChunks += info.mChunks;
+        merged.mBytes += info.mBytes;
+        merged.mHit += info.mHit;
+        merged.mMiss += info.mMiss;
+        merged.mHighWater += info.mHighWater;
+        merged.mInstances += info.mInstances;
+    }
+    lock.unlock();
+    std::sort(stats.begin(), stats.end(), [](const PoolStatInfo& a, const PoolStatInfo& b) { return a.mBytes > b.mBytes; });
+    return stats;
+}
+
+void PoolRegistry::dump() const {
+    std::vector<PoolStatInfo> stats = get_stats();
+    for (const PoolStatInfo& info : stats) {
+        PureInfo("pool {} instances {} allocated {} free {} chunks {} bytes {} hit {} miss {} high water {}", info.mName, info.mInstances, info.mAllocated,
+                 info.mFree, info.mChunks, info.mBytes, info.mHit, info.mMiss, info.mHighWater);
+    }
+}
+
+}  // namespace PureCore
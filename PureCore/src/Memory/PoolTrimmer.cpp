@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "PureCore/Memory/PoolTrimmer.h"
+
+namespace PureCore {
+//////////////////////////////////////////////////////////////
+// PoolTrimmer
+/////////////////////////////////////////////////////////////
+static thread_local NodeList tlTrimmers;
+
+PoolTrimmer::PoolTrimmer() : Node(), mAttached(false) {}
+
+PoolTrimmer::~PoolTrimmer() { leave(); }
+
+void PoolTrimmer::trim_thread(int64_t elapsed) {
+    for (NodeIter iter = tlTrimmers.begin(); iter != tlTrimmers.end(); ++iter) {
+        iter->cast<PoolTrimmer>()->trim(elapsed);
+    }
+}
+
+void PoolTrimmer::attach_thread() {
+    tlTrimmers.push_back(this);
+    mAttached = true;
+}
+
+}  // namespace PureCore
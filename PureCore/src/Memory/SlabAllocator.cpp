@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "PureCore/CoreErrorDesc.h"
+#include "PureCore/PureLog.h"
+#include "PureCore/Memory/SlabChunk.h"
+#include "PureCore/Memory/SlabAllocator.h"
+
+namespace PureCore {
+
+////////////////////////////////////////////////////////////////
+// SlabAllocator
+///////////////////////////////////////////////////////////////
+SlabAllocator::SlabAllocator(size_t blockSize, size_t chunkSize, bool hugePage)
+    : mBlockSize(blockSize),
+      mChunkSize(MinChunkSize),
+      mCountBlocks(0),
+      mHugePage(hugePage),
+      mFullCount(0u),
+      mEmptyCount(0u),
+      mFullList(),
+      mFreeList(),
+      mEmptyList(),
+      mStat(nullptr) {
+    if (mBlockSize == 0) {
+        mBlockSize = 1;
+    }
+    if (mHugePage && chunkSize < HugePageSize) {
+        chunkSize = HugePageSize;
+    }
+    while (mChunkSize < chunkSize) {
+        mChunkSize <<= 1;
+    }
+    mCountBlocks = SlabChunk::calc_block_count(mBlockSize, mChunkSize);
+    while (mCountBlocks < MinChunkBlocks) {
+        mChunkSize <<= 1;
+        mCountBlocks = SlabChunk::calc_block_count(mBlockSize, mChunkSize);
+    }
+}
+
+SlabAllocator::~SlabAllocator() {
+    while (mFullList.get_front() != nullptr) {
+        destroy_chunk(mFullList.pop_front_t<SlabChunk>());
+    }
+    while (mFreeList.get_front() != nullptr) {
+        destroy_chunk(mFreeList.pop_front_t<SlabChunk>());
+    }
+    while (mEmptyList.get_front() != nullptr) {
+        destroy_chunk(mEmptyList.pop_front_t<SlabChunk>());
+    }
+
+    mFullList.clear();
+    mFreeList.clear();
+    mEmptyList.clear();
+    mFullCount = 0u;
+    mEmptyCount = 0u;
+}
+
+void *SlabAllocator::allocate() {
+    SlabChunk *pChunk = nullptr;
+    if (mFreeList.empty()) {
+        if (mEmptyList.empty()) {
+            int err = create_chunk();
+            if (err != Success) {
+                return nullptr;
+            }
+        }
+        pChunk = mEmptyList.get_front_t<SlabChunk>();
+    } else {
+        pChunk = mFreeList.get_front_t<SlabChunk>();
+    }
+    if (pChunk == nullptr) {
+        return nullptr;
+    }
+
+    bool emptyBefore = pChunk->free_count() == mCountBlocks;
+    void *p = pChunk->allocate(mBlockSize);
+    if (p == nullptr) {
+        return p;
+    }
+    if (mStat != nullptr) {
+        mStat->add_allocated(1);
+        mStat->add_free(-1);
+    }
+    if (emptyBefore) {  // before empty
+        pChunk->leave();
+        mFreeList.push_back(pChunk);
+        --mEmptyCount;
+    }
+    if (pChunk->free_count() == 0) {  // now full
+        pChunk->leave();
+        ++mFullCount;
+        mFullList.push_back(pChunk);
+    }
+    return p;
+}
+
+int SlabAllocator::create_chunk() {
+    SlabChunk *pChunk = SlabChunk::create(mBlockSize, mChunkSize, mHugePage);
+    if (pChunk == nullptr) {
+        return ErrorAllocMemoryFailed;
+    }
+
+    ++mEmptyCount;
+    mEmptyList.push_back(pChunk);
+    if (mStat != nullptr) {
+        mStat->add_chunks(1, int64_t(mChunkSize));
+        mStat->add_free(mCountBlocks);
+    }
+    return Success;
+}
+
+void SlabAllocator::destroy_chunk(SlabChunk *pChunk) {
+    if (mStat != nullptr) {
+        mStat->add_chunks(-1, -int64_t(mChunkSize));
+        mStat->add_free(-int64_t(pChunk->free_count()));
+        mStat->add_allocated(int64_t(pChunk->free_count()) - mCountBlocks);
+    }
+    SlabChunk::destroy(pChunk);
+}
+
+void SlabAllocator::deallocate(void *p) {
+    SlabChunk *pChunk = SlabChunk::self(p, mChunkSize);
+    if (pChunk == nullptr) {
+        return;
+    }
+    bool fullBefore = pChunk->free_count() == 0;
+    int err = pChunk->deallocate(p, mBlockSize);
+    if (err != Success) {
+        PureError("SlabAllocator::deallocate failed {}", get_error_desc(err));
+        return;
+    }
+    if (mStat != nullptr) {
+        mStat->add_allocated(-1);
+        mStat->add_free(1);
+    }
+    if (fullBefore) {  // full before
+        pChunk->leave();
+        mFreeList.push_back(pChunk);
+        --mFullCount;
+    }
+    if (pChunk->free_count() == mCountBlocks) {  // now empty
+        pChunk->leave();
+        mEmptyList.push_back(pChunk);
+        ++mEmptyCount;
+    }
+}
+
+size_t SlabAllocator::get_full_count() const { return mFullCount; }
+
+size_t SlabAllocator::get_empty_count() const { return mEmptyCount; }
+
+size_t SlabAllocator::get_chunk_size() const { return mChunkSize; }
+
+size_t SlabAllocator::get_chunk_blocks() const { return mCountBlocks; }
+
+void SlabAllocator::set_stat(PoolStat *stat) { mStat = stat; }
+
+void SlabAllocator::gc(bool all) {
+    if (all) {
+        while (!mEmptyList.empty()) {
+            destroy_chunk(mEmptyList.pop_front_t<SlabChunk>());
+            --mEmptyCount;
+        }
+    } else {
+        SlabChunk *pChunk = mEmptyList.pop_front_t<SlabChunk>();
+        if (pChunk != nullptr) {
+            destroy_chunk(pChunk);
+            --mEmptyCount;
+        }
+    }
+}
+
+}  // namespace PureCore
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "PureCore/CoreErrorDesc.h"
+#include "PureCore/PureLog.h"
+#include "PureCore/Memory/PageMemory.h"
+#include "PureCore/Memory/SlabChunk.h"
+
+#include <new>
+#include <string.h>
+
+namespace PureCore {
+///////////////////////////////////////////////////////////////////
+// SlabChunk
+//////////////////////////////////////////////////////////////////
+SlabChunk::SlabChunk(size_t chunkSize, uint32_t countBlocks, bool hugePage)
+    : Node(), mChunkSize(chunkSize), mData(nullptr), mBitmap(nullptr), mCountBlocks(countBlocks), mCountAvBlocks(countBlocks), mHint(0), mHugePage(hugePage) {
+    uint8_t* base = reinterpret_cast<uint8_t*>(this);
+    size_t words = (countBlocks + 63) / 64;
+    mBitmap = reinterpret_cast<uint64_t*>(base + ((sizeof(SlabChunk) + 7) & ~size_t(7)));
+    mData = base + head_size(countBlocks);
+    for (size_t i = 0; i < words; ++i) {
+        mBitmap[i] = ~uint64_t(0);
+    }
+    if (countBlocks % 64 != 0) {
+        mBitmap[words - 1] = (uint64_t(1) << (countBlocks % 64)) - 1;
+    }
+}
+
+SlabChunk::~SlabChunk() { leave(); }
+
+void* SlabChunk::allocate(size_t blockSize) {
+    if (mCountAvBlocks == 0) {
+        return nullptr;
+    }
+    uint32_t words = (mCountBlocks + 63) / 64;
+    for (uint32_t i = mHint; i < words; ++i) {
+        uint64_t& word = mBitmap[i];
+        if (word == 0) {
+            continue;
+        }
+        uint32_t idx = i * 64 + bit_ctz(word);
+        word &= word - 1;
+        mHint = i;
+        --mCountAvBlocks;
+        return mData + idx * blockSize;
+    }
+    return nullptr;
+}
+
+int SlabChunk::deallocate(void* p, size_t blockSize) {
+    uint8_t* real = static_cast<uint8_t*>(p);
+    if (real < mData || (real - mData) % blockSize != 0) {
+        return ErrorInvalidMemory;
+    }
+    size_t idx = (real - mData) / blockSize;
+    if (idx >= mCountBlocks) {
+        return ErrorInvalidMemory;
+    }
+    uint32_t word = static_cast<uint32_t>(idx / 64);
+    uint64_t bit = uint64_t(1) << (idx % 64);
+    if (mBitmap[word] & bit) {  // double free
+        return ErrorInvalidMemory;
+    }
+    mBitmap[word] |= bit;
+    if (word < mHint) {
+        mHint = word;
+    }
+    ++mCountAvBlocks;
+    return Success;
+}
+
+uint32_t SlabChunk::free_count() const { return mCountAvBlocks; }
+
+uint32_t SlabChunk::block_count() const { return mCountBlocks; }
+
+SlabChunk* SlabChunk::create(size_t blockSize, size_t chunkSize, bool hugePage) {
+    uint32_t countBlocks = calc_block_count(blockSize, chunkSize);
+    if (countBlocks == 0) {
+        return nullptr;
+    }
+    void* p = map_aligned_pages(chunkSize, hugePage);
+    if (p == nullptr) {
+        return nullptr;
+    }
+    return new (p) SlabChunk(chunkSize, countBlocks, hugePage);
+}
+
+void SlabChunk::destroy(SlabChunk* chunk) {
+    if (chunk == nullptr) {
+        return;
+    }
+    size_t chunkSize = chunk->mChunkSize;
+    chunk->~SlabChunk();
+    unmap_aligned_pages(chunk, chunkSize);
+}
+
+SlabChunk* SlabChunk::self(void* p, size_t chunkSize) {
+    if (p == nullptr) {
+        return nullptr;
+    }
+    return reinterpret_cast<SlabChunk*>(reinterpret_cast<uintptr_t>(p) & ~(uintptr_t(chunkSize) - 1));
+}
+
+uint32_t SlabChunk::calc_block_count(size_t blockSize, size_t chunkSize) {
+    if (blockSize == 0 || chunkSize <= head_size(0)) {
+        return 0;
+    }
+    size_t count = (chunkSize - head_size(0)) / blockSize;
+    while (count > 0 && head_size(static_cast<uint32_t>(count)) + count * blockSize > chunkSize) {
+        --count;
+    }
+    return static_cast<uint32_t>(count);
+}
+
+size_t SlabChunk::head_size(uint32_t countBlocks) {
+    size_t size = ((sizeof(SlabChunk) + 7) & ~size_t(7)) + (countBlocks + 63) / 64 * sizeof(uint64_t);
+    return (size + 15) & ~size_t(15);
+}
+
+}  // namespace PureCore
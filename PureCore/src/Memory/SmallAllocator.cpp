@@ -28,7 +28,10 @@ namespace PureCore {
 //////////////////////////////////////////////////////////////
 // SmallAllocator
 /////////////////////////////////////////////////////////////
-SmallAllocator::SmallAllocator() { memset(mPool, 0, sizeof(mPool)); }
+SmallAllocator::SmallAllocator(const char *name) : mStat(name), mMedium() {
+    memset(mPool, 0, sizeof(mPool));
+    mMedium.set_stat(&mStat);
+}
 
 SmallAllocator::~SmallAllocator() {
     for (size_t i = 0u; i < PURE_ARRAY_SIZE(mPool); ++i) {
@@ -40,6 +43,11 @@ SmallAllocator::~SmallAllocator() {
 
 void *SmallAllocator::allocate(size_t size) {
     if (size > BigObjectSize) {
+        if (size <= MediumObjectSize) {
+            mStat.hit();
+            return mMedium.allocate(size);
+        }
+        mStat.miss();
         return ::malloc(size);
     } else {
         if (size == 0) {
@@ -54,11 +62,13 @@ void *SmallAllocator::allocate(size_t size) {
                 if (!f) {
                     return nullptr;
                 }
+                f->set_stat(&mStat);
                 *(mPool + index) = f;
             } else {
                 f = *(mPool + index);
             }
         }
+        mStat.hit();
         return f->allocate();
     }
     return nullptr;
@@ -66,8 +76,10 @@ void *SmallAllocator::allocate(size_t size) {
 
 void SmallAllocator::deallocate(void *p, size_t size) {
     if (p) {
-        if (size > BigObjectSize) {
+        if (size > MediumObjectSize) {
             ::free(p);
+        } else if (size > BigObjectSize) {
+            mMedium.deallocate(p, size);
         } else {
             if (size == 0) {
                 size = 1;
@@ -93,11 +105,17 @@ void *SmallAllocator::reallocate(void *p, size_t osize, size_t nsize) {
         deallocate(p, osize);
         return nullptr;
     }
-    if (((osize - 1) >> OffSetBit) == ((nsize - 1) >> OffSetBit)) {
-        return p;
-    }
-    if (osize > BigObjectSize && nsize > BigObjectSize) {
-        return ::realloc(p, nsize);
+    if (osize <= BigObjectSize && nsize <= BigObjectSize) {
+        if (((osize - 1) >> OffSetBit) == ((nsize - 1) >> OffSetBit)) {
+            return p;
+        }
+    } else if (osize > BigObjectSize && nsize > BigObjectSize) {
+        if (osize <= MediumObjectSize && nsize <= MediumObjectSize) {
+            return mMedium.reallocate(p, osize, nsize);
+        }
+        if (osize > MediumObjectSize && nsize > MediumObjectSize) {
+            return ::realloc(p, nsize);
+        }
     }
 
     void *np = allocate(nsize);
@@ -120,5 +138,6 @@ void SmallAllocator::gc(bool all) {
             mPool[i]->gc(all);
         }
     }
+    mMedium.gc(all);
 }
 }  // namespace PureCore
\ No newline at end of file
@@ -0,0 +1,383 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "PureCore/CoreErrorDesc.h"
+#include "PureCore/PureLog.h"
+#include "PureCore/Memory/ThreadCacheAllocator.h"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <string.h>
+
+namespace PureCore {
+//////////////////////////////////////////////////////////////
+// ThreadCacheHeap
+/////////////////////////////////////////////////////////////
+// block layout: [owner heap][user data], block in remote list: [next block][class index]
+class ThreadCacheHeap {
+public:
+    enum ESizeConst {
+        ClassCount = ThreadCacheAllocator::ClassCount,
+        Align = ThreadCacheAllocator::Align,
+        HeadSize = ThreadCacheAllocator::HeadSize,
+        MagazineSize = ThreadCacheAllocator::MagazineSize,
+    };
+
+public:
+    ThreadCacheHeap();
+    ~ThreadCacheHeap();
+
+    void* allocate(size_t index);
+    void free_local(uint8_t* block, size_t index);
+    void free_remote(uint8_t* block, size_t index);
+    void collect_remote();
+    void flush(bool all);
+    size_t used_count() const;
+
+    static ThreadCacheHeap* owner(void* p);
+
+private:
+    struct Magazine {
+        size_t mCount;
+        void* mBlocks[MagazineSize];
+    };
+    SlabAllocator* get_pool(size_t index);
+
+private:
+    SlabAllocator* mPool[ClassCount];
+    Magazine* mMagazine[ClassCount];
+    size_t mUsedCount;
+    std::atomic<uint8_t*> mRemoteFree{};
+    PoolStat mStat;  // miss means magazine refill
+
+    PURE_DISABLE_COPY(ThreadCacheHeap)
+};
+
+ThreadCacheHeap::ThreadCacheHeap() : mUsedCount(0), mStat("ThreadCacheAllocator") {
+    memset(mPool, 0, sizeof(mPool));
+    memset(mMagazine, 0, sizeof(mMagazine));
+}
+
+ThreadCacheHeap::~ThreadCacheHeap() {
+    for (size_t i = 0u; i < PURE_ARRAY_SIZE(mPool); ++i) {
+        if (mMagazine[i]) {
+            delete mMagazine[i];
+        }
+        if (mPool[i]) {
+            delete mPool[i];
+        }
+    }
+}
+
+void* ThreadCacheHeap::allocate(size_t index) {
+    Magazine* m = mMagazine[index];
+    if (m == nullptr) {
+        m = new Magazine();
+        if (m == nullptr) {
+            return nullptr;
+        }
+        mMagazine[index] = m;
+    }
+    if (m->mCount == 0 && mRemoteFree.load(std::memory_order_relaxed) != nullptr) {
+        collect_remote();
+    }
+    if (m->mCount == 0) {
+        mStat.miss();
+        SlabAllocator* f = get_pool(index);
+        if (f == nullptr) {
+            return nullptr;
+        }
+        while (m->mCount < MagazineSize / 2) {
+            void* block = f->allocate();
+            if (block == nullptr) {
+                break;
+            }
+            m->mBlocks[m->mCount++] = block;
+        }
+        if (m->mCount == 0) {
+            return nullptr;
+        }
+    } else {
+        mStat.hit();
+    }
+    uint8_t* block = static_cast<uint8_t*>(m->mBlocks[--m->mCount]);
+    ThreadCacheHeap* self = this;
+    memcpy(block, &self, sizeof(self));
+    ++mUsedCount;
+    return block + HeadSize;
+}
+
+void ThreadCacheHeap::free_local(uint8_t* block, size_t index) {
+    Magazine* m = mMagazine[index];
+    SlabAllocator* f = mPool[index];
+    if (m == nullptr || f == nullptr) {
+        PureError("ThreadCacheHeap::free_local `{}` failed, not found size class {}", static_cast<void*>(block), index);
+        return;
+    }
+    --mUsedCount;
+    if (m->mCount == MagazineSize) {
+        while (m->mCount > MagazineSize / 2) {
+            f->deallocate(m->mBlocks[--m->mCount]);
+        }
+        if (f->get_empty_count() > 1) {
+            f->gc(false);
+        }
+    }
+    m->mBlocks[m->mCount++] = block;
+}
+
+void ThreadCacheHeap::free_remote(uint8_t* block, size_t index) {
+    uint32_t classIndex = static_cast<uint32_t>(index);
+    memcpy(block + HeadSize, &classIndex, sizeof(classIndex));
+    uint8_t* head = mRemoteFree.load(std::memory_order_relaxed);
+    do {
+        memcpy(block, &head, sizeof(head));
+    } while (!mRemoteFree.compare_exchange_weak(head, block, std::memory_order_release, std::memory_order_relaxed));
+}
+
+void ThreadCacheHeap::collect_remote() {
+    uint8_t* block = mRemoteFree.exchange(nullptr, std::memory_order_acquire);
+    uint8_t* next = nullptr;
+    uint32_t classIndex = 0;
+    while (block != nullptr) {
+        memcpy(&next, block, sizeof(next));
+        memcpy(&classIndex, block + HeadSize, sizeof(classIndex));
+        free_local(block, classIndex);
+        block = next;
+    }
+}
+
+void ThreadCacheHeap::flush(bool all) {
+    for (size_t i = 0u; i < PURE_ARRAY_SIZE(mPool); ++i) {
+        SlabAllocator* f = mPool[i];
+        if (f == nullptr) {
+            continue;
+        }
+        Magazine* m = mMagazine[i];
+        if (all && m != nullptr) {
+            while (m->mCount > 0) {
+                f->deallocate(m->mBlocks[--m->mCount]);
+            }
+        }
+        f->gc(all);
+    }
+}
+
+size_t ThreadCacheHeap::used_count() const { return mUsedCount; }
+
+ThreadCacheHeap* ThreadCacheHeap::owner(void* p) {
+    ThreadCacheHeap* heap = nullptr;
+    memcpy(&heap, static_cast<uint8_t*>(p) - HeadSize, sizeof(heap));
+    return heap;
+}
+
+static_assert(ThreadCacheAllocator::Align <= 16, "slab chunk data is aligned by 16 bytes");
+
+// slab blocks start at 16 bytes aligned address, block size round up to Align keeps user data aligned
+SlabAllocator* ThreadCacheHeap::get_pool(size_t index) {
+    SlabAllocator* f = mPool[index];
+    if (f == nullptr) {
+        size_t blockSize = (HeadSize + ((index + 1) << ThreadCacheAllocator::OffSetBit) + Align - 1) / Align * Align;
+        f = new SlabAllocator(blockSize, ThreadCacheAllocator::ChunkSize);
+        if (f == nullptr) {
+            return nullptr;
+        }
+        f->set_stat(&mStat);
+        mPool[index] = f;
+    }
+    return f;
+}
+
+//////////////////////////////////////////////////////////////
+// ThreadCacheHolder
+/////////////////////////////////////////////////////////////
+static thread_local ThreadCacheHeap* tlHeap = nullptr;
+static thread_local bool tlExited = false;
+
+class ThreadCacheHolder {
+public:
+    ThreadCacheHolder() = default;
+    ~ThreadCacheHolder() {
+        if (mHeap != nullptr) {
+            ThreadCacheAllocator::abandon_heap(mHeap);
+            mHeap = nullptr;
+        }
+        tlHeap = nullptr;
+        tlExited = true;
+    }
+
+    void attach(ThreadCacheHeap* heap) { mHeap = heap; }
+
+private:
+    ThreadCacheHeap* mHeap = nullptr;
+
+    PURE_DISABLE_COPY(ThreadCacheHolder)
+};
+
+static thread_local ThreadCacheHolder tlHolder;
+
+struct AbandonedHeaps {
+    std::mutex mMutex;
+    std::vector<ThreadCacheHeap*> mHeaps;
+};
+
+// never destroy, thread may exit after static destroy
+static AbandonedHeaps& abandoned_heaps() {
+    static AbandonedHeaps* heaps = new AbandonedHeaps();
+    return *heaps;
+}
+
+//////////////////////////////////////////////////////////////
+// ThreadCacheAllocator
+/////////////////////////////////////////////////////////////
+void* ThreadCacheAllocator::allocate(size_t size) {
+    if (size > BigObjectSize) {
+        return ::malloc(size);
+    }
+    if (size == 0) {
+        size = 1;
+    }
+    size_t index = (size - 1) >> OffSetBit;
+    ThreadCacheHeap* heap = local_heap();
+    if (heap != nullptr) {
+        return heap->allocate(index);
+    }
+    // thread is exiting, borrow a heap
+    heap = adopt_heap();
+    if (heap == nullptr) {
+        return nullptr;
+    }
+    void* p = heap->allocate(index);
+    abandon_heap(heap);
+    return p;
+}
+
+void ThreadCacheAllocator::deallocate(void* p, size_t size) {
+    if (p == nullptr) {
+        return;
+    }
+    if (size > BigObjectSize) {
+        ::free(p);
+        return;
+    }
+    if (size == 0) {
+        size = 1;
+    }
+    size_t index = (size - 1) >> OffSetBit;
+    ThreadCacheHeap* owner = ThreadCacheHeap::owner(p);
+    uint8_t* block = static_cast<uint8_t*>(p) - HeadSize;
+    if (owner == tlHeap) {
+        owner->free_local(block, index);
+    } else {
+        owner->free_remote(block, index);
+    }
+}
+
+void* ThreadCacheAllocator::reallocate(void* p, size_t osize, size_t nsize) {
+    if (p == nullptr) {
+        return allocate(nsize);
+    }
+    if (nsize == 0) {
+        deallocate(p, osize);
+        return nullptr;
+    }
+    if (osize > BigObjectSize && nsize > BigObjectSize) {
+        return ::realloc(p, nsize);
+    }
+    if (osize <= BigObjectSize && nsize <= BigObjectSize && ((osize - 1) >> OffSetBit) == ((nsize - 1) >> OffSetBit)) {
+        return p;
+    }
+
+    void* np = allocate(nsize);
+    if (np == nullptr) {
+        return nullptr;
+    }
+    memcpy(np, p, osize < nsize ? osize : nsize);
+    deallocate(p, osize);
+    return np;
+}
+
+void ThreadCacheAllocator::gc(bool all) {
+    ThreadCacheHeap* heap = tlHeap;
+    if (heap != nullptr) {
+        heap->collect_remote();
+        heap->flush(all);
+    }
+    reclaim_heaps();
+}
+
+ThreadCacheHeap* ThreadCacheAllocator::local_heap() {
+    if (tlHeap != nullptr) {
+        return tlHeap;
+    }
+    if (tlExited) {
+        return nullptr;
+    }
+    tlHeap = adopt_heap();
+    tlHolder.attach(tlHeap);
+    return tlHeap;
+}
+
+ThreadCacheHeap* ThreadCacheAllocator::adopt_heap() {
+    AbandonedHeaps& heaps = abandoned_heaps();
+    {
+        std::unique_lock<std::mutex> lock(heaps.mMutex);
+        if (!heaps.mHeaps.empty()) {
+            ThreadCacheHeap* heap = heaps.mHeaps.back();
+            heaps.mHeaps.pop_back();
+            return heap;
+        }
+    }
+    return new ThreadCacheHeap();
+}
+
+void ThreadCacheAllocator::abandon_heap(ThreadCacheHeap* heap) {
+    heap->collect_remote();
+    heap->flush(true);
+    if (heap->used_count() == 0) {
+        delete heap;
+        return;
+    }
+    AbandonedHeaps& heaps = abandoned_heaps();
+    std::unique_lock<std::mutex> lock(heaps.mMutex);
+    heaps.mHeaps.push_back(heap);
+}
+
+void ThreadCacheAllocator::reclaim_heaps() {
+    AbandonedHeaps& heaps = abandoned_heaps();
+    std::unique_lock<std::mutex> lock(heaps.mMutex);
+    for (size_t i = 0; i < heaps.mHeaps.size();) {
+        ThreadCacheHeap* heap = heaps.mHeaps[i];
+        heap->collect_remote();
+        heap->flush(true);
+        if (heap->used_count() == 0) {
+            delete heap;
+            heaps.mHeaps[i] = heaps.mHeaps.back();
+            heaps.mHeaps.pop_back();
+        } else {
+            ++i;
+        }
+    }
+}
+
+}  // namespace PureCore
@@ -0,0 +1,492 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "PureCore/PathFinder.h"
+#include "PureCore/CoreErrorDesc.h"
+#include "PureCore/Task.h"
+#include "PureCore/TaskParallel.h"
+
+#include <algorithm>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace PureCore {
+static const uint32_t sStraightCost = 10;
+static const uint32_t sDiagonalCost = 14;
+static const int32_t sDirs[8][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+
+static inline int lowest_bit(uint64_t v) {
+#ifdef _MSC_VER
+    unsigned long idx = 0;
+    _BitScanForward64(&idx, v);
+    return int(idx);
+#else
+    return __builtin_ctzll(v);
+#endif
+}
+
+static inline int highest_bit(uint64_t v) {
+#ifdef _MSC_VER
+    unsigned long idx = 0;
+    _BitScanReverse64(&idx, v);
+    return int(idx);
+#else
+    return 63 - __builtin_clzll(v);
+#endif
+}
+
+static inline int32_t sign(int32_t v) { return (v > 0) - (v < 0); }
+
+static inline uint32_t octile(int32_t dx, int32_t dy) {
+    uint32_t ax = uint32_t(dx < 0 ? -dx : dx);
+    uint32_t ay = uint32_t(dy < 0 ? -dy : dy);
+    return ax > ay ? sStraightCost * ax + (sDiagonalCost - sStraightCost) * ay : sStraightCost * ay + (sDiagonalCost - sStraightCost) * ax;
+}
+
+// straight jump along line cur from start in dir, stop at the goal or at a cell whose side line a or b opens right
+// after a blocked cell, that cell has a forced neighbor. 64 cells are checked a word, -1 when a blocked cell comes first
+static int32_t scan_line(const uint64_t* cur, const uint64_t* a, const uint64_t* b, size_t words, int32_t start, int32_t goal, int32_t dir) {
+    if (dir > 0) {
+        uint64_t mask = ~uint64_t(0) << (start & 63);
+        for (size_t w = size_t(start) >> 6; w < words; ++w, mask = ~uint64_t(0)) {
+            // bit i of back is the side cell behind cell i
+            uint64_t aBack = (a[w] << 1) | (w > 0 ? a[w - 1] >> 63 : 1);
+            uint64_t bBack = (b[w] << 1) | (w > 0 ? b[w - 1] >> 63 : 1);
+            uint64_t stop = ((~a[w] & aBack) | (~b[w] & bBack)) & mask;
+            if (goal >= 0 && size_t(goal) >> 6 == w) {
+                stop |= (uint64_t(1) << (goal & 63)) & mask;
+            }
+            uint64_t block = cur[w] & mask;
+            if (block != 0) {
+                stop &= (uint64_t(1) << lowest_bit(block)) - 1;
+                return stop != 0 ? int32_t(w * 64) + lowest_bit(stop) : -1;
+            }
+            if (stop != 0) {
+                return int32_t(w * 64) + lowest_bit(stop);
+            }
+        }
+        return -1;
+    }
+    uint64_t mask = (uint64_t(2) << (start & 63)) - 1;
+    for (size_t w = (size_t(start) >> 6) + 1; w-- > 0; mask = ~uint64_t(0)) {
+        uint64_t aBack = (a[w] >> 1) | (w + 1 < words ? a[w + 1] << 63 : uint64_t(1) << 63);
+        uint64_t bBack = (b[w] >> 1) | (w + 1 < words ? b[w + 1] << 63 : uint64_t(1) << 63);
+        uint64_t stop = ((~a[w] & aBack) | (~b[w] & bBack)) & mask;
+        if (goal >= 0 && size_t(goal) >> 6 == w) {
+            stop |= (uint64_t(1) << (goal & 63)) & mask;
+        }
+        uint64_t block = cur[w] & mask;
+        if (block != 0) {
+            stop &= ~((uint64_t(2) << highest_bit(block)) - 1);
+            return stop != 0 ? int32_t(w * 64) + highest_bit(stop) : -1;
+        }
+        if (stop != 0) {
+            return int32_t(w * 64) + highest_bit(stop);
+        }
+    }
+    return -1;
+}
+
+static int32_t jump_x(const GridMap& map, int32_t x, int32_t y, int32_t dx, const IntPoint& goal) {
+    if (x < 0 || y < 0 || x >= map.width() || y >= map.height()) {
+        return -1;
+    }
+    return scan_line(map.row(y), map.row(y - 1), map.row(y + 1), map.row_words(), x, goal.mY == y ? goal.mX : -1, dx);
+}
+
+static int32_t jump_y(const GridMap& map, int32_t x, int32_t y, int32_t dy, const IntPoint& goal) {
+    if (x < 0 || y < 0 || x >= map.width() || y >= map.height()) {
+        return -1;
+    }
+    return scan_line(map.column(x), map.column(x - 1), map.column(x + 1), map.column_words(), y, goal.mX == x ? goal.mY : -1, dy);
+}
+
+///////////////////////////////////////////////////////////////////////////
+// PathFinder
+//////////////////////////////////////////////////////////////////////////
+PathFinder::PathFinder(size_t cacheSize) : mCacheSize(cacheSize) {}
+
+int PathFinder::find_path(const GridMap& map, const IntPoint& start, const IntPoint& goal, std::vector<IntPoint>& path, uint32_t flags) {
+    path.clear();
+    mExpanded = 0;
+    if (start.mX < 0 || start.mY < 0 || start.mX >= map.width() || start.mY >= map.height() || goal.mX < 0 || goal.mY < 0 ||
+        goal.mX >= map.width() || goal.mY >= map.height()) {
+        return ErrorInvalidArg;
+    }
+    if (mCacheStamp != map.stamp()) {
+        clear_cache();
+        mCacheStamp = map.stamp();
+    }
+    uint64_t cells = uint64_t(map.width()) * uint64_t(map.height());
+    uint64_t startIdx = uint64_t(start.mY) * uint64_t(map.width()) + uint64_t(start.mX);
+    uint64_t goalIdx = uint64_t(goal.mY) * uint64_t(map.width()) + uint64_t(goal.mX);
+    uint64_t key = ((startIdx * cells + goalIdx) << 2) | (flags & (PathJps | PathSmooth));
+    auto iter = mCacheMap.find(key);
+    if (iter != mCacheMap.end() && (flags & PathNoCache) == 0) {
+        mCacheList.splice(mCacheList.begin(), mCacheList, iter->second);
+        path = iter->second->mPath;
+        ++mCacheHits;
+        return iter->second->mErr;
+    }
+
+    int err = search(map, start, goal, path, flags);
+    if (mCacheSize == 0) {
+        return err;
+    }
+    if (iter != mCacheMap.end()) {
+        mCacheList.splice(mCacheList.begin(), mCacheList, iter->second);
+    } else if (mCacheList.size() >= mCacheSize) {
+        // reuse the oldest entry and its path storage
+        mCacheMap.erase(mCacheList.back().mKey);
+        mCacheList.splice(mCacheList.begin(), mCacheList, std::prev(mCacheList.end()));
+        mCacheMap[key] = mCacheList.begin();
+    } else {
+        mCacheList.emplace_front();
+        mCacheMap[key] = mCacheList.begin();
+    }
+    CacheEntry& entry = mCacheList.front();
+    entry.mKey = key;
+    entry.mErr = err;
+    entry.mPath = path;
+    return err;
+}
+
+size_t PathFinder::cache_size() const { return mCacheSize; }
+
+void PathFinder::set_cache_size(size_t size) {
+    mCacheSize = size;
+    while (mCacheList.size() > mCacheSize) {
+        mCacheMap.erase(mCacheList.back().mKey);
+        mCacheList.pop_back();
+    }
+}
+
+void PathFinder::clear_cache() {
+    mCacheList.clear();
+    mCacheMap.clear();
+}
+
+uint64_t PathFinder::cache_hits() const { return mCacheHits; }
+
+size_t PathFinder::expanded() const { return mExpanded; }
+
+int PathFinder::search(const GridMap& map, const IntPoint& start, const IntPoint& goal, std::vector<IntPoint>& path, uint32_t flags) {
+    if (map.is_block(start.mX, start.mY) || map.is_block(goal.mX, goal.mY)) {
+        return ErrorPathNotFound;
+    }
+    reset(map);
+    uint32_t startIdx = uint32_t(start.mY) * uint32_t(mWidth) + uint32_t(start.mX);
+    uint32_t goalIdx = uint32_t(goal.mY) * uint32_t(mWidth) + uint32_t(goal.mX);
+    open(startIdx, startIdx, 0, start, goal);
+    while (!mOpen.empty()) {
+        std::pop_heap(mOpen.begin(), mOpen.end(), open_greater);
+        OpenItem item = mOpen.back();
+        mOpen.pop_back();
+        // a cell reached again by a shorter path leaves its old item behind
+        if (item.mG != mCells[item.mIdx].mG) {
+            continue;
+        }
+        ++mExpanded;
+        if (item.mIdx == goalIdx) {
+            break;
+        }
+        IntPoint p{int32_t(item.mIdx % uint32_t(mWidth)), int32_t(item.mIdx / uint32_t(mWidth))};
+        if (flags & PathJps) {
+            expand_jps(map, p, item.mIdx, item.mG, goal);
+        } else {
+            expand_astar(map, p, item.mIdx, item.mG, goal);
+        }
+    }
+    if (mCells[goalIdx].mGen != mGen) {
+        return ErrorPathNotFound;
+    }
+
+    for (uint32_t idx = goalIdx;; idx = mCells[idx].mParent) {
+        path.push_back(IntPoint{int32_t(idx % uint32_t(mWidth)), int32_t(idx / uint32_t(mWidth))});
+        if (idx == startIdx) {
+            break;
+        }
+    }
+    std::reverse(path.begin(), path.end());
+    // keep the turning points only
+    size_t count = std::min<size_t>(path.size(), 1);
+    for (size_t i = 1; i < path.size(); ++i) {
+        if (i + 1 < path.size() && sign(path[i].mX - path[i - 1].mX) == sign(path[i + 1].mX - path[i].mX) &&
+            sign(path[i].mY - path[i - 1].mY) == sign(path[i + 1].mY - path[i].mY)) {
+            continue;
+        }
+        path[count++] = path[i];
+    }
+    path.resize(count);
+    if (flags & PathSmooth) {
+        smooth(map, path);
+    }
+    return Success;
+}
+
+void PathFinder::reset(const GridMap& map) {
+    mOpen.clear();
+    if (map.width() != mWidth || map.height() != mHeight) {
+        mWidth = map.width();
+        mHeight = map.height();
+        mCells.assign(size_t(mWidth) * size_t(mHeight), PathCell{0, 0, 0});
+        mGen = 0;
+    }
+    // a new generation marks every cell unvisited without touching them
+    if (++mGen == 0) {
+        for (auto& c : mCells) {
+            c.mGen = 0;
+        }
+        mGen = 1;
+    }
+}
+
+void PathFinder::open(uint32_t idx, uint32_t parent, uint32_t g, const IntPoint& p, const IntPoint& goal) {
+    PathCell& c = mCells[idx];
+    if (c.mGen == mGen && c.mG <= g) {
+        return;
+    }
+    c.mGen = mGen;
+    c.mG = g;
+    c.mParent = parent;
+    mOpen.push_back(OpenItem{g + octile(goal.mX - p.mX, goal.mY - p.mY), g, idx});
+    std::push_heap(mOpen.begin(), mOpen.end(), open_greater);
+}
+
+void PathFinder::expand_astar(const GridMap& map, const IntPoint& p, uint32_t idx, uint32_t g, const IntPoint& goal) {
+    for (auto& d : sDirs) {
+        IntPoint n{p.mX + d[0], p.mY + d[1]};
+        if (map.is_block(n.mX, n.mY)) {
+            continue;
+        }
+        bool diagonal = d[0] != 0 && d[1] != 0;
+        if (diagonal && (map.is_block(p.mX + d[0], p.mY) || map.is_block(p.mX, p.mY + d[1]))) {
+            continue;
+        }
+        open(uint32_t(n.mY) * uint32_t(mWidth) + uint32_t(n.mX), idx, g + (diagonal ? sDiagonalCost : sStraightCost), n, goal);
+    }
+}
+
+void PathFinder::expand_jps(const GridMap& map, const IntPoint& p, uint32_t idx, uint32_t g, const IntPoint& goal) {
+    // pruned directions by the move into p, the start has no parent and tries all of them
+    int32_t dirs[8][2];
+    size_t count = 0;
+    uint32_t parent = mCells[idx].mParent;
+    int32_t dx = sign(p.mX - int32_t(parent % uint32_t(mWidth)));
+    int32_t dy = sign(p.mY - int32_t(parent / uint32_t(mWidth)));
+    auto add = [&dirs, &count](int32_t x, int32_t y) {
+        dirs[count][0] = x;
+        dirs[count][1] = y;
+        ++count;
+    };
+    if (parent == idx) {
+        for (auto& d : sDirs) {
+            add(d[0], d[1]);
+        }
+    } else if (dx != 0 && dy != 0) {
+        add(dx, 0);
+        add(0, dy);
+        add(dx, dy);
+    } else if (dx != 0) {
+        add(dx, 0);
+        add(dx, 1);
+        add(dx, -1);
+        add(0, 1);
+        add(0, -1);
+    } else {
+        add(0, dy);
+        add(1, dy);
+        add(-1, dy);
+        add(1, 0);
+        add(-1, 0);
+    }
+    for (size_t i = 0; i < count; ++i) {
+        int32_t x = dirs[i][0];
+        int32_t y = dirs[i][1];
+        if (x != 0 && y != 0 && (map.is_block(p.mX + x, p.mY) || map.is_block(p.mX, p.mY + y))) {
+            continue;
+        }
+        IntPoint jp;
+        if (jump(map, IntPoint{p.mX + x, p.mY + y}, x, y, goal, jp)) {
+            open(uint32_t(jp.mY) * uint32_t(mWidth) + uint32_t(jp.mX), idx, g + octile(jp.mX - p.mX, jp.mY - p.mY), jp, goal);
+        }
+    }
+}
+
+bool PathFinder::jump(const GridMap& map, IntPoint p, int32_t dx, int32_t dy, const IntPoint& goal, IntPoint& out) {
+    if (dy == 0) {
+        out = IntPoint{jump_x(map, p.mX, p.mY, dx, goal), p.mY};
+        return out.mX >= 0;
+    }
+    if (dx == 0) {
+        out = IntPoint{p.mX, jump_y(map, p.mX, p.mY, dy, goal)};
+        return out.mY >= 0;
+    }
+    // a diagonal cell is a jump point when a straight jump from it finds one
+    for (;;) {
+        if (map.is_block(p.mX, p.mY)) {
+            return false;
+        }
+        if ((p.mX == goal.mX && p.mY == goal.mY) || jump_x(map, p.mX + dx, p.mY, dx, goal) >= 0 || jump_y(map, p.mX, p.mY + dy, dy, goal) >= 0) {
+            out = p;
+            return true;
+        }
+        if (map.is_block(p.mX + dx, p.mY) || map.is_block(p.mX, p.mY + dy)) {
+            return false;
+        }
+        p.mX += dx;
+        p.mY += dy;
+    }
+}
+
+void PathFinder::smooth(const GridMap& map, std::vector<IntPoint>& path) {
+    // string pulling, a waypoint goes when the last kept one sees the waypoint after it
+    size_t count = std::min<size_t>(path.size(), 1);
+    for (size_t i = 1; i < path.size(); ++i) {
+        if (i + 1 < path.size() && map.line_of_sight(IntLine{path[count - 1], path[i + 1]})) {
+            continue;
+        }
+        path[count++] = path[i];
+    }
+    path.resize(count);
+}
+
+///////////////////////////////////////////////////////////////////////////
+// PathBatch
+//////////////////////////////////////////////////////////////////////////
+PathBatch::PathBatch(size_t cacheSize) : mCacheSize(cacheSize) {}
+
+PathBatch::~PathBatch() = default;
+
+int PathBatch::add(const IntPoint& start, const IntPoint& goal, uint32_t flags) {
+    if (mRunning) {
+        return ErrorTaskAlreadyRunning;
+    }
+    if (mCount == mRequests.size()) {
+        mRequests.emplace_back();
+    }
+    PathRequest& r = mRequests[mCount++];
+    r.mStart = start;
+    r.mGoal = goal;
+    r.mFlags = flags;
+    r.mErr = Success;
+    r.mPath.clear();
+    return Success;
+}
+
+int PathBatch::clear() {
+    if (mRunning) {
+        return ErrorTaskAlreadyRunning;
+    }
+    mCount = 0;
+    return Success;
+}
+
+size_t PathBatch::size() const { return mCount; }
+
+bool PathBatch::is_running() const { return mRunning; }
+
+int PathBatch::error(size_t index) const { return index < mCount ? mRequests[index].mErr : ErrorInvalidArg; }
+
+const std::vector<IntPoint>& PathBatch::path(size_t index) const {
+    static const std::vector<IntPoint> sEmptyPath;
+    return index < mCount ? mRequests[index].mPath : sEmptyPath;
+}
+
+int PathBatch::run(Task& task, const GridMap& map, PathBatchCallback done) {
+    if (mRunning) {
+        return ErrorTaskAlreadyRunning;
+    }
+    size_t workers = std::max<size_t>(std::min<size_t>(task.get_size(), mCount), 1);
+    prepare(map, workers);
+    mDone = std::move(done);
+    mRunning = true;
+    int err = Success;
+    for (size_t i = 0; i < workers; ++i) {
+        // the workers share one range, so the added ones cover the requests of a failed add
+        err = task.add_task([this, i]() { work(i); }, [this]() { finish(); });
+        if (err != Success) {
+            break;
+        }
+        ++mPending;
+    }
+    if (mPending == 0) {
+        mRunning = false;
+        mDone = nullptr;
+        return err;
+    }
+    return Success;
+}
+
+int PathBatch::run_wait(Task& task, const GridMap& map) {
+    if (mRunning) {
+        return ErrorTaskAlreadyRunning;
+    }
+    size_t workers = std::max<size_t>(std::min<size_t>(size_t(task.get_size()) + 1, mCount), 1);
+    prepare(map, workers);
+    mRunning = true;
+    TaskJoin join(task);
+    for (size_t i = 1; i < workers; ++i) {
+        join.add_task([this, i]() { work(i); });
+    }
+    work(0);
+    join.wait();
+    mRunning = false;
+    return Success;
+}
+
+void PathBatch::prepare(const GridMap& map, size_t workers) {
+    mMap = &map;
+    mPending = 0;
+    while (mFinders.size() < workers) {
+        mFinders.emplace_back(new PathFinder(mCacheSize));
+    }
+    mRange.reset(new TaskRange(0, mCount, 1, workers));
+}
+
+void PathBatch::work(size_t worker) {
+    PathFinder& finder = *mFinders[worker];
+    size_t first = 0;
+    size_t last = 0;
+    while (mRange->next(first, last)) {
+        for (size_t i = first; i < last; ++i) {
+            PathRequest& r = mRequests[i];
+            r.mErr = finder.find_path(*mMap, r.mStart, r.mGoal, r.mPath, r.mFlags);
+        }
+    }
+}
+
+void PathBatch::finish() {
+    if (--mPending > 0) {
+        return;
+    }
+    mRunning = false;
+    PathBatchCallback done = std::move(mDone);
+    mDone = nullptr;
+    if (done) {
+        done(*this);
+    }
+}
+
+}  // namespace PureCore
@@ -22,9 +22,10 @@
 
 #include "PureCore/QuadTree.h"
 #include "PureCore/CoreErrorDesc.h"
+#include "PureCore/StaticRectTree.h"
 
 #include <algorithm>
-#include <unordered_set>
+#include <cmath>
 
 namespace PureCore {
 ///////////////////////////////////////////////////////////////////////////
@@ -38,6 +39,7 @@ QuadNode::~QuadNode() {
     }
     mChildren = {};
     mObjs.clear();
+    mObjBoxes.clear();
 }
 
 void QuadNode::add_obj(QuadObject* obj) {
@@ -47,6 +49,7 @@ void QuadNode::add_obj(QuadObject* obj) {
     if (is_leaf()) {
         if (mObjs.size() < mTree->mMaxElem) {
             mObjs.push_back(obj);
+            mObjBoxes.push_back(obj->mABox);
         } else {
             split();
             add_obj(obj);
@@ -61,7 +64,7 @@ void QuadNode::add_obj(QuadObject* obj) {
     }
 }
 
-void QuadNode::remove_obj(QuadNode* parent, QuadObject* obj) {
+void QuadNode::remove_obj(QuadNode* parent, QuadObject* obj, const IntABox& box) {
     if (obj == nullptr) {
         return;
     }
@@ -71,6 +74,7 @@ void QuadNode::remove_obj(QuadNode* parent, QuadObject* obj) {
             if (mObjs[i]->mObjID == obj->mObjID) {
                 mObjs[i] = mObjs.back();
                 mObjs.pop_back();
+                mObjBoxes.swap_remove(i);
                 break;
             }
         }
@@ -78,10 +82,51 @@ void QuadNode::remove_obj(QuadNode* parent, QuadObject* obj) {
             parent->try_merge();
         }
     } else {
-        uint8_t idx = quadrant(obj->mABox);
+        uint8_t idx = quadrant(box);
         for (uint8_t i = 0; i < mChildren.size(); ++i) {
             if ((idx & (uint8_t(1) << i)) != 0) {
-                mChildren[i]->remove_obj(this, obj);
+                mChildren[i]->remove_obj(this, obj, box);
+                if (is_leaf()) {  // merged
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void QuadNode::update_obj(QuadObject* obj, const IntABox& oldBox) {
+    if (obj == nullptr) {
+        return;
+    }
+    if (is_leaf()) {
+        for (size_t i = 0; i < mObjs.size(); ++i) {
+            if (mObjs[i] == obj) {
+                mObjBoxes.set(i, obj->mABox);
+                break;
+            }
+        }
+        return;
+    }
+    uint8_t oldIdx = quadrant(oldBox);
+    uint8_t newIdx = quadrant(obj->mABox);
+    // add before remove, so a removal does not merge the children obj moves into
+    for (uint8_t i = 0; i < mChildren.size(); ++i) {
+        uint8_t bit = uint8_t(1) << i;
+        if ((newIdx & bit) == 0) {
+            continue;
+        }
+        if ((oldIdx & bit) != 0) {
+            mChildren[i]->update_obj(obj, oldBox);
+        } else {
+            mChildren[i]->add_obj(obj);
+        }
+    }
+    for (uint8_t i = 0; i < mChildren.size(); ++i) {
+        uint8_t bit = uint8_t(1) << i;
+        if ((oldIdx & bit) != 0 && (newIdx & bit) == 0) {
+            mChildren[i]->remove_obj(this, obj, oldBox);
+            if (is_leaf()) {  // merged
+                break;
             }
         }
     }
@@ -122,10 +167,12 @@ void QuadNode::split() {
         for (uint8_t i = 0; i < mChildren.size(); ++i) {
             if ((idx & (uint8_t(1) << i)) != 0) {
                 mChildren[i]->mObjs.push_back(o);
+                mChildren[i]->mObjBoxes.push_back(o->mABox);
             }
         }
     }
     mObjs.clear();
+    mObjBoxes.clear();
 }
 int QuadNode::quadrant_box(ArrayRef<IntABox>& arr) const {
     if (arr.size() != 4) {
@@ -209,38 +256,167 @@ const std::vector<QuadObject*>& QuadTree::all_objs() {
     return mResult;
 }
 
-const std::vector<QuadObject*>& QuadTree::collide_abox(const IntABox& box) { return collide(box, 0); }
+const std::vector<QuadObject*>& QuadTree::collide_abox(const IntABox& box) {
+    mResult.clear();
+    query_abox(box, mResult);
+    return mResult;
+}
 
 const std::vector<QuadObject*>& QuadTree::collide_circle(const IntCircle& cir) {
-    auto box = cir.get_bounding();
-    return collide(box, 0, [&cir](const IntABox& dst) { return dst.intersect_circle(cir); });
+    mResult.clear();
+    query_circle(cir, mResult);
+    return mResult;
 }
 
 const std::vector<QuadObject*>& QuadTree::collide_sector(const IntSector& sec) {
-    auto box = sec.get_bounding();
-    return collide(box, 0, [&sec](const IntABox& dst) { return dst.intersect_sector(sec); });
+    mResult.clear();
+    query_sector(sec, mResult);
+    return mResult;
 }
 
 const std::vector<QuadObject*>& QuadTree::collide_obox(const IntOBox& obox) {
-    auto box = obox.get_bounding();
-    return collide(box, 0, [&obox](const IntABox& dst) { return dst.intersect_obox(obox); });
+    mResult.clear();
+    query_obox(obox, mResult);
+    return mResult;
 }
 
-bool QuadTree::is_collide_abox(const IntABox& box) { return !collide(box, 1).empty(); }
+bool QuadTree::is_collide_abox(const IntABox& box) {
+    bool found = false;
+    visit_abox(box, [&found](QuadObject*) {
+        found = true;
+        return false;
+    });
+    return found;
+}
 
 bool QuadTree::is_collide_circle(const IntCircle& cir) {
-    auto box = cir.get_bounding();
-    return !collide(box, 1, [&cir](const IntABox& dst) { return dst.intersect_circle(cir); }).empty();
+    bool found = false;
+    visit_circle(cir, [&found](QuadObject*) {
+        found = true;
+        return false;
+    });
+    return found;
 }
 
 bool QuadTree::is_collide_sector(const IntSector& sec) {
-    auto box = sec.get_bounding();
-    return !collide(box, 1, [&sec](const IntABox& dst) { return dst.intersect_sector(sec); }).empty();
+    bool found = false;
+    visit_sector(sec, [&found](QuadObject*) {
+        found = true;
+        return false;
+    });
+    return found;
 }
 
 bool QuadTree::is_collide_obox(const IntOBox& obox) {
-    auto box = obox.get_bounding();
-    return !collide(box, 1, [&obox](const IntABox& dst) { return dst.intersect_obox(obox); }).empty();
+    bool found = false;
+    visit_obox(obox, [&found](QuadObject*) {
+        found = true;
+        return false;
+    });
+    return found;
+}
+
+size_t QuadTree::query_abox(const IntABox& box, std::vector<QuadObject*>& out) {
+    size_t count = out.size();
+    visit_abox(box, [&out](QuadObject* o) {
+        out.push_back(o);
+        return true;
+    });
+    return out.size() - count;
+}
+
+size_t QuadTree::query_circle(const IntCircle& cir, std::vector<QuadObject*>& out) {
+    size_t count = out.size();
+    visit_circle(cir, [&out](QuadObject* o) {
+        out.push_back(o);
+        return true;
+    });
+    return out.size() - count;
+}
+
+size_t QuadTree::query_sector(const IntSector& sec, std::vector<QuadObject*>& out) {
+    size_t count = out.size();
+    visit_sector(sec, [&out](QuadObject* o) {
+        out.push_back(o);
+        return true;
+    });
+    return out.size() - count;
+}
+
+size_t QuadTree::query_obox(const IntOBox& obox, std::vector<QuadObject*>& out) {
+    size_t count = out.size();
+    visit_obox(obox, [&out](QuadObject* o) {
+        out.push_back(o);
+        return true;
+    });
+    return out.size() - count;
+}
+
+size_t QuadTree::knn(const IntPoint& p, size_t k, std::vector<QuadObject*>& out, int32_t radius) {
+    size_t count = 0;
+    if (k == 0) {
+        return count;
+    }
+    visit_nearest(p, radius, [&out, &count, k](QuadObject* o, int64_t) {
+        out.push_back(o);
+        return ++count < k;
+    });
+    return count;
+}
+
+QuadObject* QuadTree::nearest(const IntPoint& p, int32_t radius) {
+    QuadObject* result = nullptr;
+    visit_nearest(p, radius, [&result](QuadObject* o, int64_t) {
+        result = o;
+        return false;
+    });
+    return result;
+}
+
+const std::vector<QuadObject*>& QuadTree::collide_line(const IntLine& line) {
+    mResult.clear();
+    query_line(line, mResult);
+    return mResult;
+}
+
+bool QuadTree::is_collide_line(const IntLine& line) {
+    bool found = false;
+    visit_line(line, [&found](QuadObject*) {
+        found = true;
+        return false;
+    });
+    return found;
+}
+
+size_t QuadTree::query_line(const IntLine& line, std::vector<QuadObject*>& out) {
+    size_t count = out.size();
+    visit_line(line, [&out](QuadObject* o) {
+        out.push_back(o);
+        return true;
+    });
+    return out.size() - count;
+}
+
+bool QuadTree::first_hit_raycast(const IntPoint& from, const IntPoint& to, RayHit& hit) {
+    bool found = false;
+    visit_ray(IntLine{from, to}, [&found, &hit, &from, &to](QuadObject* o, double t) {
+        hit.mObjID = o->mObjID;
+        hit.mDist = t * std::hypot(double(to.mX) - from.mX, double(to.mY) - from.mY);
+        found = true;
+        return false;
+    });
+    return found;
+}
+
+size_t QuadTree::first_hit_raycast_many(const IntLine* rays, size_t count, RayHit* hits) {
+    size_t hitCount = 0;
+    for (size_t i = 0; i < count; ++i) {
+        hits[i] = RayHit{};
+        if (first_hit_raycast(rays[i].mMin, rays[i].mMax, hits[i])) {
+            ++hitCount;
+        }
+    }
+    return hitCount;
 }
 
 int QuadTree::insert(int64_t objID, const IntABox& box) {
@@ -249,7 +425,7 @@ int QuadTree::insert(int64_t objID, const IntABox& box) {
     }
     auto iter = mObjs.find(objID);
     if (iter != mObjs.end()) {
-        mRoot->remove_obj(nullptr, iter->second);
+        mRoot->remove_obj(nullptr, iter->second, iter->second->mABox);
         free_obj(iter->second);
         mObjs.erase(iter);
     }
@@ -268,50 +444,45 @@ int QuadTree::remove(int64_t objID) {
     }
     auto iter = mObjs.find(objID);
     if (iter != mObjs.end()) {
-        mRoot->remove_obj(nullptr, iter->second);
+        mRoot->remove_obj(nullptr, iter->second, iter->second->mABox);
         free_obj(iter->second);
         mObjs.erase(iter);
     }
     return Success;
 }
 
-const std::vector<QuadObject*>& QuadTree::collide(const IntABox& box, size_t limit, const std::function<bool(const IntABox& dst)> check) {
-    mResult.clear();
-    QuadNode* node = mRoot;
-    if (!box.intersect(node->abox())) {
-        return mResult;
+int QuadTree::update(int64_t objID, const IntABox& box) {
+    if (objID <= 0) {
+        return ErrorInvalidArg;
     }
-    std::unordered_set<int64_t> ids;
-    auto& searchCache = use_cache();
-    while (node != nullptr) {
-        for (auto o : node->mObjs) {
-            if (o->mABox.intersect(box) && ids.find(o->mObjID) == ids.end()) {
-                if (check && !check(o->mABox)) {
-                    continue;
-                }
-                mResult.push_back(o);
-                ids.insert(o->mObjID);
-                if (limit != 0 && mResult.size() >= limit) {
-                    return mResult;
-                }
-            }
-        }
-        if (!node->is_leaf()) {
-            for (auto c : node->mChildren) {
-                if (box.intersect(c->mABox)) {
-                    searchCache.push_back(c);
-                }
-            }
-        }
+    auto iter = mObjs.find(objID);
+    if (iter == mObjs.end()) {
+        return insert(objID, box);
+    }
+    QuadObject* obj = iter->second;
+    IntABox oldBox = obj->mABox;
+    obj->mABox = box;
+    mRoot->update_obj(obj, oldBox);
+    return Success;
+}
 
-        if (searchCache.empty()) {
-            node = nullptr;
-        } else {
-            node = searchCache.back();
-            searchCache.pop_back();
-        }
+int QuadTree::snapshot(StaticRectTree& out, uint32_t maxElem) const {
+    std::vector<StaticRectItem> items;
+    items.reserve(mObjs.size());
+    for (auto const& o : mObjs) {
+        items.push_back(StaticRectItem{o.first, o.second->mABox});
     }
-    return mResult;
+    return out.build(std::move(items), maxElem);
+}
+
+bool QuadTree::is_owner(const QuadNode* leaf, const IntPoint& p) const {
+    const IntABox& root = mRoot->mABox;
+    const IntABox& box = leaf->mABox;
+    int32_t x = std::min(std::max(p.mX, root.mMin.mX), root.mMax.mX);
+    int32_t y = std::min(std::max(p.mY, root.mMin.mY), root.mMax.mY);
+    // leaves share edges, count a leaf as half open except on the far edges of the tree
+    return x >= box.mMin.mX && (x < box.mMax.mX || box.mMax.mX == root.mMax.mX) && y >= box.mMin.mY &&
+           (y < box.mMax.mY || box.mMax.mY == root.mMax.mY);
 }
 
 std::vector<QuadNode*>& QuadTree::use_cache() { return mCache; }
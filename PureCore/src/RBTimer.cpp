@@ -36,6 +36,7 @@ void RBTimer::init() {
 void RBTimer::release() {
     mNow = 0;
     mSortTimers.clear();
+    mGroups.clear();
     for (auto iter = mTimers.begin(); iter != mTimers.end(); ++iter) {
         mPool.free(iter->second);
     }
@@ -63,13 +64,14 @@ void RBTimer::update(int64_t delta) {
     }
 }
 
-int64_t RBTimer::add_timer(int32_t timerType, int64_t startTime, int64_t interval, int64_t times, TimerCallback callback, bool nextFromNow) {
+int64_t RBTimer::add_timer(int32_t timerType, int64_t startTime, int64_t interval, int64_t times, TimerCallback callback, bool nextFromNow,
+                           int64_t owner) {
     if (callback == nullptr || times == 0 || startTime + interval <= 0) {
         return 0;
     }
     int64_t timerID = mIDGen.gen_id();
     TimerNode* timer = mPool.get();
-    int err = timer->init(timerID, timerType, mNow + startTime, interval, times, callback, nextFromNow);
+    int err = timer->init(timerID, timerType, mNow + startTime, interval, times, std::move(callback), nextFromNow);
     if (err != Success) {
         mPool.free(timer);
         return 0;
@@ -80,6 +82,7 @@ int64_t RBTimer::add_timer(int32_t timerType, int64_t startTime, int64_t interva
         return 0;
     }
 
+    mGroups.add(timer, owner);
     add_timer_node(timer);
     return timer->get_timer_id();
 }
@@ -94,19 +97,14 @@ bool RBTimer::remove_timer(int64_t timerID) {
         return true;
     }
     mTimers.erase(iter);
-
-    for (auto sortIter = mSortTimers.find(timer->get_next_time());
-         sortIter != mSortTimers.end() && sortIter->second != nullptr && sortIter->second->get_next_time() <= timer->get_next_time(); ++sortIter) {
-        if (sortIter->second->get_timer_id() == timerID) {
-            mSortTimers.erase(sortIter);
-            break;
-        }
-    }
+    mGroups.remove(timer);
+    remove_sort_node(timer);
     mPool.free(timer);
     return true;
 }
 
 void RBTimer::clear_timer() {
+    mGroups.clear();
     for (auto iter = mTimers.begin(); iter != mTimers.end();) {
         mPool.free(iter->second);
         iter = mTimers.erase(iter);
@@ -114,6 +112,26 @@ void RBTimer::clear_timer() {
     mSortTimers.clear();
 }
 
+size_t RBTimer::remove_group(int64_t owner) {
+    size_t count = 0;
+    TimerNode* timer = mGroups.get_front(owner);
+    while (timer != nullptr) {
+        TimerNode* next = timer->get_group_next();
+        ++count;
+        // calling timer is removed after callback return
+        if (!timer->remove_if_calling()) {
+            mGroups.remove(timer);
+            mTimers.erase(timer->get_timer_id());
+            remove_sort_node(timer);
+            mPool.free(timer);
+        }
+        timer = next;
+    }
+    return count;
+}
+
+size_t RBTimer::get_group_count(int64_t owner) const { return mGroups.get_count(owner); }
+
 void RBTimer::add_timer_node(TimerNode* timer) {
     if (timer == nullptr) {
         return;
@@ -121,4 +139,14 @@ void RBTimer::add_timer_node(TimerNode* timer) {
     mSortTimers.insert(std::make_pair(timer->get_next_time(), timer));
 }
 
+void RBTimer::remove_sort_node(TimerNode* timer) {
+    for (auto sortIter = mSortTimers.find(timer->get_next_time());
+         sortIter != mSortTimers.end() && sortIter->second != nullptr && sortIter->second->get_next_time() <= timer->get_next_time(); ++sortIter) {
+        if (sortIter->second == timer) {
+            mSortTimers.erase(sortIter);
+            break;
+        }
+    }
+}
+
 }  // namespace PureCore
\ No newline at end of file
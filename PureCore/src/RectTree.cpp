@@ -22,6 +22,7 @@
 
 #include "PureCore/RectTree.h"
 #include "PureCore/CoreErrorDesc.h"
+#include "PureCore/StaticRectTree.h"
 
 #include <algorithm>
 #include <cmath>
@@ -45,9 +46,12 @@ const IntABox& RectNode::abox() const { return mABox; }
 
 int64_t RectNode::obj_id() const { return mObjID; }
 
-void RectNode::set_obj(int64_t objID, const IntABox& box) {
+const IntABox& RectNode::obj_abox() const { return mObjBox; }
+
+void RectNode::set_obj(int64_t objID, const IntABox& box, const IntABox& fatBox) {
     mObjID = objID;
-    mABox = box;
+    mABox = fatBox;
+    mObjBox = box;
 }
 
 void RectNode::check_objs(std::vector<RectNode*>& result, size_t limit, const std::function<bool(const IntABox& dst)>& check) {
@@ -56,7 +60,7 @@ void RectNode::check_objs(std::vector<RectNode*>& result, size_t limit, const st
     while (node != nullptr) {
         if (node->mLeaf) {
             for (auto c : node->mChildren) {
-                if (check && !check(c->mABox)) {
+                if (check && !check(c->mObjBox)) {
                     continue;
                 }
                 result.push_back(c);
@@ -123,6 +127,13 @@ RectNode* RectNode::get_child(size_t idx) {
 
 void RectNode::calc_abox() { mABox = dist_abox(0, mChildren.size()); }
 
+void RectNode::sync_boxes() {
+    mChildBoxes.clear();
+    for (auto c : mChildren) {
+        mChildBoxes.push_back(c->mABox);
+    }
+}
+
 IntABox RectNode::dist_abox(size_t s, size_t e) {
     IntABox box{INT32_MAX, INT32_MAX, INT32_MIN, INT32_MIN};
     for (size_t i = s; i < e && i < mChildren.size(); ++i) {
@@ -229,44 +240,177 @@ void RectTree::clear() {
     mCacheIndexes.clear();
 }
 
+void RectTree::set_fatten(int32_t margin) { mFatten = std::max(int32_t(0), margin); }
+
+int32_t RectTree::get_fatten() const { return mFatten; }
+
 const std::vector<RectNode*>& RectTree::all_objs() {
     mResult.clear();
     mRoot->check_objs(mResult, 0, std::function<bool(const IntABox&)>());
     return mResult;
 }
 
-const std::vector<RectNode*>& RectTree::collide_abox(const IntABox& box) { return collide(box, 0); }
+const std::vector<RectNode*>& RectTree::collide_abox(const IntABox& box) {
+    mResult.clear();
+    query_abox(box, mResult);
+    return mResult;
+}
 
 const std::vector<RectNode*>& RectTree::collide_circle(const IntCircle& cir) {
-    auto box = cir.get_bounding();
-    return collide(box, 0, [&cir](const IntABox& dst) { return dst.intersect_circle(cir); });
+    mResult.clear();
+    query_circle(cir, mResult);
+    return mResult;
 }
 
 const std::vector<RectNode*>& RectTree::collide_sector(const IntSector& sec) {
-    auto box = sec.get_bounding();
-    return collide(box, 0, [&sec](const IntABox& dst) { return dst.intersect_sector(sec); });
+    mResult.clear();
+    query_sector(sec, mResult);
+    return mResult;
 }
 
 const std::vector<RectNode*>& RectTree::collide_obox(const IntOBox& obox) {
-    auto box = obox.get_bounding();
-    return collide(box, 0, [&obox](const IntABox& dst) { return dst.intersect_obox(obox); });
+    mResult.clear();
+    query_obox(obox, mResult);
+    return mResult;
 }
 
-bool RectTree::is_collide_abox(const IntABox& box) { return !collide(box, 1).empty(); }
+bool RectTree::is_collide_abox(const IntABox& box) {
+    bool found = false;
+    visit_abox(box, [&found](RectNode*) {
+        found = true;
+        return false;
+    });
+    return found;
+}
 
 bool RectTree::is_collide_circle(const IntCircle& cir) {
-    auto box = cir.get_bounding();
-    return !collide(box, 1, [&cir](const IntABox& dst) { return dst.intersect_circle(cir); }).empty();
+    bool found = false;
+    visit_circle(cir, [&found](RectNode*) {
+        found = true;
+        return false;
+    });
+    return found;
 }
 
 bool RectTree::is_collide_sector(const IntSector& sec) {
-    auto box = sec.get_bounding();
-    return !collide(box, 1, [&sec](const IntABox& dst) { return dst.intersect_sector(sec); }).empty();
+    bool found = false;
+    visit_sector(sec, [&found](RectNode*) {
+        found = true;
+        return false;
+    });
+    return found;
 }
 
 bool RectTree::is_collide_obox(const IntOBox& obox) {
-    auto box = obox.get_bounding();
-    return !collide(box, 1, [&obox](const IntABox& dst) { return dst.intersect_obox(obox); }).empty();
+    bool found = false;
+    visit_obox(obox, [&found](RectNode*) {
+        found = true;
+        return false;
+    });
+    return found;
+}
+
+size_t RectTree::query_abox(const IntABox& box, std::vector<RectNode*>& out) {
+    size_t count = out.size();
+    visit_abox(box, [&out](RectNode* o) {
+        out.push_back(o);
+        return true;
+    });
+    return out.size() - count;
+}
+
+size_t RectTree::query_circle(const IntCircle& cir, std::vector<RectNode*>& out) {
+    size_t count = out.size();
+    visit_circle(cir, [&out](RectNode* o) {
+        out.push_back(o);
+        return true;
+    });
+    return out.size() - count;
+}
+
+size_t RectTree::query_sector(const IntSector& sec, std::vector<RectNode*>& out) {
+    size_t count = out.size();
+    visit_sector(sec, [&out](RectNode* o) {
+        out.push_back(o);
+        return true;
+    });
+    return out.size() - count;
+}
+
+size_t RectTree::query_obox(const IntOBox& obox, std::vector<RectNode*>& out) {
+    size_t count = out.size();
+    visit_obox(obox, [&out](RectNode* o) {
+        out.push_back(o);
+        return true;
+    });
+    return out.size() - count;
+}
+
+size_t RectTree::knn(const IntPoint& p, size_t k, std::vector<RectNode*>& out, int32_t radius) {
+    size_t count = 0;
+    if (k == 0) {
+        return count;
+    }
+    visit_nearest(p, radius, [&out, &count, k](RectNode* o, int64_t) {
+        out.push_back(o);
+        return ++count < k;
+    });
+    return count;
+}
+
+RectNode* RectTree::nearest(const IntPoint& p, int32_t radius) {
+    RectNode* result = nullptr;
+    visit_nearest(p, radius, [&result](RectNode* o, int64_t) {
+        result = o;
+        return false;
+    });
+    return result;
+}
+
+const std::vector<RectNode*>& RectTree::collide_line(const IntLine& line) {
+    mResult.clear();
+    query_line(line, mResult);
+    return mResult;
+}
+
+bool RectTree::is_collide_line(const IntLine& line) {
+    bool found = false;
+    visit_line(line, [&found](RectNode*) {
+        found = true;
+        return false;
+    });
+    return found;
+}
+
+size_t RectTree::query_line(const IntLine& line, std::vector<RectNode*>& out) {
+    size_t count = out.size();
+    visit_line(line, [&out](RectNode* o) {
+        out.push_back(o);
+        return true;
+    });
+    return out.size() - count;
+}
+
+bool RectTree::first_hit_raycast(const IntPoint& from, const IntPoint& to, RayHit& hit) {
+    bool found = false;
+    visit_ray(IntLine{from, to}, [&found, &hit, &from, &to](RectNode* o, double t) {
+        hit.mObjID = o->mObjID;
+        hit.mDist = t * std::hypot(double(to.mX) - from.mX, double(to.mY) - from.mY);
+        found = true;
+        return false;
+    });
+    return found;
+}
+
+size_t RectTree::first_hit_raycast_many(const IntLine* rays, size_t count, RayHit* hits) {
+    size_t hitCount = 0;
+    for (size_t i = 0; i < count; ++i) {
+        hits[i] = RayHit{};
+        if (first_hit_raycast(rays[i].mMin, rays[i].mMax, hits[i])) {
+            ++hitCount;
+        }
+    }
+    return hitCount;
 }
 
 int RectTree::insert(int64_t objID, const IntABox& box) {
@@ -275,18 +419,20 @@ int RectTree::insert(int64_t objID, const IntABox& box) {
     }
     auto iter = mObjs.find(objID);
     if (iter != mObjs.end()) {
+        auto node = iter->second;
         mObjs.erase(iter);
-        remove_node(iter->second);
+        remove_node(node);
     }
     int32_t depth = mRoot->mDepth - 1;
     auto& insertPath = use_cache();
 
-    RectNode* node = mRoot->choose_subtree(box, depth, insertPath);
+    auto fatBox = box.expand(mFatten);
+    RectNode* node = mRoot->choose_subtree(fatBox, depth, insertPath);
     auto newNode = get_node();
-    newNode->set_obj(objID, box);
+    newNode->set_obj(objID, box, fatBox);
     mObjs.insert(std::make_pair(objID, newNode));
     node->mChildren.push_back(newNode);
-    node->extend(box);
+    node->extend(fatBox);
     while (depth >= 0 && depth < insertPath.size()) {
         if (insertPath[depth]->mChildren.size() > mMaxElem) {
             split(insertPath, depth);
@@ -296,7 +442,10 @@ int RectTree::insert(int64_t objID, const IntABox& box) {
         }
     }
     for (int32_t i = depth; i >= 0 && i < insertPath.size(); --i) {
-        insertPath[i]->extend(box);
+        insertPath[i]->extend(fatBox);
+    }
+    for (auto n : insertPath) {
+        n->sync_boxes();
     }
 
     unuse_cache();
@@ -316,42 +465,45 @@ int RectTree::remove(int64_t objID) {
     return Success;
 }
 
-const std::vector<RectNode*>& RectTree::collide(const IntABox& box, size_t limit, const std::function<bool(const IntABox& dst)> check) {
-    mResult.clear();
-    RectNode* node = mRoot;
-    if (!box.intersect(node->abox())) {
-        return mResult;
+int RectTree::update(int64_t objID, const IntABox& box) {
+    if (objID <= 0) {
+        return ErrorInvalidArg;
     }
-    auto& searchCache = use_cache();
-    while (node != nullptr) {
-        for (auto c : node->mChildren) {
-            if (box.intersect(c->mABox)) {
-                if (node->mLeaf) {
-                    if (check && !check(c->mABox)) {
-                        continue;
-                    }
-                    mResult.push_back(c);
-                } else if (box.contain(c->abox())) {
-                    c->check_objs(mResult, limit, check);
-                } else {
-                    searchCache.push_back(c);
-                }
-                if (limit != 0 && mResult.size() >= limit) {
-                    unuse_cache();
-                    return mResult;
-                }
-            }
-        }
-
-        if (searchCache.empty()) {
-            node = nullptr;
-        } else {
-            node = searchCache.back();
-            searchCache.pop_back();
+    auto iter = mObjs.find(objID);
+    if (iter == mObjs.end()) {
+        return insert(objID, box);
+    }
+    auto item = iter->second;
+    // small move inside the fattened box
+    if (item->mABox.contain(box)) {
+        item->mObjBox = box;
+        return Success;
+    }
+    auto fatBox = box.expand(mFatten);
+    auto& path = use_cache();
+    if (find_path(item, path) && path.back()->mABox.contain(fatBox)) {
+        // still fits the leaf, boxes on the path can only shrink
+        item->set_obj(objID, box, fatBox);
+        for (int64_t i = int64_t(path.size()) - 1; i >= 0; --i) {
+            path[i]->calc_abox();
+            path[i]->sync_boxes();
         }
+        unuse_cache();
+        return Success;
     }
     unuse_cache();
-    return mResult;
+    mObjs.erase(iter);
+    remove_node(item);
+    return insert(objID, box);
+}
+
+int RectTree::snapshot(StaticRectTree& out, uint32_t maxElem) const {
+    std::vector<StaticRectItem> items;
+    items.reserve(mObjs.size());
+    for (auto const& o : mObjs) {
+        items.push_back(StaticRectItem{o.first, o.second->mObjBox});
+    }
+    return out.build(std::move(items), maxElem);
 }
 
 std::vector<RectNode*>& RectTree::use_cache() {
@@ -362,10 +514,10 @@ std::vector<RectNode*>& RectTree::use_cache() {
 }
 
 void RectTree::unuse_cache() {
-    if (mCacheNext >= mCache.size()) {
+    if (mCacheNext == 0 || mCacheNext > mCache.size()) {
         return;
     }
-    mCache[mCacheNext--].clear();
+    mCache[--mCacheNext].clear();
 }
 
 RectNode* RectTree::get_node() { return mPool.get(this); }
@@ -382,6 +534,7 @@ void RectTree::split(const std::vector<RectNode*>& insertPath, int32_t depth) {
     node->split_children(splitIndex, int64_t(node->mChildren.size()) - splitIndex, newNode);
     node->calc_abox();
     newNode->calc_abox();
+    newNode->sync_boxes();
     if (depth > 0) {
         insertPath[depth - 1]->mChildren.push_back(newNode);
     } else {
@@ -393,69 +546,61 @@ void RectTree::split(const std::vector<RectNode*>& insertPath, int32_t depth) {
         newRoot->mChildren.push_back(newNode);
         mRoot = newRoot;
         mRoot->calc_abox();
+        mRoot->sync_boxes();
     }
 }
 
-int RectTree::remove_node(RectNode* item) {
-    if (item == nullptr) {
-        return ErrorInvalidArg;
-    }
-
-    auto node = mRoot;
-    auto& path = use_cache();
+// path from root to the leaf holding item, descend only into boxes containing item
+bool RectTree::find_path(RectNode* item, std::vector<RectNode*>& path) {
     auto& indexes = mCacheIndexes;
     indexes.clear();
-    RectNode* parent = nullptr;
-    bool goingUp = false;
-    int64_t i = 0;
-    while (node != nullptr || !path.empty()) {
-        if (node == nullptr) {  // up
-            node = path.back();
+    path.clear();
+    path.push_back(mRoot);
+    indexes.push_back(0);
+    while (!path.empty()) {
+        auto node = path.back();
+        if (node->mLeaf) {
+            if (std::find(node->mChildren.begin(), node->mChildren.end(), item) != node->mChildren.end()) {
+                indexes.clear();
+                return true;
+            }
             path.pop_back();
-            parent = path.back();
-            i = indexes.back();
             indexes.pop_back();
-            goingUp = true;
+            continue;
         }
-        if (node->mLeaf) {  // current
-            for (size_t i = 0; i < node->mChildren.size(); ++i) {
-                if (node->mChildren[i]->mObjID == item->mObjID) {
-                    // found and remove
-                    free_node(node->mChildren[i]);
-                    node->mChildren[i] = node->mChildren.back();
-                    node->mChildren.pop_back();
-                    // merge
-                    path.push_back(node);
-                    merge_node(path);
-                    indexes.clear();
-                    unuse_cache();
-                    return Success;
-                }
+        RectNode* next = nullptr;
+        while (indexes.back() < int64_t(node->mChildren.size())) {
+            auto c = node->mChildren[indexes.back()++];
+            if (c->abox().contain(item->abox())) {
+                next = c;
+                break;
             }
         }
-        if (!goingUp && !node->mLeaf && node->abox().contain(item->abox())) {  // down
-            path.push_back(node);
-            indexes.push_back(i);
-            i = 0;
-            parent = node;
-            if (node->mChildren.empty()) {
-                node = nullptr;
-            } else {
-                node = node->mChildren[0];
-            }
-        } else if (parent != nullptr) {  // right
-            i++;
-            if (i >= int64_t(parent->mChildren.size())) {
-                node = nullptr;
-            } else {
-                node = parent->mChildren[i];
-            }
-            goingUp = false;
+        if (next != nullptr) {
+            path.push_back(next);
+            indexes.push_back(0);
         } else {
-            node = nullptr;
+            path.pop_back();
+            indexes.pop_back();
         }
     }
     indexes.clear();
+    return false;
+}
+
+int RectTree::remove_node(RectNode* item) {
+    if (item == nullptr) {
+        return ErrorInvalidArg;
+    }
+    auto& path = use_cache();
+    if (find_path(item, path)) {
+        auto& children = path.back()->mChildren;
+        auto iter = std::find(children.begin(), children.end(), item);
+        free_node(item);
+        *iter = children.back();
+        children.pop_back();
+        merge_node(path);
+    }
     unuse_cache();
     return Success;
 }
@@ -481,6 +626,7 @@ void RectTree::merge_node(const std::vector<RectNode*>& path) {
             }
         } else {
             path[i]->calc_abox();
+            path[i]->sync_boxes();
         }
     }
 }
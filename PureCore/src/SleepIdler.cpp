@@ -21,6 +21,7 @@
  */
 
 #include "PureCore/SleepIdler.h"
+#include "PureCore/Channel.h"
 #include "PureCore/OsHelper.h"
 #include "PureCore/PureLog.h"
 
@@ -44,6 +45,10 @@ bool SleepIdler::set_offset(int64_t ms) {
 
 int64_t SleepIdler::get_offset() const { return mOffset; }
 
+void SleepIdler::set_waker(ChannelWaker* waker) { mWaker = waker; }
+
+ChannelWaker* SleepIdler::get_waker() const { return mWaker; }
+
 void SleepIdler::frame_begin() { mStart = this->now(); }
 
 int64_t SleepIdler::frame_check(int64_t needDelta) {
@@ -68,6 +73,10 @@ void SleepIdler::frame_end(int64_t suggestDelta) {
         PureCore::yeild();
         return;
     }
+    if (mWaker != nullptr) {
+        mWaker->wait(suggestDelta - checkDelta);
+        return;
+    }
     if (mIdleDelay <= 0 || now - mIdle > mIdleDelay) {
         int64_t s = std::min(int64_t(5), suggestDelta - checkDelta);
         PureCore::sleep(s);
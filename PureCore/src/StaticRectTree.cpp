@@ -0,0 +1,467 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "PureCore/StaticRectTree.h"
+#include "PureCore/CoreErrorDesc.h"
+#include "PureCore/OsHelper.h"
+#include "PureCore/Buffer/DynamicBuffer.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace PureCore {
+static const uint32_t sStaticRectMagic = 0x54535250;  // "PRST"
+static const uint32_t sStaticRectVersion = 1;
+
+// file image: header, nodes, items. all native endian, the magic check rejects a foreign byte order
+struct StaticRectHeader {
+    uint32_t mMagic;
+    uint32_t mVersion;
+    uint64_t mNodeCount;
+    uint64_t mLeafCount;
+    uint64_t mItemCount;
+};
+
+static_assert(sizeof(StaticRectHeader) == 32, "StaticRectHeader must have no padding");
+static_assert(sizeof(StaticRectNode) == 24, "StaticRectNode must have no padding");
+static_assert(sizeof(StaticRectItem) == 24, "StaticRectItem must have no padding");
+
+template <typename T>
+static IntABox union_abox(const T* arr, size_t count) {
+    IntABox box{INT32_MAX, INT32_MAX, INT32_MIN, INT32_MIN};
+    for (size_t i = 0; i < count; ++i) {
+        box.mMin.mX = std::min(box.mMin.mX, arr[i].mABox.mMin.mX);
+        box.mMin.mY = std::min(box.mMin.mY, arr[i].mABox.mMin.mY);
+        box.mMax.mX = std::max(box.mMax.mX, arr[i].mABox.mMax.mX);
+        box.mMax.mY = std::max(box.mMax.mY, arr[i].mABox.mMax.mY);
+    }
+    return box;
+}
+
+// order [begin, end) only as far as cutting it into runs of groupSize needs, each run holds the right elements unsorted
+template <typename Iter, typename Compare>
+static void partition_groups(Iter begin, Iter end, size_t groupSize, Compare cmp) {
+    while (size_t(end - begin) > groupSize) {
+        size_t groups = (size_t(end - begin) + groupSize - 1) / groupSize;
+        Iter mid = begin + (groups / 2) * groupSize;
+        std::nth_element(begin, mid, end, cmp);
+        partition_groups(begin, mid, groupSize, cmp);
+        begin = mid;
+    }
+}
+
+// sort tile recursive: cut by center x into sqrt(leaf count) slices, then cut every slice by center y into nodes
+template <typename T>
+static void str_sort(std::vector<T>& arr, size_t maxElem) {
+    size_t leafs = (arr.size() + maxElem - 1) / maxElem;
+    size_t sliceSize = size_t(std::ceil(std::sqrt(double(leafs)))) * maxElem;
+    partition_groups(arr.begin(), arr.end(), sliceSize, [](const T& a, const T& b) {
+        return int64_t(a.mABox.mMin.mX) + a.mABox.mMax.mX < int64_t(b.mABox.mMin.mX) + b.mABox.mMax.mX;
+    });
+    for (size_t s = 0; s < arr.size(); s += sliceSize) {
+        size_t e = std::min(arr.size(), s + sliceSize);
+        partition_groups(arr.begin() + s, arr.begin() + e, maxElem, [](const T& a, const T& b) {
+            return int64_t(a.mABox.mMin.mY) + a.mABox.mMax.mY < int64_t(b.mABox.mMin.mY) + b.mABox.mMax.mY;
+        });
+    }
+}
+
+template <typename T>
+static void str_pack(const std::vector<T>& arr, size_t maxElem, std::vector<StaticRectNode>& out) {
+    out.clear();
+    for (size_t s = 0; s < arr.size(); s += maxElem) {
+        size_t count = std::min(maxElem, arr.size() - s);
+        out.push_back(StaticRectNode{union_abox(arr.data() + s, count), uint32_t(s), uint32_t(count)});
+    }
+}
+
+void StaticRectTree::clear() {
+    mNodes = nullptr;
+    mNodeCount = 0;
+    mLeafCount = 0;
+    mItems = nullptr;
+    mItemCount = 0;
+    mOwnNodes.clear();
+    mOwnItems.clear();
+    mResult.clear();
+}
+
+int StaticRectTree::build(std::vector<StaticRectItem> items, uint32_t maxElem) {
+    if (items.size() >= UINT32_MAX) {
+        return ErrorInvalidArg;
+    }
+    clear();
+    if (items.empty()) {
+        return Success;
+    }
+    size_t maxCount = std::max(uint32_t(4), maxElem);
+    // levels[0] are leaves over items, levels[k] point into levels[k - 1]
+    std::vector<std::vector<StaticRectNode>> levels(1);
+    str_sort(items, maxCount);
+    str_pack(items, maxCount, levels[0]);
+    while (levels.back().size() > 1) {
+        str_sort(levels.back(), maxCount);
+        std::vector<StaticRectNode> upper;
+        str_pack(levels.back(), maxCount, upper);
+        levels.push_back(std::move(upper));
+    }
+
+    // lay the levels out top down so the children of every level are contiguous,
+    // then store them bottom up with leaves first and the root last
+    std::vector<std::vector<uint32_t>> orders(levels.size());
+    orders.back().push_back(0);
+    for (size_t k = levels.size() - 1; k > 0; --k) {
+        for (auto idx : orders[k]) {
+            auto& node = levels[k][idx];
+            for (uint32_t c = node.mFirst; c < node.mFirst + node.mCount; ++c) {
+                orders[k - 1].push_back(c);
+            }
+        }
+    }
+    mOwnItems.reserve(items.size());
+    for (size_t k = 0; k < levels.size(); ++k) {
+        uint32_t next = k == 0 ? 0 : uint32_t(mOwnNodes.size() - levels[k - 1].size());
+        for (auto idx : orders[k]) {
+            StaticRectNode node = levels[k][idx];
+            if (k == 0) {
+                mOwnItems.insert(mOwnItems.end(), items.begin() + node.mFirst, items.begin() + node.mFirst + node.mCount);
+            }
+            node.mFirst = next;
+            next += node.mCount;
+            mOwnNodes.push_back(node);
+        }
+    }
+    mNodes = mOwnNodes.data();
+    mNodeCount = mOwnNodes.size();
+    mLeafCount = levels[0].size();
+    mItems = mOwnItems.data();
+    mItemCount = mOwnItems.size();
+    return Success;
+}
+
+int StaticRectTree::save(const char* path) const {
+    StaticRectHeader header{sStaticRectMagic, sStaticRectVersion, mNodeCount, mLeafCount, mItemCount};
+    std::vector<char> image(sizeof(header) + mNodeCount * sizeof(StaticRectNode) + mItemCount * sizeof(StaticRectItem));
+    char* pos = image.data();
+    memcpy(pos, &header, sizeof(header));
+    pos += sizeof(header);
+    if (mNodeCount > 0) {
+        memcpy(pos, mNodes, mNodeCount * sizeof(StaticRectNode));
+        pos += mNodeCount * sizeof(StaticRectNode);
+        memcpy(pos, mItems, mItemCount * sizeof(StaticRectItem));
+    }
+    return write_file(DataRef(image.data(), image.size()), path);
+}
+
+int StaticRectTree::load(const char* path) {
+    clear();
+    DynamicBuffer buffer;
+    int err = read_file(buffer, path);
+    if (err != Success) {
+        return err;
+    }
+    DataRef data = buffer.data();
+    StaticRectHeader header{};
+    if (data.size() < sizeof(header)) {
+        return ErrorInvalidData;
+    }
+    memcpy(&header, data.data(), sizeof(header));
+    if (header.mMagic != sStaticRectMagic || header.mVersion != sStaticRectVersion || header.mNodeCount >= UINT32_MAX ||
+        header.mItemCount >= UINT32_MAX ||
+        data.size() != sizeof(header) + header.mNodeCount * sizeof(StaticRectNode) + header.mItemCount * sizeof(StaticRectItem)) {
+        return ErrorInvalidData;
+    }
+    const char* pos = data.data() + sizeof(header);
+    mOwnNodes.resize(header.mNodeCount);
+    mOwnItems.resize(header.mItemCount);
+    if (header.mNodeCount > 0) {
+        memcpy(mOwnNodes.data(), pos, header.mNodeCount * sizeof(StaticRectNode));
+        memcpy(mOwnItems.data(), pos + header.mNodeCount * sizeof(StaticRectNode), header.mItemCount * sizeof(StaticRectItem));
+    }
+    mNodes = mOwnNodes.data();
+    mNodeCount = mOwnNodes.size();
+    mLeafCount = header.mLeafCount;
+    mItems = mOwnItems.data();
+    mItemCount = mOwnItems.size();
+    err = check_layout();
+    if (err != Success) {
+        clear();
+    }
+    return err;
+}
+
+int StaticRectTree::attach(const void* data, size_t size) {
+    clear();
+    if (data == nullptr) {
+        return ErrorNullPointer;
+    }
+    if (reinterpret_cast<uintptr_t>(data) % alignof(StaticRectItem) != 0) {
+        return ErrorInvalidArg;
+    }
+    StaticRectHeader header{};
+    if (size < sizeof(header)) {
+        return ErrorInvalidData;
+    }
+    memcpy(&header, data, sizeof(header));
+    if (header.mMagic != sStaticRectMagic || header.mVersion != sStaticRectVersion || header.mNodeCount >= UINT32_MAX ||
+        header.mItemCount >= UINT32_MAX || size != sizeof(header) + header.mNodeCount * sizeof(StaticRectNode) + header.mItemCount * sizeof(StaticRectItem)) {
+        return ErrorInvalidData;
+    }
+    const char* pos = static_cast<const char*>(data) + sizeof(header);
+    mNodes = reinterpret_cast<const StaticRectNode*>(pos);
+    mNodeCount = size_t(header.mNodeCount);
+    mLeafCount = size_t(header.mLeafCount);
+    mItems = reinterpret_cast<const StaticRectItem*>(pos + header.mNodeCount * sizeof(StaticRectNode));
+    mItemCount = size_t(header.mItemCount);
+    int err = check_layout();
+    if (err != Success) {
+        clear();
+    }
+    return err;
+}
+
+// a loaded image is trusted only when leaves tile the items and inner nodes tile the nodes below them in order,
+// so every query walks a real tree
+int StaticRectTree::check_layout() const {
+    if ((mNodeCount == 0) != (mItemCount == 0) || mLeafCount > mNodeCount || (mNodeCount > 0 && mLeafCount == 0)) {
+        return ErrorInvalidData;
+    }
+    uint64_t nextItem = 0;
+    uint64_t nextNode = 0;
+    for (size_t i = 0; i < mNodeCount; ++i) {
+        const StaticRectNode& node = mNodes[i];
+        if (node.mCount == 0) {
+            return ErrorInvalidData;
+        }
+        if (i < mLeafCount) {
+            if (node.mFirst != nextItem) {
+                return ErrorInvalidData;
+            }
+            nextItem += node.mCount;
+        } else {
+            if (node.mFirst != nextNode || nextNode + node.mCount > i) {
+                return ErrorInvalidData;
+            }
+            nextNode += node.mCount;
+        }
+    }
+    if (nextItem != mItemCount || (mNodeCount > 0 && nextNode != mNodeCount - 1)) {
+        return ErrorInvalidData;
+    }
+    return Success;
+}
+
+std::vector<uint32_t>& StaticRectTree::thread_stack() {
+    static thread_local std::vector<uint32_t> tlStack;
+    return tlStack;
+}
+
+std::vector<StaticRectTree::NearItem>& StaticRectTree::thread_heap() {
+    static thread_local std::vector<NearItem> tlHeap;
+    return tlHeap;
+}
+
+std::vector<StaticRectTree::RayItem>& StaticRectTree::thread_ray_heap() {
+    static thread_local std::vector<RayItem> tlRayHeap;
+    return tlRayHeap;
+}
+
+size_t StaticRectTree::size() const { return mItemCount; }
+
+const StaticRectItem* StaticRectTree::items() const { return mItems; }
+
+size_t StaticRectTree::node_size() const { return mNodeCount; }
+
+const StaticRectNode* StaticRectTree::nodes() const { return mNodes; }
+
+const std::vector<const StaticRectItem*>& StaticRectTree::all_objs() {
+    mResult.clear();
+    for (size_t i = 0; i < mItemCount; ++i) {
+        mResult.push_back(mItems + i);
+    }
+    return mResult;
+}
+
+const std::vector<const StaticRectItem*>& StaticRectTree::collide_abox(const IntABox& box) {
+    mResult.clear();
+    query_abox(box, mResult);
+    return mResult;
+}
+
+const std::vector<const StaticRectItem*>& StaticRectTree::collide_circle(const IntCircle& cir) {
+    mResult.clear();
+    query_circle(cir, mResult);
+    return mResult;
+}
+
+const std::vector<const StaticRectItem*>& StaticRectTree::collide_sector(const IntSector& sec) {
+    mResult.clear();
+    query_sector(sec, mResult);
+    return mResult;
+}
+
+const std::vector<const StaticRectItem*>& StaticRectTree::collide_obox(const IntOBox& obox) {
+    mResult.clear();
+    query_obox(obox, mResult);
+    return mResult;
+}
+
+bool StaticRectTree::is_collide_abox(const IntABox& box) const {
+    bool found = false;
+    visit_abox(box, [&found](const StaticRectItem*) {
+        found = true;
+        return false;
+    });
+    return found;
+}
+
+bool StaticRectTree::is_collide_circle(const IntCircle& cir) const {
+    bool found = false;
+    visit_circle(cir, [&found](const StaticRectItem*) {
+        found = true;
+        return false;
+    });
+    return found;
+}
+
+bool StaticRectTree::is_collide_sector(const IntSector& sec) const {
+    bool found = false;
+    visit_sector(sec, [&found](const StaticRectItem*) {
+        found = true;
+        return false;
+    });
+    return found;
+}
+
+bool StaticRectTree::is_collide_obox(const IntOBox& obox) const {
+    bool found = false;
+    visit_obox(obox, [&found](const StaticRectItem*) {
+        found = true;
+        return false;
+    });
+    return found;
+}
+
+size_t StaticRectTree::query_abox(const IntABox& box, std::vector<const StaticRectItem*>& out) const {
+    size_t count = out.size();
+    visit_abox(box, [&out](const StaticRectItem* o) {
+        out.push_back(o);
+        return true;
+    });
+    return out.size() - count;
+}
+
+size_t StaticRectTree::query_circle(const IntCircle& cir, std::vector<const StaticRectItem*>& out) const {
+    size_t count = out.size();
+    visit_circle(cir, [&out](const StaticRectItem* o) {
+        out.push_back(o);
+        return true;
+    });
+    return out.size() - count;
+}
+
+size_t StaticRectTree::query_sector(const IntSector& sec, std::vector<const StaticRectItem*>& out) const {
+    size_t count = out.size();
+    visit_sector(sec, [&out](const StaticRectItem* o) {
+        out.push_back(o);
+        return true;
+    });
+    return out.size() - count;
+}
+
+size_t StaticRectTree::query_obox(const IntOBox& obox, std::vector<const StaticRectItem*>& out) const {
+    size_t count = out.size();
+    visit_obox(obox, [&out](const StaticRectItem* o) {
+        out.push_back(o);
+        return true;
+    });
+    return out.size() - count;
+}
+
+size_t StaticRectTree::knn(const IntPoint& p, size_t k, std::vector<const StaticRectItem*>& out, int32_t radius) const {
+    size_t count = 0;
+    if (k == 0) {
+        return count;
+    }
+    visit_nearest(p, radius, [&out, &count, k](const StaticRectItem* o, int64_t) {
+        out.push_back(o);
+        return ++count < k;
+    });
+    return count;
+}
+
+const StaticRectItem* StaticRectTree::nearest(const IntPoint& p, int32_t radius) const {
+    const StaticRectItem* result = nullptr;
+    visit_nearest(p, radius, [&result](const StaticRectItem* o, int64_t) {
+        result = o;
+        return false;
+    });
+    return result;
+}
+
+const std::vector<const StaticRectItem*>& StaticRectTree::collide_line(const IntLine& line) {
+    mResult.clear();
+    query_line(line, mResult);
+    return mResult;
+}
+
+bool StaticRectTree::is_collide_line(const IntLine& line) const {
+    bool found = false;
+    visit_line(line, [&found](const StaticRectItem*) {
+        found = true;
+        return false;
+    });
+    return found;
+}
+
+size_t StaticRectTree::query_line(const IntLine& line, std::vector<const StaticRectItem*>& out) const {
+    size_t count = out.size();
+    visit_line(line, [&out](const StaticRectItem* o) {
+        out.push_back(o);
+        return true;
+    });
+    return out.size() - count;
+}
+
+bool StaticRectTree::first_hit_raycast(const IntPoint& from, const IntPoint& to, RayHit& hit) const {
+    bool found = false;
+    visit_ray(IntLine{from, to}, [&found, &hit, &from, &to](const StaticRectItem* o, double t) {
+        hit.mObjID = o->mObjID;
+        hit.mDist = t * std::hypot(double(to.mX) - from.mX, double(to.mY) - from.mY);
+        found = true;
+        return false;
+    });
+    return found;
+}
+
+size_t StaticRectTree::first_hit_raycast_many(const IntLine* rays, size_t count, RayHit* hits) const {
+    size_t hitCount = 0;
+    for (size_t i = 0; i < count; ++i) {
+        hits[i] = RayHit{};
+        if (first_hit_raycast(rays[i].mMin, rays[i].mMax, hits[i])) {
+            ++hitCount;
+        }
+    }
+    return hitCount;
+}
+
+}  // namespace PureCore
@@ -102,7 +102,7 @@ bool TimerWheel::is_next_wheel() const { return (mNow / mStepInterval) % mStepCo
 ///////////////////////////////////////////////////////////////////////////
 // TWTimer
 //////////////////////////////////////////////////////////////////////////
-TWTimer::TWTimer() : mNow(0), mOverflowWheel(), mTimers(), mIDGen(), mPool() {}
+TWTimer::TWTimer() : mNow(0), mOverflowWheel(), mTimers(), mIDGen(), mPool("TWTimerNode") {}
 
 TWTimer::~TWTimer() { release(); }
 
@@ -129,6 +129,9 @@ void TWTimer::release() {
         mWheels[i].release();
     }
     mOverflowWheel.clear();
+    mBatches.clear();
+    mBatchCallbacks.clear();
+    mGroups.clear();
     for (auto iter = mTimers.begin(); iter != mTimers.end(); ++iter) {
         mPool.free(iter->second);
     }
@@ -150,15 +153,17 @@ void TWTimer::update(int64_t delta) {
         try_trigger_timer(timerStep);
     }
     try_trigger_timer(mWheels[0].get_current_step());
+    try_trigger_batch();
 }
 
-int64_t TWTimer::add_timer(int32_t timerType, int64_t startTime, int64_t interval, int64_t times, TimerCallback callback, bool nextFromNow) {
+int64_t TWTimer::add_timer(int32_t timerType, int64_t startTime, int64_t interval, int64_t times, TimerCallback callback, bool nextFromNow,
+                           int64_t owner) {
     if (callback == nullptr || times == 0 || startTime + interval <= 0) {
         return 0;
     }
     int64_t timerID = mIDGen.gen_id();
     TWTimerNode* timer = mPool.get();
-    int err = timer->init(timerID, timerType, mNow + startTime, interval, times, callback, nextFromNow);
+    int err = timer->init(timerID, timerType, mNow + startTime, interval, times, std::move(callback), nextFromNow);
     if (err != Success) {
         mPool.free(timer);
         return 0;
@@ -169,6 +174,7 @@ int64_t TWTimer::add_timer(int32_t timerType, int64_t startTime, int64_t interva
         return 0;
     }
 
+    mGroups.add(timer, owner);
     add_timer_node(timer);
     return timer->get_timer_id();
 }
@@ -181,18 +187,71 @@ bool TWTimer::remove_timer(int64_t timerID) {
     if (iter->second->remove_if_calling()) {
         return true;
     }
+    mGroups.remove(iter->second);
     mPool.free(iter->second);
     mTimers.erase(iter);
     return true;
 }
 
 void TWTimer::clear_timer() {
+    mBatches.clear();
+    mGroups.clear();
     for (auto iter = mTimers.begin(); iter != mTimers.end();) {
         mPool.free(iter->second);
         iter = mTimers.erase(iter);
     }
 }
 
+int64_t TWTimer::add_slack_timer(int32_t timerType, int64_t startTime, int64_t interval, int64_t times, int64_t slack, bool nextFromNow,
+                                 int64_t owner) {
+    if (slack <= 0 || times == 0 || startTime + interval <= 0) {
+        return 0;
+    }
+    int64_t timerID = mIDGen.gen_id();
+    TWTimerNode* timer = mPool.get();
+    int err = timer->init(timerID, timerType, mNow + startTime, interval, times, nullptr, nextFromNow, slack);
+    if (err != Success) {
+        mPool.free(timer);
+        return 0;
+    }
+
+    if (!mTimers.insert(std::make_pair(timer->get_timer_id(), timer)).second) {
+        mPool.free(timer);
+        return 0;
+    }
+
+    mGroups.add(timer, owner);
+    add_batch_node(timer);
+    return timer->get_timer_id();
+}
+
+void TWTimer::set_batch_callback(int32_t timerType, TimerBatchCallback callback) {
+    if (callback == nullptr) {
+        mBatchCallbacks.erase(timerType);
+    } else {
+        mBatchCallbacks[timerType] = std::move(callback);
+    }
+}
+
+size_t TWTimer::remove_group(int64_t owner) {
+    size_t count = 0;
+    TimerNode* timer = mGroups.get_front(owner);
+    while (timer != nullptr) {
+        TimerNode* next = timer->get_group_next();
+        ++count;
+        // calling timer is removed after callback return
+        if (!timer->remove_if_calling()) {
+            mGroups.remove(timer);
+            mTimers.erase(timer->get_timer_id());
+            mPool.free(static_cast<TWTimerNode*>(timer));
+        }
+        timer = next;
+    }
+    return count;
+}
+
+size_t TWTimer::get_group_count(int64_t owner) const { return mGroups.get_count(owner); }
+
 void TWTimer::try_trigger_timer(NodeList* timerStep) {
     if (timerStep == nullptr) {
         return;
@@ -237,6 +296,35 @@ void TWTimer::try_turn_wheel(int64_t now) {
     }
 }
 
+void TWTimer::try_trigger_batch() {
+    NodeList list;
+    while (!mBatches.empty() && mBatches.begin()->first.first <= mNow) {
+        auto iter = mBatches.begin();
+        int32_t timerType = iter->first.second;
+        list.push_back_list(iter->second);
+        mBatches.erase(iter);
+
+        mBatchIDs.clear();
+        while (!list.empty()) {
+            TWTimerNode* node = list.pop_front_t<TWTimerNode>();
+            node->time_out();
+            mBatchIDs.push_back(node->get_timer_id());
+            if (node->get_left_times() == 0) {
+                remove_timer(node->get_timer_id());
+            } else {
+                node->next_time(mNow);
+                add_batch_node(node);
+            }
+        }
+
+        // do not reset the batch callback of timerType in itself
+        auto cbIter = mBatchCallbacks.find(timerType);
+        if (!mBatchIDs.empty() && cbIter != mBatchCallbacks.end()) {
+            cbIter->second(timerType, mBatchIDs);
+        }
+    }
+}
+
 void TWTimer::add_timer_node(TWTimerNode* timer) {
     for (size_t i = 0; i < PURE_ARRAY_SIZE(mWheels); ++i) {
         if (mWheels[i].add_timer(timer)) {
@@ -246,4 +334,6 @@ void TWTimer::add_timer_node(TWTimerNode* timer) {
     mOverflowWheel.push_back(timer);
 }
 
-}  // namespace PureCore
\ No newline at end of file
+void TWTimer::add_batch_node(TWTimerNode* timer) { mBatches[std::make_pair(timer->get_next_time(), timer->get_timer_type())].push_back(timer); }
+
+}  // namespace PureCore
@@ -25,51 +25,137 @@
 #include "PureCore/PureLog.h"
 #include "PureCore/Task.h"
 
+#include <thread>
+
 namespace PureCore {
+static thread_local TaskThread* sCurrentThread = nullptr;
+static thread_local uint32_t sOutsideSeed = 0x9e3779b9u;
+static const uint32_t sTaskSpinCount = 64;
+
+///////////////////////////////////////////////////////////////////////////
+// TaskDeque
+//////////////////////////////////////////////////////////////////////////
+bool TaskDeque::push(TaskNode* node) {
+    int64_t bottom = mBottom.load(std::memory_order_relaxed);
+    int64_t top = mTop.load(std::memory_order_acquire);
+    if (bottom - top >= Capacity) {
+        return false;
+    }
+    mBuffer[bottom & Mask].store(node, std::memory_order_relaxed);
+    mBottom.store(bottom + 1, std::memory_order_release);
+    return true;
+}
+
+TaskNode* TaskDeque::pop() {
+    int64_t bottom = mBottom.load(std::memory_order_relaxed) - 1;
+    // seq_cst store and load, steal must see the new bottom or pop must see the new top
+    mBottom.store(bottom, std::memory_order_seq_cst);
+    int64_t top = mTop.load(std::memory_order_seq_cst);
+    if (top > bottom) {
+        mBottom.store(bottom + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    TaskNode* node = mBuffer[bottom & Mask].load(std::memory_order_relaxed);
+    if (top == bottom) {
+        // last node, race with steal
+        if (!mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            node = nullptr;
+        }
+        mBottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return node;
+}
+
+TaskNode* TaskDeque::steal() {
+    int64_t top = mTop.load(std::memory_order_seq_cst);
+    int64_t bottom = mBottom.load(std::memory_order_seq_cst);
+    if (top >= bottom) {
+        return nullptr;
+    }
+    TaskNode* node = mBuffer[top & Mask].load(std::memory_order_relaxed);
+    if (!mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return nullptr;
+    }
+    return node;
+}
+
+bool TaskDeque::empty() const { return mTop.load(std::memory_order_acquire) >= mBottom.load(std::memory_order_acquire); }
+
 ///////////////////////////////////////////////////////////////////////////
 // TaskThread
 //////////////////////////////////////////////////////////////////////////
-TaskThread::TaskThread(Task& task) : mTask(task) {}
+TaskThread::TaskThread(Task& task, uint32_t index) : mTask(task), mIndex(index), mSeed(index * 2654435761u + 1), mDeque() {}
 
-void TaskThread::work() { mTask.work(); }
+void TaskThread::work() { mTask.work(*this); }
 
 ///////////////////////////////////////////////////////////////////////////
 // TaskNode
 //////////////////////////////////////////////////////////////////////////
-TaskNode::TaskNode(std::function<void()> func) : mFunc(func) {}
+static thread_local ObjectRecycler<TaskNode, 1024> tlTaskNodePool{"TaskNode"};
+
+void TaskNode::clear() {
+    mFunc = nullptr;
+    mDone = nullptr;
+    mNext = nullptr;
+    mJoin = nullptr;
+}
+
+TaskNode* TaskNode::create(TaskFunc&& func, TaskFunc&& done) {
+    TaskNode* node = tlTaskNodePool.get();
+    if (node == nullptr) {
+        return nullptr;
+    }
+    node->mFunc = std::move(func);
+    node->mDone = std::move(done);
+    return node;
+}
+
+void TaskNode::destroy(TaskNode* node) { tlTaskNodePool.free(node); }
 
 //////////////////////////////////////////////////////////////////////////
 // Task
 //////////////////////////////////////////////////////////////////////////
-Task::Task(uint32_t size) {
-    if (size == 0) {
-        size = 1;
-    }
-    std::unique_lock<std::mutex> lock(mMutex);
-    for (uint32_t i = 0; i < size; ++i) {
-        auto t = new TaskThread(*this);
-        if (t == nullptr) {
-            PureError("task ctor failed, memory is not enough!!!");
-            continue;
-        }
-        mThreades.push_back(t);
-        int err = t->run();
-        if (err != Success) {
-            PureError("task ctor failed, `{}`", get_error_desc(err));
-        }
-    }
-}
+Task::Task(uint32_t size) : mSize(size > 0 ? size : 1) {}
 
 Task::~Task() {
+    if (!mThreades.empty()) {
+        stop(0);
+    }
     std::unique_lock<std::mutex> lock(mMutex);
+    clear_nodes();
     for (auto t : mThreades) {
         delete t;
     }
     mThreades.clear();
+    TaskNode* node = mDone.exchange(nullptr, std::memory_order_acquire);
+    while (node != nullptr) {
+        TaskNode* next = node->mNext;
+        TaskNode::destroy(node);
+        node = next;
+    }
 }
 
 int Task::run() {
+    std::unique_lock<std::mutex> lock(mMutex);
+    if (mRunning.load() || !mThreades.empty()) {
+        return ErrorTaskAlreadyRunning;
+    }
     mRunning = true;
+    for (uint32_t i = 0; i < mSize; ++i) {
+        auto t = new TaskThread(*this, i);
+        if (t == nullptr) {
+            PureError("task run failed, memory is not enough!!!");
+            continue;
+        }
+        mThreades.push_back(t);
+    }
+    // start after all threads are created, steal_node reads mThreades
+    for (auto t : mThreades) {
+        int err = t->run();
+        if (err != Success) {
+            PureError("task run failed, `{}`", get_error_desc(err));
+        }
+    }
     return Success;
 }
 
@@ -77,48 +163,318 @@ void Task::stop(int64_t timeout) {
     mRunning = false;
     {
         std::unique_lock<std::mutex> lock(mMutex);
-        while (!mNodes.empty()) {
-            delete mNodes.pop_front();
-        }
         mCondition.notify_all();
     }
-    int64_t left = timeout > 0 ? timeout : 1;
-    while (mRunningTask.load(std::memory_order_relaxed) != 0 && left > 0) {
-        PureCore::sleep(10);
-        if (timeout > 0) {
-            left -= 10;
+    for (auto t : mThreades) {
+        t->join(timeout);
+    }
+    bool exited = true;
+    for (auto t : mThreades) {
+        if (t->is_running()) {
+            exited = false;
+            break;
         }
     }
+    // the deques can only be cleared after their owner threads exited
+    if (exited) {
+        std::unique_lock<std::mutex> lock(mMutex);
+        clear_nodes();
+    }
 }
 
-int Task::add_task(std::function<void()> func) {
+int Task::add_task(TaskFunc func) { return add_task(std::move(func), nullptr); }
+
+int Task::add_task(TaskFunc func, TaskFunc done) {
     if (!mRunning.load(std::memory_order_relaxed)) {
         return ErrorTaskIsStoped;
     }
-    TaskNode* node = new TaskNode(func);
-    std::unique_lock<std::mutex> lock(mMutex);
-    mNodes.push_back(node);
-    mCondition.notify_one();
+    if (!func) {
+        return ErrorInvalidArg;
+    }
+    TaskNode* node = TaskNode::create(std::move(func), std::move(done));
+    if (node == nullptr) {
+        return ErrorMemoryNotEnough;
+    }
+    return add_node(node);
+}
+
+int Task::post_update(TaskFunc func) {
+    if (!func) {
+        return ErrorInvalidArg;
+    }
+    TaskNode* node = TaskNode::create(nullptr, std::move(func));
+    if (node == nullptr) {
+        return ErrorMemoryNotEnough;
+    }
+    push_list(mDone, node, node);
     return Success;
 }
 
-void Task::work() {
+size_t Task::update() {
+    TaskNode* node = mDone.exchange(nullptr, std::memory_order_acquire);
+    // reverse to add order
+    TaskNode* head = nullptr;
+    while (node != nullptr) {
+        TaskNode* next = node->mNext;
+        node->mNext = head;
+        head = node;
+        node = next;
+    }
+    size_t count = 0;
+    while (head != nullptr) {
+        TaskNode* next = head->mNext;
+        head->mDone();
+        TaskNode::destroy(head);
+        head = next;
+        ++count;
+    }
+    return count;
+}
+
+bool Task::run_one() {
+    TaskThread* thread = sCurrentThread;
     TaskNode* node = nullptr;
+    if (thread != nullptr && &thread->mTask == this) {
+        node = get_node(*thread);
+    } else {
+        node = get_outside_node();
+    }
+    if (node == nullptr) {
+        return false;
+    }
+    run_node(node);
+    return true;
+}
+
+uint32_t Task::get_size() const { return mSize; }
+
+bool Task::is_task_thread() const { return sCurrentThread != nullptr && &sCurrentThread->mTask == this; }
+
+void Task::work(TaskThread& thread) {
+    sCurrentThread = &thread;
+    uint32_t idle = 0;
     while (mRunning.load(std::memory_order_relaxed)) {
-        {
-            std::unique_lock<std::mutex> lock(mMutex);
-            node = mNodes.pop_front_t<TaskNode>();
-            if (node == nullptr) {
-                mCondition.wait(lock);
+        TaskNode* node = get_node(thread);
+        if (node != nullptr) {
+            idle = 0;
+            run_node(node);
+            continue;
+        }
+        if (++idle < sTaskSpinCount) {
+            std::this_thread::yield();
+            continue;
+        }
+        idle = 0;
+        std::unique_lock<std::mutex> lock(mMutex);
+        mSleeping.fetch_add(1);
+        // pair with notify, a node added before this check is seen, or the adder sees mSleeping
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (mRunning.load(std::memory_order_relaxed) && !has_node()) {
+            mCondition.wait(lock);
+        }
+        mSleeping.fetch_sub(1);
+    }
+    sCurrentThread = nullptr;
+}
+
+int Task::add_join_task(TaskFunc&& func, std::atomic<size_t>* join) {
+    if (!mRunning.load(std::memory_order_relaxed)) {
+        return ErrorTaskIsStoped;
+    }
+    TaskNode* node = TaskNode::create(std::move(func), nullptr);
+    if (node == nullptr) {
+        return ErrorMemoryNotEnough;
+    }
+    node->mJoin = join;
+    join->fetch_add(1, std::memory_order_relaxed);
+    return add_node(node);
+}
+
+int Task::add_node(TaskNode* node) {
+    TaskThread* thread = sCurrentThread;
+    if (thread == nullptr || &thread->mTask != this || !thread->mDeque.push(node)) {
+        push_list(mInject, node, node);
+    }
+    notify();
+    return Success;
+}
+
+TaskNode* Task::get_node(TaskThread& thread) {
+    TaskNode* node = thread.mDeque.pop();
+    if (node != nullptr) {
+        return node;
+    }
+    node = get_inject_node(thread);
+    if (node != nullptr) {
+        return node;
+    }
+    return steal_node(&thread, thread.mSeed);
+}
+
+TaskNode* Task::get_inject_node(TaskThread& thread) {
+    if (mInject.load(std::memory_order_relaxed) == nullptr) {
+        return nullptr;
+    }
+    // take all, the oldest node is run and the others go to own deque for the other threads to steal
+    TaskNode* node = mInject.exchange(nullptr, std::memory_order_acquire);
+    if (node == nullptr) {
+        return nullptr;
+    }
+    while (node->mNext != nullptr) {
+        TaskNode* next = node->mNext;
+        node->mNext = nullptr;
+        if (!thread.mDeque.push(node)) {
+            node->mNext = next;
+            TaskNode* tail = node;
+            while (tail->mNext->mNext != nullptr) {
+                tail = tail->mNext;
             }
+            TaskNode* oldest = tail->mNext;
+            tail->mNext = nullptr;
+            push_list(mInject, node, tail);
+            node = oldest;
+            break;
         }
+        node = next;
+    }
+    if (!thread.mDeque.empty()) {
+        notify();
+    }
+    return node;
+}
+
+TaskNode* Task::get_outside_node() {
+    if (!mRunning.load(std::memory_order_relaxed)) {
+        return nullptr;
+    }
+    TaskNode* node = steal_node(nullptr, sOutsideSeed);
+    if (node != nullptr || mInject.load(std::memory_order_relaxed) == nullptr) {
+        return node;
+    }
+    // no deque to keep the others, take all and push back all but the oldest
+    node = mInject.exchange(nullptr, std::memory_order_acquire);
+    if (node == nullptr || node->mNext == nullptr) {
+        return node;
+    }
+    TaskNode* tail = node;
+    while (tail->mNext->mNext != nullptr) {
+        tail = tail->mNext;
+    }
+    TaskNode* oldest = tail->mNext;
+    tail->mNext = nullptr;
+    push_list(mInject, node, tail);
+    return oldest;
+}
+
+TaskNode* Task::steal_node(TaskThread* thread, uint32_t& seed) {
+    size_t count = mThreades.size();
+    if (count == 0 || (count == 1 && thread != nullptr)) {
+        return nullptr;
+    }
+    seed = seed * 1103515245u + 12345u;
+    size_t start = (seed >> 16) % count;
+    for (size_t i = 0; i < count; ++i) {
+        TaskThread* victim = mThreades[(start + i) % count];
+        if (victim == thread) {
+            continue;
+        }
+        TaskNode* node = victim->mDeque.steal();
         if (node != nullptr) {
-            ++mRunningTask;
-            node->mFunc();
-            --mRunningTask;
-            delete node;
+            return node;
         }
     }
+    return nullptr;
 }
 
-}  // namespace PureCore
\ No newline at end of file
+void Task::run_node(TaskNode* node) {
+    node->mFunc();
+    if (node->mJoin != nullptr) {
+        node->mJoin->fetch_sub(1, std::memory_order_release);
+        node->mJoin = nullptr;
+    }
+    if (node->mDone) {
+        node->mFunc = nullptr;
+        push_list(mDone, node, node);
+    } else {
+        TaskNode::destroy(node);
+    }
+}
+
+bool Task::has_node() const {
+    if (mInject.load(std::memory_order_relaxed) != nullptr) {
+        return true;
+    }
+    for (auto t : mThreades) {
+        if (!t->mDeque.empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Task::notify() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (mSleeping.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(mMutex);
+    mCondition.notify_one();
+}
+
+void Task::clear_nodes() {
+    TaskNode* node = mInject.exchange(nullptr, std::memory_order_acquire);
+    while (node != nullptr) {
+        TaskNode* next = node->mNext;
+        drop_node(node);
+        node = next;
+    }
+    for (auto t : mThreades) {
+        while ((node = t->mDeque.pop()) != nullptr) {
+            drop_node(node);
+        }
+    }
+}
+
+void Task::drop_node(TaskNode* node) {
+    // dropped task is finished for its join
+    if (node->mJoin != nullptr) {
+        node->mJoin->fetch_sub(1, std::memory_order_release);
+    }
+    TaskNode::destroy(node);
+}
+
+void Task::push_list(std::atomic<TaskNode*>& list, TaskNode* head, TaskNode* tail) {
+    tail->mNext = list.load(std::memory_order_relaxed);
+    while (!list.compare_exchange_weak(tail->mNext, head, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+// TaskJoin
+//////////////////////////////////////////////////////////////////////////
+TaskJoin::TaskJoin(Task& task) : mTask(task) {}
+
+TaskJoin::~TaskJoin() { wait(); }
+
+int TaskJoin::add_task(TaskFunc func) {
+    if (!func) {
+        return ErrorInvalidArg;
+    }
+    if (mTask.add_join_task(std::move(func), &mCount) != Success) {
+        // add_join_task keeps func when it failed
+        func();
+    }
+    return Success;
+}
+
+void TaskJoin::wait() {
+    while (mCount.load(std::memory_order_acquire) != 0) {
+        if (!mTask.run_one()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+bool TaskJoin::is_done() const { return mCount.load(std::memory_order_acquire) == 0; }
+
+}  // namespace PureCore
@@ -38,7 +38,7 @@ int Thread::run() {
     return Success;
 }
 
-bool Thread::is_running() const { return mHandle.load(std::memory_order_relaxed) != 0; }
+bool Thread::is_running() const { return mHandle.load(std::memory_order_acquire) != 0; }
 
 int Thread::join(int64_t timeout) {
     if (get_thread_id() == mHandle.load(std::memory_order_relaxed)) {
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "PureCore/TimerGroup.h"
+
+namespace PureCore {
+///////////////////////////////////////////////////////////////////////////
+// TimerGroup
+//////////////////////////////////////////////////////////////////////////
+void TimerGroup::add(TimerNode* timer, int64_t owner) {
+    if (timer == nullptr || owner == 0) {
+        return;
+    }
+    Group& group = mGroups[owner];
+    timer->mOwner = owner;
+    timer->mGroupPre = nullptr;
+    timer->mGroupNext = group.mHead;
+    if (group.mHead != nullptr) {
+        group.mHead->mGroupPre = timer;
+    }
+    group.mHead = timer;
+    ++group.mCount;
+}
+
+void TimerGroup::remove(TimerNode* timer) {
+    if (timer == nullptr || timer->mOwner == 0) {
+        return;
+    }
+    auto iter = mGroups.find(timer->mOwner);
+    if (iter != mGroups.end()) {
+        Group& group = iter->second;
+        if (timer->mGroupPre != nullptr) {
+            timer->mGroupPre->mGroupNext = timer->mGroupNext;
+        } else {
+            group.mHead = timer->mGroupNext;
+        }
+        if (timer->mGroupNext != nullptr) {
+            timer->mGroupNext->mGroupPre = timer->mGroupPre;
+        }
+        if (--group.mCount == 0) {
+            mGroups.erase(iter);
+        }
+    }
+    timer->mOwner = 0;
+    timer->mGroupPre = nullptr;
+    timer->mGroupNext = nullptr;
+}
+
+void TimerGroup::clear() { mGroups.clear(); }
+
+TimerNode* TimerGroup::get_front(int64_t owner) const {
+    auto iter = mGroups.find(owner);
+    return iter != mGroups.end() ? iter->second.mHead : nullptr;
+}
+
+size_t TimerGroup::get_count(int64_t owner) const {
+    auto iter = mGroups.find(owner);
+    return iter != mGroups.end() ? iter->second.mCount : 0;
+}
+
+}  // namespace PureCore
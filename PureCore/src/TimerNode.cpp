@@ -27,21 +27,37 @@ namespace PureCore {
 ///////////////////////////////////////////////////////////////////////////
 // TimerNode
 //////////////////////////////////////////////////////////////////////////
-TimerNode::TimerNode() : mTimerID(0), mTimerType(0), mCallback(nullptr), mNextTime(0), mInterval(0), mLeftTimes(0), mNextFromNow(false), mCalling(false) {}
+TimerNode::TimerNode()
+    : mTimerID(0),
+      mTimerType(0),
+      mCallback(nullptr),
+      mNextTime(0),
+      mInterval(0),
+      mLeftTimes(0),
+      mNextFromNow(false),
+      mCalling(false),
+      mSlack(0),
+      mOwner(0),
+      mGroupPre(nullptr),
+      mGroupNext(nullptr) {}
 
 TimerNode::~TimerNode() { release(); }
 
-int TimerNode::init(int64_t timerID, int32_t timerType, int64_t startTime, int64_t interval, int64_t times, TimerCallback callback, bool nextFromNow) {
-    if (callback == nullptr || times == 0 || interval <= 0) {
+static inline int64_t align_slack(int64_t time, int64_t slack) { return slack > 0 ? (time + slack - 1) / slack * slack : time; }
+
+int TimerNode::init(int64_t timerID, int32_t timerType, int64_t startTime, int64_t interval, int64_t times, TimerCallback&& callback, bool nextFromNow,
+                    int64_t slack) {
+    if ((callback == nullptr && slack <= 0) || times == 0 || interval <= 0 || slack < 0) {
         return ErrorInvalidArg;
     }
     mTimerID = timerID;
     mTimerType = timerType;
-    mCallback = callback;
-    mNextTime = startTime;
+    mCallback = std::move(callback);
+    mNextTime = align_slack(startTime, slack);
     mInterval = interval;
     mLeftTimes = times;
     mNextFromNow = nextFromNow;
+    mSlack = slack;
     return Success;
 }
 
@@ -54,15 +70,23 @@ void TimerNode::release() {
     mLeftTimes = 0;
     mNextFromNow = false;
     mCalling = false;
+    mSlack = 0;
+    mOwner = 0;
+    mGroupPre = nullptr;
+    mGroupNext = nullptr;
 }
 
 void TimerNode::time_out() {
-    if (!mCallback || mLeftTimes == 0) {
+    if (mLeftTimes == 0) {
         return;
     }
     if (mLeftTimes > 0) {
         --mLeftTimes;
     }
+    // batch timer is only counted, callback is called by batch
+    if (!mCallback) {
+        return;
+    }
     mCalling = true;
     if (!mCallback(mTimerID, mTimerType, mLeftTimes)) {
         mLeftTimes = 0;
@@ -78,7 +102,13 @@ int64_t TimerNode::get_next_time() const { return mNextTime; }
 
 int64_t TimerNode::get_left_times() const { return mLeftTimes; }
 
-TimerCallback TimerNode::get_callback() const { return mCallback; }
+int64_t TimerNode::get_slack() const { return mSlack; }
+
+const TimerCallback& TimerNode::get_callback() const { return mCallback; }
+
+int64_t TimerNode::get_owner() const { return mOwner; }
+
+TimerNode* TimerNode::get_group_next() const { return mGroupNext; }
 
 bool TimerNode::remove_if_calling() {
     if (mCalling) {
@@ -94,6 +124,7 @@ void TimerNode::next_time(int64_t now) {
     } else {
         mNextTime += mInterval;
     }
+    mNextTime = align_slack(mNextTime, mSlack);
 }
 
 }  // namespace PureCore
\ No newline at end of file
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "PureCore/Memory/ThreadCacheAllocator.h"
+#include "PureCore/Memory/SmallAllocator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// alloc/free cost of ThreadCacheAllocator, SmallAllocator behind a mutex and malloc. a producer thread allocates a
+// batch and a consumer thread frees it, like replies made on a db thread and freed on the logic thread
+static const size_t sBatch = 4096;
+static const int sRounds = 400;
+static const int sRepeat = 3;
+static const size_t sMinSize = 8;
+static const size_t sMaxSize = 512;
+
+struct ThreadCacheAlloc {
+    void* allocate(size_t size) { return PureCore::ThreadCacheAllocator::allocate(size); }
+    void deallocate(void* p, size_t size) { PureCore::ThreadCacheAllocator::deallocate(p, size); }
+};
+
+struct SmallLockAlloc {
+    void* allocate(size_t size) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mAlloc.allocate(size);
+    }
+    void deallocate(void* p, size_t size) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mAlloc.deallocate(p, size);
+    }
+
+    std::mutex mMutex;
+    PureCore::SmallAllocator mAlloc{"AllocBench"};
+};
+
+struct MallocAlloc {
+    void* allocate(size_t size) { return ::malloc(size); }
+    void deallocate(void* p, size_t) { ::free(p); }
+};
+
+struct BenchPair {
+    std::vector<std::pair<void*, size_t>> mItems{sBatch};
+    std::atomic<int> mTurn{0};  // 0 producer, 1 consumer
+    double mAllocTime = 0;
+    double mFreeTime = 0;
+};
+
+static double now_s() { return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count(); }
+
+template <typename TAlloc>
+static void produce(TAlloc& alloc, BenchPair& pair, uint32_t seed) {
+    for (int r = 0; r < sRounds; ++r) {
+        while (pair.mTurn.load(std::memory_order_acquire) != 0) {
+            std::this_thread::yield();
+        }
+        double t = now_s();
+        for (auto& item : pair.mItems) {
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            size_t size = sMinSize + seed % (sMaxSize - sMinSize + 1);
+            item.first = alloc.allocate(size);
+            item.second = size;
+            *(char*)item.first = 1;
+        }
+        pair.mAllocTime += now_s() - t;
+        pair.mTurn.store(1, std::memory_order_release);
+    }
+}
+
+template <typename TAlloc>
+static void consume(TAlloc& alloc, BenchPair& pair) {
+    for (int r = 0; r < sRounds; ++r) {
+        while (pair.mTurn.load(std::memory_order_acquire) != 1) {
+            std::this_thread::yield();
+        }
+        double t = now_s();
+        for (auto& item : pair.mItems) {
+            alloc.deallocate(item.first, item.second);
+        }
+        pair.mFreeTime += now_s() - t;
+        pair.mTurn.store(0, std::memory_order_release);
+    }
+}
+
+template <typename TAlloc>
+static void bench_cross(const char* name, TAlloc& alloc, int pairCount) {
+    double bestAlloc = 1e9, bestFree = 1e9;
+    for (int rep = 0; rep < sRepeat; ++rep) {
+        std::vector<BenchPair> pairs(pairCount);
+        std::vector<std::thread> threads;
+        for (int i = 0; i < pairCount; ++i) {
+            threads.emplace_back([&alloc, &pairs, i] { produce(alloc, pairs[i], uint32_t(i + 7)); });
+            threads.emplace_back([&alloc, &pairs, i] { consume(alloc, pairs[i]); });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        double allocTime = 0, freeTime = 0;
+        for (auto& pair : pairs) {
+            allocTime += pair.mAllocTime;
+            freeTime += pair.mFreeTime;
+        }
+        bestAlloc = std::min(bestAlloc, allocTime);
+        bestFree = std::min(bestFree, freeTime);
+    }
+    double ops = double(sBatch) * sRounds * pairCount;
+    printf("cross %-12s pairs %d  alloc %6.1f ns  free %6.1f ns\n", name, pairCount, bestAlloc * 1e9 / ops, bestFree * 1e9 / ops);
+}
+
+// alloc and free on the same thread, the batch is freed in reverse
+template <typename TAlloc>
+static void bench_local(const char* name, TAlloc& alloc, int threadCount) {
+    double best = 1e9;
+    for (int rep = 0; rep < sRepeat; ++rep) {
+        std::vector<double> times(threadCount, 0);
+        std::vector<std::thread> threads;
+        for (int i = 0; i < threadCount; ++i) {
+            threads.emplace_back([&alloc, &times, i] {
+                std::vector<std::pair<void*, size_t>> items(sBatch);
+                uint32_t seed = uint32_t(i + 7);
+                double t = now_s();
+                for (int r = 0; r < sRounds; ++r) {
+                    for (auto& item : items) {
+                        seed ^= seed << 13;
+                        seed ^= seed >> 17;
+                        seed ^= seed << 5;
+                        item.second = sMinSize + seed % (sMaxSize - sMinSize + 1);
+                        item.first = alloc.allocate(item.second);
+                    }
+                    for (auto iter = items.rbegin(); iter != items.rend(); ++iter) {
+                        alloc.deallocate(iter->first, iter->second);
+                    }
+                }
+                times[i] = now_s() - t;
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        double total = 0;
+        for (double t : times) {
+            total += t;
+        }
+        best = std::min(best, total);
+    }
+    double ops = double(sBatch) * sRounds * threadCount;
+    printf("local %-12s threads %d  alloc+free %6.1f ns\n", name, threadCount, best * 1e9 / ops);
+}
+
+int main() {
+    ThreadCacheAlloc threadCache;
+    SmallLockAlloc small;
+    MallocAlloc sys;
+    for (int count : {1, 2, 4}) {
+        bench_cross("ThreadCache", threadCache, count);
+        bench_cross("Small+mutex", small, count);
+        bench_cross("malloc", sys, count);
+    }
+    for (int count : {1, 2, 4}) {
+        bench_local("ThreadCache", threadCache, count);
+        bench_local("Small+mutex", small, count);
+        bench_local("malloc", sys, count);
+    }
+    return 0;
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "PureCore/RBTimer.h"
+#include "PureCore/TWTimer.h"
+#include "PureCore/HeapTimer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// add, cancel and fire cost of RBTimer, TWTimer and HeapTimer. one shot timers are spread over sSpread ms and the
+// timer is updated by sFrame ms, like the logic loop
+static const int64_t sSpread = 60 * 1000;
+static const int64_t sFrame = 16;
+
+static double now_s() { return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count(); }
+
+static void init_timer(PureCore::RBTimer& timer) { timer.init(); }
+static void init_timer(PureCore::TWTimer& timer) { timer.init(); }
+static void init_timer(PureCore::HeapTimer& timer) { timer.init(); }
+
+template <typename TTimer>
+static void add_timers(TTimer& timer, const std::vector<int64_t>& starts, std::vector<int64_t>& ids, size_t& fired) {
+    ids.clear();
+    for (int64_t start : starts) {
+        ids.push_back(timer.add_timer(1, start, sSpread, 1, [&fired](int64_t, int32_t, int64_t) {
+            ++fired;
+            return true;
+        }));
+    }
+}
+
+template <typename TTimer>
+static void bench_timer(const char* name, size_t count) {
+    std::mt19937_64 rng(count);
+    std::vector<int64_t> starts(count);
+    for (auto& start : starts) {
+        start = 1 + int64_t(rng() % sSpread);
+    }
+    std::vector<int64_t> ids;
+    ids.reserve(count);
+    size_t fired = 0;
+
+    TTimer timer;
+    init_timer(timer);
+    double t = now_s();
+    add_timers(timer, starts, ids, fired);
+    double addTime = now_s() - t;
+
+    // cancel in random order, not the add order
+    std::vector<int64_t> cancelIDs = ids;
+    std::shuffle(cancelIDs.begin(), cancelIDs.end(), rng);
+    t = now_s();
+    for (int64_t id : cancelIDs) {
+        timer.remove_timer(id);
+    }
+    double cancelTime = now_s() - t;
+
+    add_timers(timer, starts, ids, fired);
+    t = now_s();
+    for (int64_t elapsed = 0; elapsed <= sSpread; elapsed += sFrame) {
+        timer.update(sFrame);
+    }
+    double fireTime = now_s() - t;
+    timer.release();
+
+    printf("%-10s %8zu timers  add %7.1f ns  cancel %7.1f ns  fire %7.1f ns  fired %zu\n", name, count, addTime * 1e9 / count,
+           cancelTime * 1e9 / count, fireTime * 1e9 / count, fired);
+}
+
+int main() {
+    for (size_t count : {size_t(10000), size_t(100000), size_t(1000000)}) {
+        bench_timer<PureCore::RBTimer>("RBTimer", count);
+        bench_timer<PureCore::TWTimer>("TWTimer", count);
+        bench_timer<PureCore::HeapTimer>("HeapTimer", count);
+    }
+    return 0;
+}
@@ -24,6 +24,7 @@
 
 #include "PureCore/Buffer/DynamicBuffer.h"
 #include "PureCore/Thread.h"
+#include "PureCore/Channel.h"
 #include "PureCore/NodeList.h"
 #include "PureCore/IncrIDGen.h"
 #include "PureCore/Memory/ObjectPool.h"
@@ -32,8 +33,6 @@
 #include "PureDb/LevelDb/LevelConnector.h"
 #include "PureDb/LevelDb/LevelAsync.h"
 
-#include <mutex>
-
 namespace PureDb {
 class PUREDB_API LevelAsyncConnector : public PureCore::Thread {
 public:
@@ -46,6 +45,14 @@ public:
     // logic
     int init(int64_t reqTimeout);
     void update();
+    // notified when responses are pushed to the logic thread, set before connect starts the work thread
+    void set_resp_waker(PureCore::ChannelWaker* waker);
+
+    // thread safe
+    PureCore::ChannelStat get_req_stat() const;
+    PureCore::ChannelStat get_resp_stat() const;
+    // responses wait for update, check it before the logic thread waits on resp waker
+    bool has_resp() const;
 
     // logic
     int connect(std::function<void(LevelReplyPtr)> cb, const LevelConfig& cfg);
@@ -126,13 +133,12 @@ private:
     LevelConnector mConnector;
     std::atomic<bool> mRunning{};
 
-    PureCore::NodeList mReqQueue;
-    PureCore::NodeList mRespQueue;
+    PureCore::NodeList mReqQueue;   // logic, wait for room in mReqChannel
+    PureCore::NodeList mRespQueue;  // work, wait for room in mRespChannel
 
-    std::mutex mSwapReqMutex;
-    PureCore::NodeList mSwapReqQueue;
-    std::mutex mSwapRespMutex;
-    PureCore::NodeList mSwapRespQueue;
+    PureCore::ChannelWaker mReqWaker;  // wake work thread when requests arrive
+    PureCore::SpscChannel<LevelAsyncItem*> mReqChannel;
+    PureCore::SpscChannel<LevelAsyncItem*> mRespChannel;
 
     // logic
     int64_t mReqTimeOut{};
@@ -140,7 +146,7 @@ private:
     std::map<int64_t, LevelReqItem*> mReqWaiting{};
 
     // logic
-    PureCore::ObjectPool<LevelReqItem, 255> mReqPool;
-    PureCore::ObjectCache<LevelAsyncItem, 255> mAsyncItemPool;
+    PureCore::ObjectPool<LevelReqItem, 255> mReqPool{"LevelReqItem"};
+    PureCore::ObjectCache<LevelAsyncItem, 255> mAsyncItemPool{"LevelAsyncItem"};
 };
 }  // namespace PureDb
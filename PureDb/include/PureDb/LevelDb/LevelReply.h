@@ -37,7 +37,7 @@ public:
     LevelReply() = default;
     ~LevelReply();
 
-    // thread safe
+    // thread safe, allocated by ThreadCacheAllocator, usually get in the db thread and free in the logic thread
     static LevelReply* get();
     // thread safe
     static void free(LevelReply* obj);
@@ -25,6 +25,7 @@
 #include "PureCore/Buffer/DynamicBuffer.h"
 #include "PureCore/ArrayRef.h"
 #include "PureCore/Thread.h"
+#include "PureCore/Channel.h"
 #include "PureCore/NodeList.h"
 #include "PureCore/IncrIDGen.h"
 #include "PureCore/Memory/ObjectPool.h"
@@ -33,8 +34,6 @@
 #include "PureDb/Redis/RedisConnector.h"
 #include "PureDb/Redis/RedisAsync.h"
 
-#include <mutex>
-
 namespace PureDb {
 class PUREDB_API RedisAsyncConnector : public PureCore::Thread {
 public:
@@ -47,8 +46,14 @@ public:
     // logic
     int init(int64_t reqTimeout);
     void update();
+    // notified when responses are pushed to the logic thread, set before connect starts the work thread
+    void set_resp_waker(PureCore::ChannelWaker* waker);
 
     // thread safe
+    PureCore::ChannelStat get_req_stat() const;
+    PureCore::ChannelStat get_resp_stat() const;
+    // responses wait for update, check it before the logic thread waits on resp waker
+    bool has_resp() const;
     bool is_busying() const;
 
     // logic
@@ -111,13 +116,12 @@ private:
     std::atomic<bool> mRunning{};
     std::atomic<bool> mBusying{};
 
-    PureCore::NodeList mReqQueue;
-    PureCore::NodeList mRespQueue;
+    PureCore::NodeList mReqQueue;   // logic, wait for room in mReqChannel
+    PureCore::NodeList mRespQueue;  // work, wait for room in mRespChannel
 
-    std::mutex mSwapReqMutex;
-    PureCore::NodeList mSwapReqQueue;
-    std::mutex mSwapRespMutex;
-    PureCore::NodeList mSwapRespQueue;
+    PureCore::ChannelWaker mReqWaker;  // wake work thread when requests arrive
+    PureCore::SpscChannel<RedisAsyncItem*> mReqChannel;
+    PureCore::SpscChannel<RedisAsyncItem*> mRespChannel;
 
     // work
     std::vector<PureCore::StringRef> mParamsCache;
@@ -129,7 +133,7 @@ private:
     RedisAsyncItem* mReqing = nullptr;
 
     // logic
-    PureCore::ObjectPool<RedisReqItem, 255> mReqPool;
-    PureCore::ObjectCache<RedisAsyncItem, 255> mAsyncItemPool;
+    PureCore::ObjectPool<RedisReqItem, 255> mReqPool{"RedisReqItem"};
+    PureCore::ObjectCache<RedisAsyncItem, 255> mAsyncItemPool{"RedisAsyncItem"};
 };
 }  // namespace PureDb
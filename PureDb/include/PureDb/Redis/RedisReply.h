@@ -22,8 +22,8 @@
 
 #pragma once
 
-#include "PureCore/Buffer/DynamicBuffer.h"
 #include "PureCore/ArrayRef.h"
+#include "PureCore/StringRef.h"
 #include "PureCore/MovePtr.h"
 #include "PureDb/PureDbLib.h"
 
@@ -37,7 +37,8 @@ public:
     RedisReply() = default;
     ~RedisReply();
 
-    // thread safe
+    // thread safe, reply and its string are allocated by ThreadCacheAllocator,
+    // usually get in the redis thread and free in the logic thread
     static RedisReply* get();
     // thread safe
     static void free(RedisReply* obj);
@@ -74,6 +75,7 @@ private:
     int reset_from(redisReply* reply);
     PureCore::StringRef get_data() const;
     int set_data(PureCore::StringRef str);
+    void free_data();
 
 private:
     uint8_t mType = 0;
@@ -81,7 +83,10 @@ private:
         int64_t mInt;
         double mDouble;
     } mNumber{0};
-    PureCore::DynamicBuffer mStr;
+    char* mStr = nullptr;
+    size_t mStrSize = 0;
     std::vector<RedisReplyPtr> mArray;
+
+    PURE_DISABLE_COPY(RedisReply)
 };
 }  // namespace PureDb
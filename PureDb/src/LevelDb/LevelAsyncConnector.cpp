@@ -23,7 +23,6 @@
 #include "PureCore/CoreErrorDesc.h"
 #include "PureCore/PureLog.h"
 #include "PureCore/OsHelper.h"
-#include "PureCore/SleepIdler.h"
 #include "PureMsg/MsgArgs.h"
 #include "PureDb/DbErrorDesc.h"
 #include "PureDb/LevelDb/LevelAsyncConnector.h"
@@ -31,30 +30,40 @@
 namespace PureDb {
 void LevelAsyncConnector::stop() {
     mRunning = false;
+    mReqWaker.notify();
     join(0);
     for (const auto& iter : mReqWaiting) {
         mReqPool.free(iter.second);
     }
     mReqWaiting.clear();
+    // work thread exited, drain both sides of the channels here
+    mReqChannel.pop_list(mReqQueue);
     while (!mReqQueue.empty()) {
         mAsyncItemPool.free(mReqQueue.pop_front_t<LevelAsyncItem>());
     }
-    mSwapReqMutex.lock();
-    while (!mSwapReqQueue.empty()) {
-        mAsyncItemPool.free(mSwapReqQueue.pop_front_t<LevelAsyncItem>());
+    mRespChannel.pop_list(mRespQueue);
+    while (!mRespQueue.empty()) {
+        mAsyncItemPool.free(mRespQueue.pop_front_t<LevelAsyncItem>());
     }
-    mSwapReqMutex.unlock();
-    mSwapRespMutex.lock();
-    while (!mSwapRespQueue.empty()) {
-        mAsyncItemPool.free(mSwapRespQueue.pop_front_t<LevelAsyncItem>());
-    }
-    mSwapRespMutex.unlock();
 }
 
+PureCore::ChannelStat LevelAsyncConnector::get_req_stat() const { return mReqChannel.get_stat(); }
+
+PureCore::ChannelStat LevelAsyncConnector::get_resp_stat() const { return mRespChannel.get_stat(); }
+
+bool LevelAsyncConnector::has_resp() const { return !mRespChannel.empty(); }
+
+void LevelAsyncConnector::set_resp_waker(PureCore::ChannelWaker* waker) { mRespChannel.set_waker(waker); }
+
 int LevelAsyncConnector::init(int64_t reqTimeout) {
     if (reqTimeout <= 0) {
         return ErrorInvalidArg;
     }
+    int err = mReqWaker.init();
+    if (err != Success) {
+        return err;
+    }
+    mReqChannel.set_waker(&mReqWaker);
     mReqTimeOut = reqTimeout;
     mRunning = true;
     return Success;
@@ -558,16 +567,13 @@ void LevelAsyncConnector::logic_req() {
     if (mReqQueue.empty()) {
         return;
     }
-    mSwapReqMutex.lock();
-    mSwapReqQueue.push_back_list(mReqQueue);
-    mSwapReqMutex.unlock();
+    // left in mReqQueue when full, retry next update
+    mReqChannel.push_list(mReqQueue);
 }
 
 void LevelAsyncConnector::logic_resp() {
     PureCore::NodeList nl;
-    mSwapRespMutex.lock();
-    nl.push_back_list(mSwapRespQueue);
-    mSwapRespMutex.unlock();
+    mRespChannel.pop_list(nl);
     while (!nl.empty()) {
         LevelAsyncItem* item = nl.pop_front_t<LevelAsyncItem>();
         if (item == nullptr) {
@@ -628,9 +634,7 @@ int LevelAsyncConnector::make_req(ELevelAsyncType reqType, std::function<void(Le
 
 void LevelAsyncConnector::work_req() {
     PureCore::NodeList nl;
-    mSwapReqMutex.lock();
-    nl.push_back_list(mSwapReqQueue);
-    mSwapReqMutex.unlock();
+    mReqChannel.pop_list(nl);
     while (!nl.empty()) {
         LevelAsyncItem* item = nl.pop_front_t<LevelAsyncItem>();
         if (item == nullptr) {
@@ -1219,21 +1223,20 @@ void LevelAsyncConnector::work_resp() {
     if (mRespQueue.empty()) {
         return;
     }
-    mSwapRespMutex.lock();
-    mSwapRespQueue.push_back_list(mRespQueue);
-    mSwapRespMutex.unlock();
+    // left in mRespQueue when full, retry next frame
+    mRespChannel.push_list(mRespQueue);
 }
 
 void LevelAsyncConnector::work() {
     PureCore::NodeList req;
-    PureCore::SleepIdler idle;
-    idle.set_idle_delay(10 * 1000);
     while (mRunning.load(std::memory_order_relaxed)) {
-        idle.frame_begin();
         work_req();
         mConnector.update();
         work_resp();
-        idle.frame_end();
+        // empty check after pop, a push racing with the pop has notified or is seen here
+        if (mReqChannel.empty()) {
+            mReqWaker.wait(10);
+        }
     }
     mConnector.close();
     work_resp();
@@ -30,7 +30,7 @@
 #include "PureMsg/MsgBuffer.h"
 #include "PureMsg/MsgArgs.h"
 #include "PureDb/DbErrorDesc.h"
-#include "PureDb/Leveldb/LevelConnector.h"
+#include "PureDb/LevelDb/LevelConnector.h"
 
 #include "leveldb/cache.h"
 #include "leveldb/filter_policy.h"
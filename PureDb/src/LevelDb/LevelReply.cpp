@@ -21,8 +21,9 @@
  */
 
 #include "PureCore/CoreErrorDesc.h"
+#include "PureCore/Memory/ThreadCacheAllocator.h"
 #include "PureDb/DbErrorDesc.h"
-#include "PureDb/Leveldb/LevelReply.h"
+#include "PureDb/LevelDb/LevelReply.h"
 
 namespace PureDb {
 enum ELevelReplyType : uint8_t {
@@ -37,13 +38,20 @@ enum ELevelReplyType : uint8_t {
 LevelReply::~LevelReply() { clear(); }
 
 // thread safe
-LevelReply* LevelReply::get() { return new LevelReply; }
+LevelReply* LevelReply::get() {
+    void* p = PureCore::ThreadCacheAllocator::allocate(sizeof(LevelReply));
+    if (p == nullptr) {
+        return nullptr;
+    }
+    return new (p) LevelReply();
+}
 // thread safe
 void LevelReply::free(LevelReply* obj) {
     if (obj == nullptr) {
         return;
     }
-    delete obj;
+    obj->~LevelReply();
+    PureCore::ThreadCacheAllocator::deallocate(obj, sizeof(LevelReply));
 }
 
 void LevelReply::clear() {
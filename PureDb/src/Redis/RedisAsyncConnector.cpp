@@ -23,7 +23,6 @@
 #include "PureCore/CoreErrorDesc.h"
 #include "PureCore/PureLog.h"
 #include "PureCore/OsHelper.h"
-#include "PureCore/SleepIdler.h"
 #include "PureMsg/MsgArgs.h"
 #include "PureDb/DbErrorDesc.h"
 #include "PureDb/Redis/RedisAsyncConnector.h"
@@ -31,6 +30,7 @@
 namespace PureDb {
 void RedisAsyncConnector::stop() {
     mRunning = false;
+    mReqWaker.notify();
     join(0);
     mAsyncItemPool.free(mReqing);
     mReqing = nullptr;
@@ -38,25 +38,34 @@ void RedisAsyncConnector::stop() {
         mReqPool.free(iter.second);
     }
     mReqWaiting.clear();
+    // work thread exited, drain both sides of the channels here
+    mReqChannel.pop_list(mReqQueue);
     while (!mReqQueue.empty()) {
         mAsyncItemPool.free(mReqQueue.pop_front_t<RedisAsyncItem>());
     }
-    mSwapReqMutex.lock();
-    while (!mSwapReqQueue.empty()) {
-        mAsyncItemPool.free(mSwapReqQueue.pop_front_t<RedisAsyncItem>());
+    mRespChannel.pop_list(mRespQueue);
+    while (!mRespQueue.empty()) {
+        mAsyncItemPool.free(mRespQueue.pop_front_t<RedisAsyncItem>());
     }
-    mSwapReqMutex.unlock();
-    mSwapRespMutex.lock();
-    while (!mSwapRespQueue.empty()) {
-        mAsyncItemPool.free(mSwapRespQueue.pop_front_t<RedisAsyncItem>());
-    }
-    mSwapRespMutex.unlock();
 }
 
+PureCore::ChannelStat RedisAsyncConnector::get_req_stat() const { return mReqChannel.get_stat(); }
+
+PureCore::ChannelStat RedisAsyncConnector::get_resp_stat() const { return mRespChannel.get_stat(); }
+
+bool RedisAsyncConnector::has_resp() const { return !mRespChannel.empty(); }
+
+void RedisAsyncConnector::set_resp_waker(PureCore::ChannelWaker* waker) { mRespChannel.set_waker(waker); }
+
 int RedisAsyncConnector::init(int64_t reqTimeout) {
     if (reqTimeout <= 0) {
         return ErrorInvalidArg;
     }
+    int err = mReqWaker.init();
+    if (err != Success) {
+        return err;
+    }
+    mReqChannel.set_waker(&mReqWaker);
     mReqTimeOut = reqTimeout;
     mRunning = true;
     return Success;
@@ -215,16 +224,13 @@ void RedisAsyncConnector::logic_req() {
     if (mReqQueue.empty()) {
         return;
     }
-    mSwapReqMutex.lock();
-    mSwapReqQueue.push_back_list(mReqQueue);
-    mSwapReqMutex.unlock();
+    // left in mReqQueue when full, retry next update
+    mReqChannel.push_list(mReqQueue);
 }
 
 void RedisAsyncConnector::logic_resp() {
     PureCore::NodeList nl;
-    mSwapRespMutex.lock();
-    nl.push_back_list(mSwapRespQueue);
-    mSwapRespMutex.unlock();
+    mRespChannel.pop_list(nl);
     while (!nl.empty()) {
         RedisAsyncItem* item = nl.pop_front_t<RedisAsyncItem>();
         if (item == nullptr) {
@@ -249,9 +255,7 @@ void RedisAsyncConnector::logic_resp() {
 
 void RedisAsyncConnector::work_req() {
     PureCore::NodeList nl;
-    mSwapReqMutex.lock();
-    nl.push_back_list(mSwapReqQueue);
-    mSwapReqMutex.unlock();
+    mReqChannel.pop_list(nl);
     while (!nl.empty()) {
         RedisAsyncItem* item = nl.pop_front_t<RedisAsyncItem>();
         if (item == nullptr) {
@@ -353,21 +357,20 @@ void RedisAsyncConnector::work_resp() {
     if (mRespQueue.empty()) {
         return;
     }
-    mSwapRespMutex.lock();
-    mSwapRespQueue.push_back_list(mRespQueue);
-    mSwapRespMutex.unlock();
+    // left in mRespQueue when full, retry next frame
+    mRespChannel.push_list(mRespQueue);
 }
 
 void RedisAsyncConnector::work() {
-    PureCore::SleepIdler idle;
-    idle.set_idle_delay(10 * 1000);
     PureCore::NodeList req;
     while (mRunning.load(std::memory_order_relaxed)) {
-        idle.frame_begin();
         work_req();
         mConnector.update();
         work_resp();
-        idle.frame_end();
+        // empty check after pop, a push racing with the pop has notified or is seen here
+        if (mReqChannel.empty()) {
+            mReqWaker.wait(10);
+        }
     }
     mConnector.close();
     work_resp();
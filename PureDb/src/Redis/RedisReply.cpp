@@ -21,11 +21,14 @@
  */
 
 #include "PureCore/CoreErrorDesc.h"
+#include "PureCore/Memory/ThreadCacheAllocator.h"
 #include "PureDb/DbErrorDesc.h"
 #include "PureDb/Redis/RedisReply.h"
 
 #include "hiredis.h"
 
+#include <string.h>
+
 namespace PureDb {
 enum ERedisReplyType {
     ETypeNone = 0,
@@ -40,19 +43,26 @@ enum ERedisReplyType {
 RedisReply::~RedisReply() { clear(); }
 
 // thread safe
-RedisReply* RedisReply::get() { return new RedisReply; }
+RedisReply* RedisReply::get() {
+    void* p = PureCore::ThreadCacheAllocator::allocate(sizeof(RedisReply));
+    if (p == nullptr) {
+        return nullptr;
+    }
+    return new (p) RedisReply();
+}
 // thread safe
 void RedisReply::free(RedisReply* obj) {
     if (obj == nullptr) {
         return;
     }
-    delete obj;
+    obj->~RedisReply();
+    PureCore::ThreadCacheAllocator::deallocate(obj, sizeof(RedisReply));
 }
 
 void RedisReply::clear() {
     mType = ETypeNone;
     mNumber = {0};
-    mStr.clear();
+    free_data();
     mArray.clear();
 }
 
@@ -211,14 +221,27 @@ int RedisReply::reset_from(redisReply* reply) {
     return Success;
 }
 
-PureCore::StringRef RedisReply::get_data() const { return mStr.data().bytes(); }
+PureCore::StringRef RedisReply::get_data() const { return PureCore::StringRef(mStr, mStrSize); }
 
 int RedisReply::set_data(PureCore::StringRef str) {
-    mStr.clear();
-    int err = mStr.write(str);
-    if (err != PureCore::Success) {
+    free_data();
+    if (str.empty()) {
+        return Success;
+    }
+    mStr = static_cast<char*>(PureCore::ThreadCacheAllocator::allocate(str.size()));
+    if (mStr == nullptr) {
         return ErrorCoreBufferFailed;
     }
+    memcpy(mStr, str.data(), str.size());
+    mStrSize = str.size();
     return Success;
 }
+
+void RedisReply::free_data() {
+    if (mStr != nullptr) {
+        PureCore::ThreadCacheAllocator::deallocate(mStr, mStrSize);
+        mStr = nullptr;
+    }
+    mStrSize = 0;
+}
 }  // namespace PureDb
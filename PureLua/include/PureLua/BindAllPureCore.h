@@ -36,9 +36,11 @@ PURELUA_API void bind_core_os_helper(lua_State* L);
 PURELUA_API void bind_core_pure_json(lua_State* L);
 PURELUA_API void bind_core_pure_xml(lua_State* L);
 PURELUA_API void bind_core_quad_tree(lua_State* L);
+PURELUA_API void bind_core_path_finder(lua_State* L);
 PURELUA_API void bind_core_random_gen(lua_State* L);
 PURELUA_API void bind_core_rb_timer(lua_State* L);
 PURELUA_API void bind_core_rect_tree(lua_State* L);
+PURELUA_API void bind_core_static_rect_tree(lua_State* L);
 PURELUA_API void bind_core_reuse_id_gen(lua_State* L);
 PURELUA_API void bind_core_snow_id_gen(lua_State* L);
 PURELUA_API void bind_core_sleep_idler(lua_State* L);
@@ -46,6 +48,10 @@ PURELUA_API void bind_core_time_counter(lua_State* L);
 PURELUA_API void bind_core_tw_timer(lua_State* L);
 PURELUA_API void bind_core_utf_helper(lua_State* L);
 PURELUA_API void bind_core_data_ref(lua_State* L);
+PURELUA_API void bind_core_frame_arena(lua_State* L);
+PURELUA_API void bind_core_pool_stat(lua_State* L);
+PURELUA_API void bind_core_heap_timer(lua_State* L);
+PURELUA_API void bind_core_aoi_mgr(lua_State* L);
 
 PURELUA_API void bind_all_pure_core(lua_State* L);
 
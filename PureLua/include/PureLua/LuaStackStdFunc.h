@@ -24,6 +24,7 @@
 
 #include "PureLua/StdFunctionTraits.h"
 #include "PureLua/LuaStackExt.h"
+#include "PureCore/InlineFunction.h"
 
 #include <functional>
 
@@ -76,4 +77,39 @@ struct LuaStack<std::function<R(Args...)>> {
     static inline bool valid(lua_State *L, int idx) { return lua_isfunction(L, idx); }
 };
 
+// PureCore::InlineFunction, lua function is held by LuaRef inline
+template <typename R, typename... Args, size_t Capacity>
+struct LuaStack<PureCore::InlineFunction<R(Args...), Capacity>> {
+    typedef PureCore::InlineFunction<R(Args...), Capacity> FunctionType;
+    typedef const FunctionType &PushType;
+    typedef FunctionType GetType;
+    static inline void push(lua_State *L, PushType t) { StdFunctionTraits<std::function<R(Args...)>>::push_std_func(L, std::function<R(Args...)>(t)); }
+
+    static inline GetType get(lua_State *L, int idx) {
+        LuaRef ref = LuaStack<LuaRef>::get(L, idx);
+        if (!ref.is_function()) {
+            PureLuaErrorJump(L, "this obj is not a function");
+            return nullptr;
+        }
+        return FunctionType([ref](Args... args) -> R {
+            if constexpr (std::is_void<R>::value) {
+                ref(std::forward<Args>(args)...);
+            } else {
+                auto r = ref(std::forward<Args>(args)...);
+                return r.template cast<R>();
+            }
+        });
+    }
+
+    static inline bool valid(lua_State *L, int idx) { return lua_isfunction(L, idx); }
+};
+
+// const PureCore::InlineFunction&
+template <typename R, typename... Args, size_t Capacity>
+struct LuaStack<const PureCore::InlineFunction<R(Args...), Capacity> &> : public LuaStack<PureCore::InlineFunction<R(Args...), Capacity>> {};
+
+// const PureCore::InlineFunction
+template <typename R, typename... Args, size_t Capacity>
+struct LuaStack<const PureCore::InlineFunction<R(Args...), Capacity>> : public LuaStack<PureCore::InlineFunction<R(Args...), Capacity>> {};
+
 }  // namespace PureLua
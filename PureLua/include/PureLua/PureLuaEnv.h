@@ -101,7 +101,7 @@ private:
     lua_State* mLua;
     std::string mLastError;
     LuaDebugger mDebugger;
-    PureCore::SmallAllocator mAllocator;
+    PureCore::SmallAllocator mAllocator{"LuaAllocator"};
     std::vector<RequireLoader> mLoader;
     LuaRef mRequire;
     LuaFuncProfiler mFuncProfiler;
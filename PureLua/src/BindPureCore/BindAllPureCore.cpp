@@ -34,15 +34,21 @@ void bind_all_pure_core(lua_State* L) {
     bind_core_pure_json(L);
     bind_core_pure_xml(L);
     bind_core_quad_tree(L);
+    bind_core_path_finder(L);
     bind_core_random_gen(L);
     bind_core_rb_timer(L);
     bind_core_rect_tree(L);
+    bind_core_static_rect_tree(L);
     bind_core_reuse_id_gen(L);
     bind_core_snow_id_gen(L);
     bind_core_time_counter(L);
     bind_core_tw_timer(L);
     bind_core_utf_helper(L);
     bind_core_data_ref(L);
+    bind_core_frame_arena(L);
+    bind_core_pool_stat(L);
+    bind_core_heap_timer(L);
+    bind_core_aoi_mgr(L);
 }
 
 }  // namespace PureLua
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "PureCore/AoiMgr.h"
+
+#include "PureLua/LuaRegisterClass.h"
+
+namespace PureLua {
+static int push_aoi_pairs(lua_State* L, const std::vector<PureCore::AoiPair>& r) {
+    lua_createtable(L, int(r.size()), 0);
+    for (int i = 0; i < r.size(); ++i) {
+        lua_createtable(L, 2, 0);
+        lua_pushinteger(L, r[i].mWatcher);
+        lua_rawseti(L, -2, 1);
+        lua_pushinteger(L, r[i].mTarget);
+        lua_rawseti(L, -2, 2);
+        lua_rawseti(L, -2, i + 1);
+    }
+    return 1;
+}
+
+static int push_aoi_ids(lua_State* L, const std::vector<PureCore::AoiEntity*>& r) {
+    lua_createtable(L, int(r.size()), 0);
+    for (int i = 0; i < r.size(); ++i) {
+        lua_pushinteger(L, r[i]->obj_id());
+        lua_rawseti(L, -2, i + 1);
+    }
+    return 1;
+}
+
+void bind_core_aoi_mgr(lua_State* L) {
+    using namespace PureCore;
+    PureLua::LuaModule lm(L, "PureCore");
+    lm[PureLua::LuaRegisterClass<AoiMgr>(L, "AoiMgr")
+           .default_ctor()
+           .def(&AoiMgr::init, "init")
+           .def(&AoiMgr::clear, "clear")
+           .def(&AoiMgr::add, "add")
+           .def(&AoiMgr::remove, "remove")
+           .def(&AoiMgr::move, "move")
+           .def(&AoiMgr::set_radius, "set_radius")
+           .def(&AoiMgr::size, "size")
+           .def(&AoiMgr::update, "update")
+           .def(
+               [](lua_State* L) -> int {
+                   AoiMgr& self = PureLua::LuaStack<AoiMgr&>::get(L, 1);
+                   return push_aoi_pairs(L, self.enters());
+               },
+               "enters")
+           .def(
+               [](lua_State* L) -> int {
+                   AoiMgr& self = PureLua::LuaStack<AoiMgr&>::get(L, 1);
+                   return push_aoi_pairs(L, self.leaves());
+               },
+               "leaves")
+           .def(
+               [](lua_State* L) -> int {
+                   AoiMgr& self = PureLua::LuaStack<AoiMgr&>::get(L, 1);
+                   return push_aoi_ids(L, self.moves());
+               },
+               "moves")
+           .def(
+               [](lua_State* L) -> int {
+                   AoiMgr& self = PureLua::LuaStack<AoiMgr&>::get(L, 1);
+                   auto e = self.find(PureLua::LuaStack<int64_t>::get(L, 2));
+                   if (e == nullptr) {
+                       lua_createtable(L, 0, 0);
+                       return 1;
+                   }
+                   return push_aoi_ids(L, e->watchers());
+               },
+               "watchers")
+           .def(
+               [](lua_State* L) -> int {
+                   AoiMgr& self = PureLua::LuaStack<AoiMgr&>::get(L, 1);
+                   auto e = self.find(PureLua::LuaStack<int64_t>::get(L, 2));
+                   if (e == nullptr) {
+                       lua_createtable(L, 0, 0);
+                       return 1;
+                   }
+                   return push_aoi_ids(L, e->seen());
+               },
+               "seen")];
+}
+}  // namespace PureLua
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "PureCore/CoreErrorDesc.h"
+#include "PureCore/Memory/FrameArena.h"
+#include "PureCore/Buffer/ArenaBuffer.h"
+
+#include "PureLua/LuaRegisterClass.h"
+
+namespace PureLua {
+// every access checks the frame, a handle kept by script after the arena reset raises a lua error instead of touching freed memory
+static PureCore::ArenaBuffer* check_handle(lua_State* L) {
+    PureCore::ArenaBufferHandle& self = PureLua::LuaStack<PureCore::ArenaBufferHandle&>::get(L, 1);
+    PureCore::ArenaBuffer* buffer = self.get();
+    if (buffer == nullptr) {
+        PureLuaErrorJump(L, "arena buffer of frame {} is invalid", self.get_frame());
+        return nullptr;
+    }
+    return buffer;
+}
+
+static int handle_error(lua_State* L, int err) {
+    if (err != PureCore::Success) {
+        PureLuaErrorJump(L, "arena buffer failed `{}`", PureCore::get_error_desc(err));
+    }
+    return 0;
+}
+
+void bind_core_frame_arena(lua_State* L) {
+    using namespace PureCore;
+    PureLua::LuaModule lm(L, "PureCore");
+    lm[PureLua::LuaRegisterClass<ArenaBufferHandle>(L, "ArenaBufferHandle")
+           .def(&ArenaBufferHandle::valid, "valid")
+           .def(&ArenaBufferHandle::get_frame, "get_frame")
+           .def(
+               [](lua_State* L) -> int {
+                   ArenaBuffer* buffer = check_handle(L);
+                   lua_pushinteger(L, lua_Integer(buffer->size()));
+                   return 1;
+               },
+               "size")
+           .def(
+               [](lua_State* L) -> int {
+                   ArenaBuffer* buffer = check_handle(L);
+                   lua_pushinteger(L, lua_Integer(buffer->buffer_size()));
+                   return 1;
+               },
+               "buffer_size")
+           .def(
+               [](lua_State* L) -> int {
+                   check_handle(L)->clear();
+                   return 0;
+               },
+               "clear")
+           .def(
+               [](lua_State* L) -> int {
+                   ArenaBuffer* buffer = check_handle(L);
+                   PureLua::LuaStack<StringRef>::push(L, buffer->data().bytes());
+                   return 1;
+               },
+               "data")
+           .def(
+               [](lua_State* L) -> int {
+                   ArenaBuffer* buffer = check_handle(L);
+                   return handle_error(L, buffer->write_str(PureLua::LuaStack<StringRef>::get(L, 2)));
+               },
+               "write_str")
+           .def(
+               [](lua_State* L) -> int {
+                   ArenaBuffer* buffer = check_handle(L);
+                   size_t size = size_t(luaL_checkinteger(L, 2));
+                   DataRef data;
+                   int err = buffer->read(data, size);
+                   if (err != Success) {
+                       return handle_error(L, err);
+                   }
+                   PureLua::LuaStack<StringRef>::push(L, data.bytes());
+                   return 1;
+               },
+               "read")
+           .def(
+               [](lua_State* L) -> int {
+                   ArenaBuffer* buffer = check_handle(L);
+                   lua_pushinteger(L, lua_Integer(buffer->read_pos()));
+                   return 1;
+               },
+               "get_read_pos")
+           .def(
+               [](lua_State* L) -> int {
+                   check_handle(L)->read_pos(size_t(luaL_checkinteger(L, 2)));
+                   return 0;
+               },
+               "set_read_pos")
+           .def(
+               [](lua_State* L) -> int {
+                   ArenaBuffer* buffer = check_handle(L);
+                   lua_pushinteger(L, lua_Integer(buffer->write_pos()));
+                   return 1;
+               },
+               "get_write_pos")
+           .def(
+               [](lua_State* L) -> int {
+                   check_handle(L)->write_pos(size_t(luaL_checkinteger(L, 2)));
+                   return 0;
+               },
+               "set_write_pos")
+           .def(
+               [](lua_State* L) -> int {
+                   ArenaBuffer* buffer = check_handle(L);
+                   return handle_error(L, buffer->ensure_buffer(size_t(luaL_checkinteger(L, 2))));
+               },
+               "ensure_buffer") +
+       PureLua::LuaRegisterClass<FrameArena>(L, "FrameArena")
+           .def([](FrameArena& self, size_t size) { return ArenaBufferHandle(self, size); }, "new_buffer")
+           .def(&FrameArena::get_used, "get_used")
+           .def(&FrameArena::get_capacity, "get_capacity")
+           .def(&FrameArena::get_high_water, "get_high_water")
+           .def(&FrameArena::get_frame, "get_frame")];
+}
+}  // namespace PureLua
@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "PureCore/HeapTimer.h"
+
+#include "PureLua/LuaRegisterClass.h"
+
+namespace PureLua {
+void bind_core_heap_timer(lua_State* L) {
+    using namespace PureCore;
+    PureLua::LuaModule lm(L, "PureCore");
+    lm[PureLua::LuaRegisterClass<HeapTimer>(L, "HeapTimer")
+           .default_ctor()
+           .def(&HeapTimer::init, "init")
+           .def(&HeapTimer::release, "release")
+           .def(&HeapTimer::update, "update")
+           .def(&HeapTimer::add_timer, "add_timer")
+           .def(&HeapTimer::remove_timer, "remove_timer")
+           .def(&HeapTimer::clear_timer, "clear_timer")
+           .def(&HeapTimer::remove_group, "remove_group")
+           .def(&HeapTimer::get_group_count, "get_group_count")];
+}
+}  // namespace PureLua
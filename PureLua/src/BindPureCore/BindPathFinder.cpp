@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "PureCore/CoreErrorDesc.h"
+#include "PureCore/PathFinder.h"
+
+#include "PureLua/LuaRegisterClass.h"
+
+namespace PureLua {
+static void push_path(lua_State* L, const std::vector<PureCore::IntPoint>& path) {
+    lua_createtable(L, int(path.size()), 0);
+    for (int i = 0; i < path.size(); ++i) {
+        PureLua::LuaStack<PureCore::IntPoint>::push(L, path[i]);
+        lua_rawseti(L, -2, i + 1);
+    }
+}
+
+void bind_core_path_finder(lua_State* L) {
+    using namespace PureCore;
+    PureLua::LuaModule lm(L, "PureCore");
+    lm.def_const(int(PathJps), "PathJps");
+    lm.def_const(int(PathSmooth), "PathSmooth");
+    lm.def_const(int(PathNoCache), "PathNoCache");
+    lm[PureLua::LuaRegisterClass<GridMap>(L, "GridMap")
+           .default_ctor()
+           .def(&GridMap::init, "init")
+           .def(&GridMap::clear, "clear")
+           .def(&GridMap::width, "width")
+           .def(&GridMap::height, "height")
+           .def(&GridMap::is_block, "is_block")
+           .def(&GridMap::is_walkable, "is_walkable")
+           .def(&GridMap::set_block, "set_block")
+           .def(&GridMap::set_block_abox, "set_block_abox")
+           .def(&GridMap::line_of_sight, "line_of_sight")
+           .def(&GridMap::save, "save")
+           .def(&GridMap::load, "load") +
+       PureLua::LuaRegisterClass<PathFinder>(L, "PathFinder")
+           .default_ctor<size_t>()
+           .def(
+               [](lua_State* L) -> int {
+                   // find_path(map, start, goal, flags) return err, waypoints
+                   PathFinder& self = PureLua::LuaStack<PathFinder&>::get(L, 1);
+                   GridMap& map = PureLua::LuaStack<GridMap&>::get(L, 2);
+                   IntPoint& start = PureLua::LuaStack<IntPoint&>::get(L, 3);
+                   IntPoint& goal = PureLua::LuaStack<IntPoint&>::get(L, 4);
+                   uint32_t flags = lua_isnoneornil(L, 5) ? uint32_t(PathJps | PathSmooth) : PureLua::LuaStack<uint32_t>::get(L, 5);
+                   std::vector<IntPoint> path;
+                   lua_pushinteger(L, self.find_path(map, start, goal, path, flags));
+                   push_path(L, path);
+                   return 2;
+               },
+               "find_path")
+           .def(
+               [](lua_State* L) -> int {
+                   // find_paths(map, {{start, goal}, ...}, flags) return {{err, waypoints}, ...}, the Task pool is not reachable
+                   // from scripts so the batch runs in the calling thread
+                   PathFinder& self = PureLua::LuaStack<PathFinder&>::get(L, 1);
+                   GridMap& map = PureLua::LuaStack<GridMap&>::get(L, 2);
+                   if (!lua_istable(L, 3)) {
+                       lua_pushnil(L);
+                       return 1;
+                   }
+                   uint32_t flags = lua_isnoneornil(L, 4) ? uint32_t(PathJps | PathSmooth) : PureLua::LuaStack<uint32_t>::get(L, 4);
+                   size_t count = lua_rawlen(L, 3);
+                   std::vector<IntPoint> path;
+                   lua_createtable(L, int(count), 0);
+                   for (size_t i = 0; i < count; ++i) {
+                       lua_rawgeti(L, 3, lua_Integer(i + 1));
+                       if (!lua_istable(L, -1)) {
+                           lua_pop(L, 2);
+                           lua_pushnil(L);
+                           return 1;
+                       }
+                       lua_rawgeti(L, -1, 1);
+                       lua_rawgeti(L, -2, 2);
+                       IntPoint start = PureLua::LuaStack<IntPoint&>::get(L, -2);
+                       IntPoint goal = PureLua::LuaStack<IntPoint&>::get(L, -1);
+                       lua_pop(L, 3);
+                       int err = self.find_path(map, start, goal, path, flags);
+                       lua_createtable(L, 2, 0);
+                       lua_pushinteger(L, err);
+                       lua_rawseti(L, -2, 1);
+                       push_path(L, path);
+                       lua_rawseti(L, -2, 2);
+                       lua_rawseti(L, -2, lua_Integer(i + 1));
+                   }
+                   return 1;
+               },
+               "find_paths")
+           .def(&PathFinder::cache_size, "cache_size")
+           .def(&PathFinder::set_cache_size, "set_cache_size")
+           .def(&PathFinder::clear_cache, "clear_cache")
+           .def(&PathFinder::cache_hits, "cache_hits")
+           .def(&PathFinder::expanded, "expanded")];
+}
+}  // namespace PureLua
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "PureCore/Memory/PoolStat.h"
+
+#include "PureLua/LuaRegisterClass.h"
+
+namespace PureLua {
+void bind_core_pool_stat(lua_State* L) {
+    using namespace PureCore;
+    PureLua::LuaModule lm(L, "PureCore");
+    lm[PureLua::LuaRegisterClass<PoolStatInfo>(L, "PoolStatInfo")
+           .default_ctor()
+           .def(&PoolStatInfo::mName, "name")
+           .def(&PoolStatInfo::mAllocated, "allocated")
+           .def(&PoolStatInfo::mFree, "free")
+           .def(&PoolStatInfo::mChunks, "chunks")
+           .def(&PoolStatInfo::mBytes, "bytes")
+           .def(&PoolStatInfo::mHit, "hit")
+           .def(&PoolStatInfo::mMiss, "miss")
+           .def(&PoolStatInfo::mHighWater, "high_water")
+           .def(&PoolStatInfo::mInstances, "instances") +
+       PureLua::LuaRegisterClass<PoolRegistry>(L, "PoolRegistry")
+           .def(&PoolRegistry::inst, "inst")
+           .def(
+               [](lua_State* L) -> int {
+                   PoolRegistry& self = PureLua::LuaStack<PoolRegistry&>::get(L, 1);
+                   std::vector<PoolStatInfo> r = self.get_stats();
+                   lua_createtable(L, int(r.size()), 0);
+                   for (size_t i = 0; i < r.size(); ++i) {
+                       PureLua::LuaStack<PoolStatInfo>::push(L, r[i]);
+                       lua_rawseti(L, -2, lua_Integer(i + 1));
+                   }
+                   return 1;
+               },
+               "get_stats")
+           .def(&PoolRegistry::dump, "dump")];
+}
+}  // namespace PureLua
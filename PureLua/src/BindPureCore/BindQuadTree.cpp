@@ -21,6 +21,7 @@
  */
 
 #include "PureCore/QuadTree.h"
+#include "PureCore/StaticRectTree.h"
 
 #include "PureLua/LuaRegisterClass.h"
 
@@ -96,11 +97,104 @@ void bind_core_quad_tree(lua_State* L) {
                    return 1;
                },
                "collide_obox")
+           .def(
+               [](lua_State* L) -> int {
+                   QuadTree& self = PureLua::LuaStack<QuadTree&>::get(L, 1);
+                   IntLine& line = PureLua::LuaStack<IntLine&>::get(L, 2);
+                   auto& r = self.collide_line(line);
+                   lua_createtable(L, int(r.size()), 0);
+                   for (int i = 0; i < r.size(); ++i) {
+                       PureLua::LuaStack<QuadObject*>::push(L, r[i]);
+                       lua_rawseti(L, -2, i + 1);
+                   }
+                   return 1;
+               },
+               "collide_line")
+           .def(
+               [](lua_State* L) -> int {
+                   QuadTree& self = PureLua::LuaStack<QuadTree&>::get(L, 1);
+                   IntPoint& p = PureLua::LuaStack<IntPoint&>::get(L, 2);
+                   size_t k = PureLua::LuaStack<size_t>::get(L, 3);
+                   int32_t radius = lua_isnoneornil(L, 4) ? -1 : PureLua::LuaStack<int32_t>::get(L, 4);
+                   std::vector<QuadObject*> r;
+                   self.knn(p, k, r, radius);
+                   lua_createtable(L, int(r.size()), 0);
+                   for (int i = 0; i < r.size(); ++i) {
+                       PureLua::LuaStack<QuadObject*>::push(L, r[i]);
+                       lua_rawseti(L, -2, i + 1);
+                   }
+                   return 1;
+               },
+               "knn")
+           .def(
+               [](lua_State* L) -> int {
+                   QuadTree& self = PureLua::LuaStack<QuadTree&>::get(L, 1);
+                   IntPoint& p = PureLua::LuaStack<IntPoint&>::get(L, 2);
+                   int32_t radius = lua_isnoneornil(L, 3) ? -1 : PureLua::LuaStack<int32_t>::get(L, 3);
+                   PureLua::LuaStack<QuadObject*>::push(L, self.nearest(p, radius));
+                   return 1;
+               },
+               "nearest")
+           .def(
+               [](lua_State* L) -> int {
+                   QuadTree& self = PureLua::LuaStack<QuadTree&>::get(L, 1);
+                   IntPoint& from = PureLua::LuaStack<IntPoint&>::get(L, 2);
+                   IntPoint& to = PureLua::LuaStack<IntPoint&>::get(L, 3);
+                   RayHit hit;
+                   if (!self.first_hit_raycast(from, to, hit)) {
+                       lua_pushnil(L);
+                       return 1;
+                   }
+                   PureLua::LuaStack<int64_t>::push(L, hit.mObjID);
+                   lua_pushnumber(L, hit.mDist);
+                   return 2;
+               },
+               "first_hit_raycast")
+           .def(
+               [](lua_State* L) -> int {
+                   QuadTree& self = PureLua::LuaStack<QuadTree&>::get(L, 1);
+                   if (!lua_istable(L, 2)) {
+                       lua_pushnil(L);
+                       return 1;
+                   }
+                   size_t count = lua_rawlen(L, 2);
+                   std::vector<IntLine> rays(count);
+                   for (size_t i = 0; i < count; ++i) {
+                       lua_rawgeti(L, 2, lua_Integer(i + 1));
+                       rays[i] = PureLua::LuaStack<IntLine&>::get(L, -1);
+                       lua_pop(L, 1);
+                   }
+                   std::vector<RayHit> hits(count);
+                   self.first_hit_raycast_many(rays.data(), count, hits.data());
+                   // one {objID, dist} per ray, objID 0 for a miss
+                   lua_createtable(L, int(count), 0);
+                   for (size_t i = 0; i < count; ++i) {
+                       lua_createtable(L, 2, 0);
+                       PureLua::LuaStack<int64_t>::push(L, hits[i].mObjID);
+                       lua_rawseti(L, -2, 1);
+                       lua_pushnumber(L, hits[i].mDist);
+                       lua_rawseti(L, -2, 2);
+                       lua_rawseti(L, -2, lua_Integer(i + 1));
+                   }
+                   return 1;
+               },
+               "first_hit_raycast_many")
            .def(&QuadTree::is_collide_abox, "is_collide_abox")
            .def(&QuadTree::is_collide_circle, "is_collide_circle")
            .def(&QuadTree::is_collide_sector, "is_collide_sector")
            .def(&QuadTree::is_collide_obox, "is_collide_obox")
+           .def(&QuadTree::is_collide_line, "is_collide_line")
            .def(&QuadTree::insert, "insert")
-           .def(&QuadTree::remove, "remove")];
+           .def(&QuadTree::remove, "remove")
+           .def(&QuadTree::update, "update")
+           .def(
+               [](lua_State* L) -> int {
+                   QuadTree& self = PureLua::LuaStack<QuadTree&>::get(L, 1);
+                   StaticRectTree& out = PureLua::LuaStack<StaticRectTree&>::get(L, 2);
+                   uint32_t maxElem = lua_isnoneornil(L, 3) ? 16 : PureLua::LuaStack<uint32_t>::get(L, 3);
+                   lua_pushinteger(L, self.snapshot(out, maxElem));
+                   return 1;
+               },
+               "snapshot")];
 }
 }  // namespace PureLua
@@ -35,6 +35,8 @@ void bind_core_rb_timer(lua_State* L) {
            .def(&RBTimer::update, "update")
            .def(&RBTimer::add_timer, "add_timer")
            .def(&RBTimer::remove_timer, "remove_timer")
-           .def(&RBTimer::clear_timer, "clear_timer")];
+           .def(&RBTimer::clear_timer, "clear_timer")
+           .def(&RBTimer::remove_group, "remove_group")
+           .def(&RBTimer::get_group_count, "get_group_count")];
 }
 }  // namespace PureLua
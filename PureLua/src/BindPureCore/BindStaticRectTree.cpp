@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2023-present ChenDong, email <baisaichen@live.com>. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "PureCore/CoreErrorDesc.h"
+#include "PureCore/StaticRectTree.h"
+
+#include "PureLua/LuaRegisterClass.h"
+
+namespace PureLua {
+static int push_static_items(lua_State* L, const std::vector<const PureCore::StaticRectItem*>& r) {
+    lua_createtable(L, int(r.size()), 0);
+    for (int i = 0; i < r.size(); ++i) {
+        PureLua::LuaStack<const PureCore::StaticRectItem*>::push(L, r[i]);
+        lua_rawseti(L, -2, i + 1);
+    }
+    return 1;
+}
+
+void bind_core_static_rect_tree(lua_State* L) {
+    using namespace PureCore;
+    PureLua::LuaModule lm(L, "PureCore");
+    lm[PureLua::LuaRegisterClass<StaticRectItem>(L, "StaticRectItem").def(&StaticRectItem::obj_id, "obj_id").def(&StaticRectItem::abox, "abox") +
+       PureLua::LuaRegisterClass<StaticRectTree>(L, "StaticRectTree")
+           .default_ctor()
+           .def(&StaticRectTree::clear, "clear")
+           .def(
+               [](lua_State* L) -> int {
+                   // build({{objID, IntABox}, ...}, maxElem)
+                   StaticRectTree& self = PureLua::LuaStack<StaticRectTree&>::get(L, 1);
+                   if (!lua_istable(L, 2)) {
+                       lua_pushinteger(L, ErrorInvalidArg);
+                       return 1;
+                   }
+                   uint32_t maxElem = lua_isnoneornil(L, 3) ? 16 : PureLua::LuaStack<uint32_t>::get(L, 3);
+                   std::vector<StaticRectItem> items(lua_rawlen(L, 2));
+                   for (size_t i = 0; i < items.size(); ++i) {
+                       lua_rawgeti(L, 2, lua_Integer(i + 1));
+                       if (!lua_istable(L, -1)) {
+                           lua_pop(L, 1);
+                           lua_pushinteger(L, ErrorInvalidArg);
+                           return 1;
+                       }
+                       lua_rawgeti(L, -1, 1);
+                       lua_rawgeti(L, -2, 2);
+                       items[i].mObjID = PureLua::LuaStack<int64_t>::get(L, -2);
+                       items[i].mABox = PureLua::LuaStack<IntABox&>::get(L, -1);
+                       lua_pop(L, 3);
+                   }
+                   lua_pushinteger(L, self.build(std::move(items), maxElem));
+                   return 1;
+               },
+               "build")
+           .def(&StaticRectTree::save, "save")
+           .def(&StaticRectTree::load, "load")
+           .def(&StaticRectTree::size, "size")
+           .def(
+               [](lua_State* L) -> int {
+                   StaticRectTree& self = PureLua::LuaStack<StaticRectTree&>::get(L, 1);
+                   return push_static_items(L, self.all_objs());
+               },
+               "all_objs")
+           .def(
+               [](lua_State* L) -> int {
+                   StaticRectTree& self = PureLua::LuaStack<StaticRectTree&>::get(L, 1);
+                   IntABox& box = PureLua::LuaStack<IntABox&>::get(L, 2);
+                   return push_static_items(L, self.collide_abox(box));
+               },
+               "collide_abox")
+           .def(
+               [](lua_State* L) -> int {
+                   StaticRectTree& self = PureLua::LuaStack<StaticRectTree&>::get(L, 1);
+                   IntCircle& cir = PureLua::LuaStack<IntCircle&>::get(L, 2);
+                   return push_static_items(L, self.collide_circle(cir));
+               },
+               "collide_circle")
+           .def(
+               [](lua_State* L) -> int {
+                   StaticRectTree& self = PureLua::LuaStack<StaticRectTree&>::get(L, 1);
+                   IntSector& sec = PureLua::LuaStack<IntSector&>::get(L, 2);
+                   return push_static_items(L, self.collide_sector(sec));
+               },
+               "collide_sector")
+           .def(
+               [](lua_State* L) -> int {
+                   StaticRectTree& self = PureLua::LuaStack<StaticRectTree&>::get(L, 1);
+                   IntOBox& obox = PureLua::LuaStack<IntOBox&>::get(L, 2);
+                   return push_static_items(L, self.collide_obox(obox));
+               },
+               "collide_obox")
+           .def(
+               [](lua_State* L) -> int {
+                   StaticRectTree& self = PureLua::LuaStack<StaticRectTree&>::get(L, 1);
+                   IntLine& line = PureLua::LuaStack<IntLine&>::get(L, 2);
+                   return push_static_items(L, self.collide_line(line));
+               },
+               "collide_line")
+           .def(
+               [](lua_State* L) -> int {
+                   StaticRectTree& self = PureLua::LuaStack<StaticRectTree&>::get(L, 1);
+                   IntPoint& p = PureLua::LuaStack<IntPoint&>::get(L, 2);
+                   size_t k = PureLua::LuaStack<size_t>::get(L, 3);
+                   int32_t radius = lua_isnoneornil(L, 4) ? -1 : PureLua::LuaStack<int32_t>::get(L, 4);
+                   std::vector<const StaticRectItem*> r;
+                   self.knn(p, k, r, radius);
+                   return push_static_items(L, r);
+               },
+               "knn")
+           .def(
+               [](lua_State* L) -> int {
+                   StaticRectTree& self = PureLua::LuaStack<StaticRectTree&>::get(L, 1);
+                   IntPoint& p = PureLua::LuaStack<IntPoint&>::get(L, 2);
+                   int32_t radius = lua_isnoneornil(L, 3) ? -1 : PureLua::LuaStack<int32_t>::get(L, 3);
+                   PureLua::LuaStack<const StaticRectItem*>::push(L, self.nearest(p, radius));
+                   return 1;
+               },
+               "nearest")
+           .def(
+               [](lua_State* L) -> int {
+                   StaticRectTree& self = PureLua::LuaStack<StaticRectTree&>::get(L, 1);
+                   IntPoint& from = PureLua::LuaStack<IntPoint&>::get(L, 2);
+                   IntPoint& to = PureLua::LuaStack<IntPoint&>::get(L, 3);
+                   RayHit hit;
+                   if (!self.first_hit_raycast(from, to, hit)) {
+                       lua_pushnil(L);
+                       return 1;
+                   }
+                   PureLua::LuaStack<int64_t>::push(L, hit.mObjID);
+                   lua_pushnumber(L, hit.mDist);
+                   return 2;
+               },
+               "first_hit_raycast")
+           .def(
+               [](lua_State* L) -> int {
+                   StaticRectTree& self = PureLua::LuaStack<StaticRectTree&>::get(L, 1);
+                   if (!lua_istable(L, 2)) {
+                       lua_pushnil(L);
+                       return 1;
+                   }
+                   size_t count = lua_rawlen(L, 2);
+                   std::vector<IntLine> rays(count);
+                   for (size_t i = 0; i < count; ++i) {
+                       lua_rawgeti(L, 2, lua_Integer(i + 1));
+                       rays[i] = PureLua::LuaStack<IntLine&>::get(L, -1);
+                       lua_pop(L, 1);
+                   }
+                   std::vector<RayHit> hits(count);
+                   self.first_hit_raycast_many(rays.data(), count, hits.data());
+                   // one {objID, dist} per ray, objID 0 for a miss
+                   lua_createtable(L, int(count), 0);
+                   for (size_t i = 0; i < count; ++i) {
+                       lua_createtable(L, 2, 0);
+                       PureLua::LuaStack<int64_t>::push(L, hits[i].mObjID);
+                       lua_rawseti(L, -2, 1);
+                       lua_pushnumber(L, hits[i].mDist);
+                       lua_rawseti(L, -2, 2);
+                       lua_rawseti(L, -2, lua_Integer(i + 1));
+                   }
+                   return 1;
+               },
+               "first_hit_raycast_many")
+           .def(&StaticRectTree::is_collide_abox, "is_collide_abox")
+           .def(&StaticRectTree::is_collide_circle, "is_collide_circle")
+           .def(&StaticRectTree::is_collide_sector, "is_collide_sector")
+           .def(&StaticRectTree::is_collide_obox, "is_collide_obox")
+           .def(&StaticRectTree::is_collide_line, "is_collide_line")];
+}
+}  // namespace PureLua
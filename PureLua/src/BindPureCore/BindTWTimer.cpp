@@ -35,6 +35,10 @@ void bind_core_tw_timer(lua_State* L) {
            .def(&TWTimer::update, "update")
            .def(&TWTimer::add_timer, "add_timer")
            .def(&TWTimer::remove_timer, "remove_timer")
-           .def(&TWTimer::clear_timer, "clear_timer")];
+           .def(&TWTimer::clear_timer, "clear_timer")
+           .def(&TWTimer::add_slack_timer, "add_slack_timer")
+           .def(&TWTimer::set_batch_callback, "set_batch_callback")
+           .def(&TWTimer::remove_group, "remove_group")
+           .def(&TWTimer::get_group_count, "get_group_count")];
 }
 }  // namespace PureLua
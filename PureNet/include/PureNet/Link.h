@@ -26,6 +26,7 @@
 #include "PureCore/StringRef.h"
 #include "PureCore/Memory/ObjectCache.h"
 #include "PureCore/Buffer/FixedBuffer.h"
+#include "PureCore/Buffer/ChainBuffer.h"
 #include "PureNet/PureNetLib.h"
 #include "PureNet/PureNetTypes.h"
 #include "PureNet/NetMsg.h"
@@ -69,10 +70,18 @@ public:
 
     virtual int flush_data() = 0;
     virtual int push_data(PureCore::IBuffer& buffer, bool msgEnd) = 0;
+    // msg reached the link unchanged, the link may share its bytes instead of copying
+    virtual int push_msg(NetMsg& msg) = 0;
+    // share the segments of chain without copying, the bytes skip the protocol stack
+    virtual int push_chain(const PureCore::ChainBuffer& chain) = 0;
+    // bytes pushed and not flushed yet
+    virtual size_t get_pending_size() const = 0;
 
     virtual int close(int reason);
 
     int send_msg(NetMsg& msg);
+    // send encoded bytes as is, one chain can go to many links. only for links whose protocols write raw bytes
+    int send_chain(const PureCore::ChainBuffer& chain);
 
     void on_open();
     void on_close();
@@ -82,6 +91,7 @@ public:
     int on_start();
     int on_read(NetMsgPtr msg);
     int on_write(PureCore::IBuffer& buffer, int64_t leftSize);
+    int on_write_msg(NetMsg& msg);
     int on_end();
 
     void push_read_msg(NetMsgPtr msg);
@@ -91,9 +101,7 @@ public:
     uint32_t get_writing_flag() const;
 
     PureCore::FixedBuffer* get_reader();
-    PureCore::FixedBuffer* get_writer();
     PureCore::FixedBuffer* swap_reader(PureCore::FixedBuffer* buffer);
-    PureCore::FixedBuffer* swap_writer(PureCore::FixedBuffer* buffer);
 
     int64_t get_writing_size() const;
     int64_t add_writing_size(size_t size);
@@ -110,7 +118,6 @@ protected:
     int64_t mLastAlive = 0;
     int64_t mAliveTimerID = 0;
     PureCore::FixedBuffer* mReader = nullptr;
-    PureCore::FixedBuffer* mWriter = nullptr;
 
     ProtocolStack& mProtoStatck;
     NetMsgPtr mReadMsg;
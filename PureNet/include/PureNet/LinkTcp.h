@@ -32,6 +32,10 @@
 namespace PureNet {
 class PURENET_API LinkTcp : public Link {
 public:
+    enum ELinkTcpConst {
+        ShareMinSize = 1024,
+    };
+
     LinkTcp(ProtocolStack& ps);
     virtual ~LinkTcp();
 
@@ -43,13 +47,20 @@ public:
     virtual int get_remote_ip_port(char* ip, int* port);
     virtual int get_local_ip_port(char* ip, int* port);
 
+    // gather the pending segments into uv_write calls of up to WriteTcpReq::MaxBufs buffers
     virtual int flush_data();
+    // copy into the tail segment of the write chain, no flush until a write's worth of segments is pending
     virtual int push_data(PureCore::IBuffer& buffer, bool msgEnd);
+    // share the segment of a msg of at least ShareMinSize bytes, smaller ones are cheaper to copy into the tail
+    virtual int push_msg(NetMsg& msg);
+    virtual int push_chain(const PureCore::ChainBuffer& chain);
+    virtual size_t get_pending_size() const;
 
     virtual int close(int reason) override;
 
 protected:
     LinkTcpHandle mHandle;
+    PureCore::ChainBuffer mWriteChain;
 
     PURE_DISABLE_COPY(LinkTcp)
 };
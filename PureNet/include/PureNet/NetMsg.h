@@ -23,7 +23,9 @@
 #pragma once
 
 #include "PureCore/PureCoreLib.h"
+#include "PureCore/Buffer/ChainBuffer.h"
 #include "PureCore/Memory/ObjectCache.h"
+#include "PureCore/Memory/ObjectRecycler.h"
 #include "PureCore/MovePtr.h"
 #include "PureMsg/MsgClass.h"
 #include "PureMsg/MsgBuffer.h"
@@ -65,18 +67,32 @@ private:
     OpcodeID mOpcodeID = 0;
 };
 
-class PURENET_API NetMsg : public PureMsg::MsgDynamicBuffer {
+class PURENET_API NetMsg : public PureMsg::MsgDynamicBuffer, public PureCore::RecycleObject {
 public:
     NetMsg() = default;
-    virtual ~NetMsg() = default;
+    virtual ~NetMsg();
 
     // thread safe
     static NetMsg* get();
-    // thread safe
+    // thread safe, msg return to the thread get it
     static void free(NetMsg* obj);
+    // return msg freed by this thread to their thread
+    static void flush_pool();
+    // pool stat of this thread
+    static PureCore::RecycleStat get_pool_stat();
 
     virtual void clear();
 
+    // the bytes live in a refcounted segment, so a sent msg can be shared by the write chain of links
+    virtual int resize_buffer(size_t size);
+    // share the unread bytes with chain without copying, the msg is read only until clear
+    int share_data(PureCore::ChainBuffer& chain) const;
+
+    // memory own by segment, can't move or swap to DynamicBuffer which free it
+    NetMsg& operator=(PureCore::DynamicBuffer&&) = delete;
+    NetMsg& operator=(const PureCore::DynamicBuffer&) = delete;
+    void swap(PureCore::DynamicBuffer& dest) = delete;
+
     static size_t head_size();
     int pack_head(PureCore::IBuffer& buffer) const;
     int unpack_head(PureCore::IBuffer& buffer);
@@ -118,13 +134,19 @@ public:
     LinkID get_link_id() const;
     void set_link_id(LinkID linkID);
 
+private:
+    void free_segment();
+
 private:
     GroupID mGroupID = 0;
     LinkID mLinkID = 0;
     NetMsgHead mHead;
     NetMsgRoute mRoute;
+    PureCore::ChainSegment* mSegment = nullptr;
+
+    static thread_local PureCore::ObjectRecycler<NetMsg, 256> tlPool;
 
-    static thread_local PureCore::ObjectCache<NetMsg, 256> tlPool;
+    PURE_DISABLE_COPY(NetMsg)
 };
 
 using NetMsgPtr = PureCore::MovePtr<NetMsg, NetMsg>;
@@ -46,6 +46,8 @@ public:
     virtual int read_msg(Link* l, NetMsgPtr msg) { return ErrorNotSupport; }
     virtual int write_msg(Link* l, NetMsg& msg) { return ErrorNotSupport; }
     virtual int end(Link* l) { return ErrorNotSupport; }
+    // write passes the bytes down unchanged, without framing or masking
+    virtual bool is_raw_write() const { return true; }
 
 private:
     Protocol* mNext = nullptr;
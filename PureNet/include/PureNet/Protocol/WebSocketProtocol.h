@@ -66,6 +66,7 @@ struct WebSocketHead {
 
 static const uint32_t sWebSocketHeadMaxSize = 14u;
 static const uint8_t sWebSocketMaskSize = 4u;
+static const uint32_t sWebSocketMaskBufferSize = 4096u;
 
 enum EWebSockeOpcode {
     EWebSocketOpcodeEmpty = 0x0,
@@ -123,6 +124,7 @@ public:
     virtual int read(Link* l, PureCore::IBuffer& buffer) override;
     virtual int write(Link* l, PureCore::IBuffer& buffer, int64_t leftSize, int64_t totalSize) override;
     virtual int end(Link* l) override;
+    virtual bool is_raw_write() const override;
 
     bool is_handshake_ok();
 
@@ -152,6 +154,8 @@ protected:
 
 private:
     static thread_local PureCore::ObjectCache<WebSocketHandshakeHttp, 128> tHttpPool;
+    // client data is masked here, the msg may be shared by other links
+    static thread_local PureCore::ArrayBuffer<sWebSocketMaskBufferSize> tMaskBuffer;
 
     PURE_DISABLE_COPY(WebSocketProtocol)
 };
@@ -66,10 +66,12 @@ public:
     virtual int end(Link* l) override;
 
     uint32_t get_writing_flag() const;
+    virtual bool is_raw_write() const override;
 
 private:
     PureCore::FixedVector<Protocol*, MaxProtocolStackSize> mStatck;
     uint32_t mWritingFlag = 0;
+    NetMsg* mWritingMsg = nullptr;
 
     PURE_DISABLE_COPY(ProtocolStack)
 };
@@ -37,6 +37,7 @@
 #include "uv.h"
 
 #include <functional>
+#include <mutex>
 
 namespace PureNet {
 class Link;
@@ -58,6 +59,10 @@ public:
     PureCore::TWTimer& timer();
 
     void update(int64_t delta);
+    // block until io, wakeup or ms passed, not block when next frame has work
+    void wait(int64_t ms);
+    // thread safe, break wait of the reacter thread
+    void wakeup();
 
     int listen_tcp(LinkType key, GroupID groupID, const char* ip, int port);
     void stop_listen_tcp(GroupID groupID);
@@ -117,6 +122,10 @@ public:
 private:
     int mState{};
     uv_loop_t mLoop{};
+    uv_timer_t mWaitTimer{};
+    uv_async_t mWakeup{};
+    std::mutex mWakeupMutex;
+    bool mWakeupOpen = false;  // mWakeup can be sent, guard by mWakeupMutex
     LinkMgr mLinks;
     PureCore::NodeList mListenTcp;
     PureCore::TWTimer mTimer;
@@ -127,12 +136,12 @@ private:
 
 private:
     struct NetObjectPools {
-        PureCore::ObjectPool<uv_shutdown_t, 128> mShutdownPool;
-        PureCore::ObjectCache<GetAddrReq, 128> mGetAddrPool;
-        PureCore::ObjectCache<ConnectTcpReq, 128> mTcpConnectPool;
+        PureCore::ObjectPool<uv_shutdown_t, 128> mShutdownPool{"NetShutdown"};
+        PureCore::ObjectCache<GetAddrReq, 128> mGetAddrPool{"NetGetAddrReq"};
+        PureCore::ObjectCache<ConnectTcpReq, 128> mTcpConnectPool{"NetConnectTcpReq"};
 
-        PureCore::ObjectCache<PureCore::FixedBuffer, 256> mTcpBufferPool;
-        PureCore::ObjectCache<WriteTcpReq, 256> mWriteTcpPool;
+        PureCore::ObjectCache<PureCore::FixedBuffer, 256> mTcpBufferPool{"NetTcpBuffer"};
+        PureCore::ObjectCache<WriteTcpReq, 256> mWriteTcpPool{"NetWriteTcpReq"};
     } mPools;
     PURE_DISABLE_COPY(PureNetReacter)
 };
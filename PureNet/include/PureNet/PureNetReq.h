@@ -26,6 +26,7 @@
 #include "PureCore/NodeList.h"
 #include "PureCore/Buffer/FixedBuffer.h"
 #include "PureCore/Buffer/ArrayBuffer.h"
+#include "PureCore/Buffer/ChainBuffer.h"
 #include "PureNet/PureNetLib.h"
 #include "PureNet/PureNetTypes.h"
 
@@ -65,17 +66,23 @@ public:
     std::function<GetHostAddrCallback> mGetted{};
 };
 
+// one gather write, holds the segments it sends until the write callback
 class WriteTcpReq {
 public:
+    enum EWriteTcpConst {
+        MaxBufs = 64,  // uv_buf_t count of one uv_write
+    };
+
     WriteTcpReq() = default;
 
-    int init(LinkTcp* link, PureCore::DataRef data, PureCore::FixedBuffer* lastBuffer);
+    // take up to MaxBufs slices from the front of chain
+    int init(LinkTcp* link, PureCore::ChainBuffer& chain);
     void clear();
 
     LinkTcp* mLink = nullptr;
-    PureCore::FixedBuffer* mLastBuffer = nullptr;
+    size_t mSize = 0;
+    PureCore::ChainBuffer mChain;
     uv_write_t mHandle{};
-    uv_buf_t mUvBuf{};
 };
 
 }  // namespace PureNet
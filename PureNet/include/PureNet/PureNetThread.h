@@ -23,13 +23,12 @@
 #pragma once
 
 #include "PureCore/Thread.h"
+#include "PureCore/Channel.h"
 #include "PureNet/PureNetLib.h"
 #include "PureNet/PureNetReacter.h"
 #include "PureNet/PureNetAsync.h"
 #include "PureNet/LinkFactory.h"
 
-#include <mutex>
-
 namespace PureNet {
 class PURENET_API PureNetThread : public PureCore::Thread {
 public:
@@ -40,11 +39,18 @@ public:
     int setup_ssl(const OpenSSLConfig& cfg);
 #endif
     void set_config(const NetConfig& cfg);
+    // notified when responses are pushed to the logic thread, set before start
+    void set_resp_waker(PureCore::ChannelWaker* waker);
 
     int start(int64_t reqTimeout);
     void stop();
 
     int64_t get_req_timeout() const;
+    // thread safe
+    PureCore::ChannelStat get_req_stat() const;
+    PureCore::ChannelStat get_resp_stat() const;
+    // responses wait for update, check it before the logic thread waits on resp waker
+    bool has_resp() const;
 
     void update();
 
@@ -75,6 +81,10 @@ protected:
     virtual void work();
 
 private:
+    enum EPureNetThreadConst {
+        ReacterWaitTime = 10,  // max milli seconds blocking in uv_run, link timers are checked at least this often
+    };
+
     void logic_req();
     void logic_resp();
 
@@ -107,17 +117,16 @@ private:
     PureCore::IncrIDGen mReqGen;
     std::map<int64_t, ReqItem*> mReqWaiting{};
 
-    PureCore::NodeList mReqQueue;
-    PureCore::NodeList mRespQueue;
+    PureCore::NodeList mReqQueue;   // logic, wait for room in mReqChannel
+    PureCore::NodeList mRespQueue;  // net, wait for room in mRespChannel
 
-    std::mutex mSwapReqMutex;
-    PureCore::NodeList mSwapReqQueue;
-    std::mutex mSwapRespMutex;
-    PureCore::NodeList mSwapRespQueue;
+    PureCore::SpscChannel<AsyncItem*> mReqChannel;
+    PureCore::SpscChannel<AsyncItem*> mRespChannel;
 
-    PureCore::ObjectPool<ReqItem, 255> mReqPool;
-    PureCore::ObjectCache<AsyncItem, 255> mAsyncReqPool;
-    PureCore::ObjectCache<AsyncItem, 255> mAsyncRespPool;
+    PureCore::ObjectPool<ReqItem, 255> mReqPool{"NetThreadReqItem"};
+    // req items are freed to mAsyncRespPool by the net thread, resp items to mAsyncReqPool by the logic thread
+    PureCore::ObjectCache<AsyncItem, 255> mAsyncReqPool{"NetThreadAsyncReq", false};
+    PureCore::ObjectCache<AsyncItem, 255> mAsyncRespPool{"NetThreadAsyncResp", false};
 
     PURE_DISABLE_COPY(PureNetThread)
 };
@@ -28,6 +28,7 @@
 
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 namespace PureNet {
 typedef std::unordered_map<RouteID, LinkID> RouteMap;
@@ -48,6 +49,8 @@ public:
     LinkID find_route_by_server(ServerType serverType, ServerID serverID, ServerIndex serverIndex);
     const RouteMap& find_server_type_routes(ServerType serverType);
     const RouteMap& find_server_type_id_routes(ServerType serverType, ServerID serverID);
+    // group users by their links into dest for broadcast_msg, users without a route are skipped, return count added
+    size_t fill_broadcast_dest(const std::vector<UserID>& users, BroadcastDest& dest);
 
 private:
     LinkRouteMap mRouteLinks;
@@ -41,7 +41,6 @@ Link::Link(ProtocolStack& ps)
       mLastAlive(0),
       mAliveTimerID(0),
       mReader(nullptr),
-      mWriter(nullptr),
       mProtoStatck(ps) {}
 
 void Link::free() {
@@ -70,7 +69,6 @@ void Link::clear() {
     mLastAlive = 0;
     mAliveTimerID = 0;
     mReader = nullptr;
-    mWriter = nullptr;
     mCloseReason = 0;
     free_read_msg();
 }
@@ -122,6 +120,22 @@ int Link::send_msg(NetMsg& msg) {
     return mProtoStatck.on_write(this, msg);
 }
 
+int Link::send_chain(const PureCore::ChainBuffer& chain) {
+    if (mState != ELinkStart) {
+        return ErrorStateError;
+    }
+    // a framing protocol such as websocket must see every write
+    if (!mProtoStatck.is_raw_write()) {
+        return ErrorNotSupport;
+    }
+    int err = push_chain(chain);
+    if (err != Success) {
+        return err;
+    }
+    link_mgr().need_flush(this);
+    return Success;
+}
+
 void Link::on_open() {
     mState = ELinkOpen;
     mLastAlive = PureCore::steady_milli_s();
@@ -179,6 +193,18 @@ int Link::on_write(PureCore::IBuffer& buffer, int64_t leftSize) {
     return Success;
 }
 
+int Link::on_write_msg(NetMsg& msg) {
+    if (!valid() || mReacter == nullptr) {
+        return ErrorStateError;
+    }
+    int err = push_msg(msg);
+    if (err != Success) {
+        return err;
+    }
+    link_mgr().need_flush(this);
+    return Success;
+}
+
 int Link::on_end() {
     if ((mState != ELinkOpen && mState != ELinkStart) || mReacter == nullptr) {
         return ErrorStateError;
@@ -201,8 +227,6 @@ uint32_t Link::get_writing_flag() const { return mProtoStatck.get_writing_flag()
 
 PureCore::FixedBuffer* Link::get_reader() { return mReader; }
 
-PureCore::FixedBuffer* Link::get_writer() { return mWriter; }
-
 PureCore::FixedBuffer* Link::swap_reader(PureCore::FixedBuffer* buffer) {
     if (buffer == nullptr) {
         return nullptr;
@@ -212,15 +236,6 @@ PureCore::FixedBuffer* Link::swap_reader(PureCore::FixedBuffer* buffer) {
     return old;
 }
 
-PureCore::FixedBuffer* Link::swap_writer(PureCore::FixedBuffer* buffer) {
-    if (buffer == nullptr) {
-        return nullptr;
-    }
-    auto old = mWriter;
-    mWriter = buffer;
-    return old;
-}
-
 int64_t Link::get_writing_size() const { return mWritingSize; }
 
 int64_t Link::add_writing_size(size_t size) {
@@ -76,7 +76,7 @@ int LinkMgr::add_link(Link* link, GroupID groupID, bool isServer) {
 void LinkMgr::remove_link(LinkID linkID) { mLinks.erase(linkID); }
 
 void LinkMgr::need_flush(Link* link) {
-    if (link == nullptr || link->get_writer() == nullptr || link->get_writer()->size() == 0) {
+    if (link == nullptr || link->get_pending_size() == 0) {
         return;
     }
     mNeedFlush.insert(link->get_link_id());
@@ -35,9 +35,6 @@ LinkTcp::~LinkTcp() {
     if (mReader != nullptr) {
         mReacter->free_tcp_buffer(mReader);
     }
-    if (mWriter != nullptr) {
-        mReacter->free_tcp_buffer(mWriter);
-    }
 }
 
 int LinkTcp::init(PureNetReacter* reacter) {
@@ -50,23 +47,19 @@ int LinkTcp::init(PureNetReacter* reacter) {
     } else {
         mReader->clear();
     }
-    if (mWriter == nullptr) {
-        mWriter = mReacter->get_tcp_buffer();
-    } else {
-        mWriter->clear();
-    }
-    if (mReader == nullptr || mWriter == nullptr) {
+    if (mReader == nullptr) {
         return ErrrorMemoryNotEnough;
     }
+    mWriteChain.clear();
     return mHandle.init(reacter, this);
 }
 
 void LinkTcp::clear() {
     if (mReacter != nullptr) {
         mReacter->free_tcp_buffer(mReader);
-        mReacter->free_tcp_buffer(mWriter);
     }
     Link::clear();
+    mWriteChain.clear();
     mHandle.release();
 }
 
@@ -77,80 +70,106 @@ int LinkTcp::get_remote_ip_port(char* ip, int* port) { return mHandle.get_remote
 int LinkTcp::get_local_ip_port(char* ip, int* port) { return mHandle.get_local_ip_port(ip, port); }
 
 int LinkTcp::flush_data() {
-    if (!valid() || mWriter == nullptr) {
+    if (!valid()) {
         return ErrorStateError;
     }
-    auto data = mWriter->data();
-    if (data.empty()) {
-        return Success;
-    }
-    auto req = mReacter->get_tcp_write_req();
-    if (req == nullptr) {
-        return ErrrorMemoryNotEnough;
-    }
-
-    int err = 0;
-    mWriter->read_pos(mWriter->read_pos() + data.size());
-    if (mWriter->free_size() == 0) {
-        err = req->init(this, data, swap_writer(mReacter->get_tcp_buffer()));
-    } else {
-        err = req->init(this, data, nullptr);
-    }
-    if (err != Success) {
-        mReacter->free_tcp_write_req(req);
-        return err;
-    }
-    add_writing_size(data.size());
-    err = uv_write(&req->mHandle, (uv_stream_t*)&get_uv_handle(), &req->mUvBuf, 1, [](uv_write_t* handle, int status) {
-        if (handle == nullptr || handle->data == nullptr) {
-            PureError("link tcp push data failed, handle is nullptr");
-            return;
+    while (!mWriteChain.empty()) {
+        auto req = mReacter->get_tcp_write_req();
+        if (req == nullptr) {
+            return ErrrorMemoryNotEnough;
         }
-        WriteTcpReq* req = (WriteTcpReq*)handle->data;
-        if (req->mLastBuffer != nullptr) {
-            req->mLink->reacter()->free_tcp_buffer(req->mLastBuffer);
+        int err = req->init(this, mWriteChain);
+        if (err != Success) {
+            mReacter->free_tcp_write_req(req);
+            return err;
         }
-        req->mLink->finish_writing_size(req->mUvBuf.len);
-        if (req->mLink->get_writing_size() == 0 && req->mLink->get_writer() != nullptr && req->mLink->get_writer()->size() == 0) {
-            req->mLink->get_writer()->clear();
+        // libuv copies the buf array, the segments stay alive in req until the callback
+        uv_buf_t bufs[WriteTcpReq::MaxBufs];
+        unsigned int count = (unsigned int)req->mChain.slice_count();
+        for (unsigned int i = 0; i < count; ++i) {
+            auto& s = req->mChain.slice(i);
+            bufs[i] = uv_buf_init(s.mSegment->data() + s.mOffset, s.mLength);
         }
-        if (status != 0) {
-            req->mLink->close(status);
+        add_writing_size(req->mSize);
+        err = uv_write(&req->mHandle, (uv_stream_t*)&get_uv_handle(), bufs, count, [](uv_write_t* handle, int status) {
+            if (handle == nullptr || handle->data == nullptr) {
+                PureError("link tcp push data failed, handle is nullptr");
+                return;
+            }
+            WriteTcpReq* req = (WriteTcpReq*)handle->data;
+            req->mLink->finish_writing_size(req->mSize);
+            if (status != 0) {
+                req->mLink->close(status);
+            }
+            req->mLink->reacter()->free_tcp_write_req(req);
+        });
+        if (err != 0) {
+            finish_writing_size(req->mSize);
+            mReacter->free_tcp_write_req(req);
+            return err;
         }
-        req->mLink->reacter()->free_tcp_write_req(req);
-    });
-    if (err != 0) {
-        mReacter->free_tcp_write_req(req);
     }
-    return err;
+    return Success;
 }
 
-int LinkTcp::push_data(PureCore::IBuffer& buffer, bool msgEnd) {
-    if (!valid() || mWriter == nullptr) {
+int LinkTcp::push_data(PureCore::IBuffer& buffer, bool) {
+    if (!valid()) {
         return ErrorStateError;
     }
-    size_t freeSize = mWriter->free_size();
-    if (freeSize >= buffer.size()) {
-        int err = mWriter->write(buffer.data());
-        if (err != PureCore::Success) {
+    // the buffer keeps its read pos, a broadcast writes the same msg to the next link
+    int err = mWriteChain.write(buffer.data());
+    if (err != PureCore::Success) {
+        return ErrorLinkWriteDataFailed;
+    }
+    if (mWriteChain.slice_count() >= WriteTcpReq::MaxBufs) {
+        err = flush_data();
+        if (err != Success) {
             return ErrorLinkWriteDataFailed;
         }
-    } else {
-        PureCore::DataRef data(buffer.data().data(), freeSize);
-        int err = mWriter->write(data);
-        if (err != PureCore::Success) {
+    }
+    return Success;
+}
+
+int LinkTcp::push_msg(NetMsg& msg) {
+    if (msg.size() < ShareMinSize) {
+        return push_data(msg, true);
+    }
+    if (!valid()) {
+        return ErrorStateError;
+    }
+    // the chain holds a reference on the msg segment, clear of the freed msg leaves the segment to it
+    int err = msg.share_data(mWriteChain);
+    if (err != PureCore::Success) {
+        return ErrorLinkWriteDataFailed;
+    }
+    if (mWriteChain.slice_count() >= WriteTcpReq::MaxBufs) {
+        err = flush_data();
+        if (err != Success) {
             return ErrorLinkWriteDataFailed;
         }
-        buffer.read_pos(buffer.read_pos() + freeSize);
+    }
+    return Success;
+}
+
+int LinkTcp::push_chain(const PureCore::ChainBuffer& chain) {
+    if (!valid()) {
+        return ErrorStateError;
+    }
+    int err = mWriteChain.append(chain);
+    if (err != PureCore::Success) {
+        return ErrorLinkWriteDataFailed;
+    }
+    if (mWriteChain.slice_count() >= WriteTcpReq::MaxBufs) {
         err = flush_data();
-        if (err != PureCore::Success) {
+        if (err != Success) {
             return ErrorLinkWriteDataFailed;
         }
-        return push_data(buffer, msgEnd);
     }
     return Success;
 }
 
+size_t LinkTcp::get_pending_size() const { return mWriteChain.size(); }
+
 int LinkTcp::close(int reason) {
     int err = Link::close(reason);
     if (err != Success) {
@@ -20,6 +20,7 @@
  * IN THE SOFTWARE.
  */
 
+#include "PureCore/CoreErrorDesc.h"
 #include "PureCore/OsHelper.h"
 #include "PureNet/NetErrorDesc.h"
 #include "PureNet/NetMsg.h"
@@ -82,14 +83,64 @@ NetMsg* NetMsg::get() { return tlPool.get(); }
 
 void NetMsg::free(NetMsg* obj) { tlPool.free(obj); }
 
+void NetMsg::flush_pool() { tlPool.flush(); }
+
+PureCore::RecycleStat NetMsg::get_pool_stat() { return tlPool.get_stat(); }
+
+NetMsg::~NetMsg() { free_segment(); }
+
 void NetMsg::clear() {
     PureMsg::MsgDynamicBuffer::clear();
+    // a segment still in a write chain is left to it, the next write gets a new one
+    if (mSegment != nullptr && !mSegment->unique()) {
+        free_segment();
+    }
     mGroupID = 0;
     mLinkID = 0;
     mHead.clear();
     mRoute.clear();
 }
 
+int NetMsg::resize_buffer(size_t size) {
+    if (mBuffer.size() >= size) {
+        return PureCore::Success;
+    }
+
+    PureCore::ChainSegment* seg = PureCore::ChainSegment::create(size);
+    if (seg == nullptr) {
+        return PureCore::ErrorMemoryNotEnough;
+    }
+    if (mSegment != nullptr) {
+        memcpy(seg->data(), mSegment->data(), mBuffer.size());
+        mSegment->release();
+    }
+    mSegment = seg;
+    size_t readPos = mView.read_pos();
+    size_t writePos = mView.write_pos();
+    mBuffer.reset(seg->data(), size);
+    mView.reset(mBuffer);
+    mView.write_pos(writePos);
+    mView.read_pos(readPos);
+    return PureCore::Success;
+}
+
+int NetMsg::share_data(PureCore::ChainBuffer& chain) const {
+    if (size() == 0) {
+        return PureCore::Success;
+    }
+    return chain.append(mSegment, read_pos(), size());
+}
+
+void NetMsg::free_segment() {
+    if (mSegment == nullptr) {
+        return;
+    }
+    mSegment->release();
+    mSegment = nullptr;
+    mBuffer.reset(nullptr, 0);
+    mView.clear();
+}
+
 size_t NetMsg::head_size() { return NetMsgHead::buffer_size(); }
 
 int NetMsg::pack_head(PureCore::IBuffer& buffer) const { return mHead.pack(buffer); }
@@ -182,6 +233,6 @@ LinkID NetMsg::get_link_id() const { return mLinkID; }
 
 void NetMsg::set_link_id(LinkID linkID) { mLinkID = linkID; }
 
-thread_local PureCore::ObjectCache<NetMsg, 256> NetMsg::tlPool{};
+thread_local PureCore::ObjectRecycler<NetMsg, 256> NetMsg::tlPool{"NetMsg"};
 
 }  // namespace PureNet
@@ -299,18 +299,31 @@ int WebSocketProtocol::write(Link* l, PureCore::IBuffer& buffer, int64_t leftSiz
     } else {
         uint8_t maskIdx = 0;
         auto data = buffer.data();
-        for (size_t i = 0; i < data.size(); ++i) {
-            data[i] = data[i] ^ mask.data[maskIdx++];
-            maskIdx &= 0x3u;
-        }
-        err = pre()->write(l, buffer, 0, totalSize + mWritingHead.size());
-        if (err != Success) {
-            return err;
+        size_t pos = 0;
+        while (pos < data.size()) {
+            size_t n = data.size() - pos;
+            if (n > sWebSocketMaskBufferSize) {
+                n = sWebSocketMaskBufferSize;
+            }
+            tMaskBuffer.clear();
+            char* out = tMaskBuffer.buffer().data();
+            for (size_t i = 0; i < n; ++i) {
+                out[i] = data[pos + i] ^ mask.data[maskIdx++];
+                maskIdx &= 0x3u;
+            }
+            tMaskBuffer.write_pos(n);
+            pos += n;
+            err = pre()->write(l, tMaskBuffer, int64_t(data.size() - pos), totalSize + mWritingHead.size());
+            if (err != Success) {
+                return err;
+            }
         }
     }
     return Success;
 }
 
+bool WebSocketProtocol::is_raw_write() const { return false; }
+
 int WebSocketProtocol::end(Link* l) {
     if (mHttp != nullptr) {
         tHttpPool.free(mHttp);
@@ -598,6 +611,7 @@ int WebSocketProtocol::on_handshake_finish() {
     return next()->start(mLink);
 }
 
-thread_local PureCore::ObjectCache<WebSocketHandshakeHttp, 128> WebSocketProtocol::tHttpPool{};
+thread_local PureCore::ObjectCache<WebSocketHandshakeHttp, 128> WebSocketProtocol::tHttpPool{"WebSocketHandshakeHttp"};
+thread_local PureCore::ArrayBuffer<sWebSocketMaskBufferSize> WebSocketProtocol::tMaskBuffer;
 
 }  // namespace PureNet
@@ -73,7 +73,10 @@ int ProtocolStack::on_write(Link* l, NetMsg& msg) {
         return ErrorLinkNoneProtocol;
     }
     mWritingFlag = msg.get_flag();
-    return mStatck.back()->write_msg(l, msg);
+    mWritingMsg = &msg;
+    int err = mStatck.back()->write_msg(l, msg);
+    mWritingMsg = nullptr;
+    return err;
 }
 
 void ProtocolStack::on_end(Link* l) {
@@ -87,10 +90,25 @@ int ProtocolStack::start(Link* l) { return l->on_start(); }
 
 int ProtocolStack::read_msg(Link* l, NetMsgPtr msg) { return l->on_read(msg); }
 
-int ProtocolStack::write(Link* l, PureCore::IBuffer& buffer, int64_t leftSize, int64_t totalSize) { return l->on_write(buffer, leftSize); }
+int ProtocolStack::write(Link* l, PureCore::IBuffer& buffer, int64_t leftSize, int64_t totalSize) {
+    // the msg itself reached the link unchanged, it can share its segment
+    if (mWritingMsg != nullptr && &buffer == static_cast<PureCore::IBuffer*>(mWritingMsg)) {
+        return l->on_write_msg(*mWritingMsg);
+    }
+    return l->on_write(buffer, leftSize);
+}
 
 int ProtocolStack::end(Link* l) { return l->on_end(); }
 
 uint32_t ProtocolStack::get_writing_flag() const { return mWritingFlag; }
 
+bool ProtocolStack::is_raw_write() const {
+    for (auto iter = mStatck.begin(); iter != mStatck.end(); ++iter) {
+        if (!(*iter)->is_raw_write()) {
+            return false;
+        }
+    }
+    return true;
+}
+
 }  // namespace PureNet
@@ -53,6 +53,17 @@ int PureNetReacter::init() {
         return err;
     }
     mLoop.data = this;
+    uv_timer_init(&mLoop, &mWaitTimer);
+    err = uv_async_init(&mLoop, &mWakeup, nullptr);
+    if (err != 0) {
+        uv_close((uv_handle_t*)&mWaitTimer, nullptr);
+        uv_run(&mLoop, UV_RUN_NOWAIT);
+        uv_loop_close(&mLoop);
+        return err;
+    }
+    mWakeupMutex.lock();
+    mWakeupOpen = true;
+    mWakeupMutex.unlock();
     mTimer.init();
     mState = EReacterValid;
     return Success;
@@ -63,6 +74,11 @@ void PureNetReacter::release() {
         return;
     }
     mState = EReacterClosing;
+    mWakeupMutex.lock();
+    mWakeupOpen = false;
+    mWakeupMutex.unlock();
+    uv_close((uv_handle_t*)&mWakeup, nullptr);
+    uv_close((uv_handle_t*)&mWaitTimer, nullptr);
     for (auto iter = mListenTcp.begin(); iter != mListenTcp.end(); ++iter) {
         stop_listen_tcp_req(iter->cast<ListenTcpReq>());
     }
@@ -115,6 +131,23 @@ void PureNetReacter::update(int64_t delta) {
     mReadyFrame.swap(mWorkFrame);
 }
 
+void PureNetReacter::wait(int64_t ms) {
+    if (mState != EReacterValid || ms <= 0 || !mWorkFrame.empty()) {
+        return;
+    }
+    uv_update_time(&mLoop);
+    uv_timer_start(&mWaitTimer, [](uv_timer_t*) {}, uint64_t(ms), 0);
+    uv_run(&mLoop, UV_RUN_ONCE);
+    uv_timer_stop(&mWaitTimer);
+}
+
+void PureNetReacter::wakeup() {
+    std::lock_guard<std::mutex> lock(mWakeupMutex);
+    if (mWakeupOpen) {
+        uv_async_send(&mWakeup);
+    }
+}
+
 int PureNetReacter::listen_tcp(LinkType key, GroupID groupID, const char* ip, int port) {
     if (mState != EReacterValid) {
         return ErrorStateError;
@@ -73,24 +73,21 @@ void GetAddrReq::clear() {
 ///////////////////////////////////////////////////////////////////////////
 // WriteTcpReq
 //////////////////////////////////////////////////////////////////////////
-int WriteTcpReq::init(LinkTcp* link, PureCore::DataRef data, PureCore::FixedBuffer* lastBuffer) {
-    if (link == nullptr || data.empty()) {
+int WriteTcpReq::init(LinkTcp* link, PureCore::ChainBuffer& chain) {
+    if (link == nullptr || chain.empty()) {
         return ErrorInvalidArg;
     }
     mLink = link;
-    mLastBuffer = lastBuffer;
     mHandle.data = this;
-    mUvBuf.base = data.data();
-    mUvBuf.len = (uint32_t)data.size();
+    mSize = chain.move_front(mChain, MaxBufs);
     return Success;
 }
 
 void WriteTcpReq::clear() {
     mLink = nullptr;
-    mLastBuffer = nullptr;
+    mSize = 0;
+    mChain.clear();
     mHandle.data = nullptr;
-    mUvBuf.base = nullptr;
-    mUvBuf.len = 0;
 }
 
 }  // namespace PureNet
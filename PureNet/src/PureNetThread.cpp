@@ -30,6 +30,8 @@
 namespace PureNet {
 void PureNetThread::set_config(const NetConfig& cfg) { mReacter.set_config(cfg); }
 
+void PureNetThread::set_resp_waker(PureCore::ChannelWaker* waker) { mRespChannel.set_waker(waker); }
+
 int PureNetThread::start(int64_t reqTimeout) {
     if (reqTimeout <= 0) {
         return ErrorInvalidArg;
@@ -47,6 +49,7 @@ void PureNetThread::stop() {
         return;
     }
     mReacterRunning = false;
+    mReacter.wakeup();
     join(0);
     mEventLinkOpen.clear();
     mEventLinkStart.clear();
@@ -58,26 +61,29 @@ void PureNetThread::stop() {
         mReqPool.free(iter.second);
     }
     mReqWaiting.clear();
+    // net thread exited, drain both sides of the channels here
+    mReqChannel.pop_list(mReqQueue);
     while (!mReqQueue.empty()) {
         mAsyncReqPool.free(mReqQueue.pop_front_t<AsyncItem>());
     }
-    mSwapReqMutex.lock();
-    while (!mSwapReqQueue.empty()) {
-        mAsyncReqPool.free(mSwapReqQueue.pop_front_t<AsyncItem>());
-    }
-    mSwapReqMutex.unlock();
-    mSwapRespMutex.lock();
-    while (!mSwapRespQueue.empty()) {
-        mAsyncRespPool.free(mSwapRespQueue.pop_front_t<AsyncItem>());
+    mRespChannel.pop_list(mRespQueue);
+    while (!mRespQueue.empty()) {
+        mAsyncRespPool.free(mRespQueue.pop_front_t<AsyncItem>());
     }
-    mSwapRespMutex.unlock();
 }
 
 int64_t PureNetThread::get_req_timeout() const { return mReqTimeOut; }
 
+PureCore::ChannelStat PureNetThread::get_req_stat() const { return mReqChannel.get_stat(); }
+
+PureCore::ChannelStat PureNetThread::get_resp_stat() const { return mRespChannel.get_stat(); }
+
+bool PureNetThread::has_resp() const { return !mRespChannel.empty(); }
+
 void PureNetThread::update() {
     logic_resp();
     logic_req();
+    NetMsg::flush_pool();
     int64_t timeout = PureCore::steady_milli_s() - mReqTimeOut;
     for (auto iter = mReqWaiting.begin(); iter != mReqWaiting.end();) {
         if (iter->second == nullptr || iter->second->mReqTime < timeout) {
@@ -224,16 +230,18 @@ void PureNetThread::work() {
     mReacter.mEventLinkClose.bind(this, &PureNetThread::on_link_close);
 
     PureCore::SleepIdler idle;
-    idle.set_idle_delay(10 * 1000);
     while (mReacterRunning.load(std::memory_order_relaxed)) {
         idle.frame_begin();
         work_req();
+        // update every loop to flush links before waiting
         int64_t delta = idle.frame_check(1);
-        if (delta > 0) {
-            mReacter.update(delta);
-        }
+        mReacter.update(delta > 0 ? delta : 0);
         work_resp();
-        idle.frame_end();
+        NetMsg::flush_pool();
+        // block in uv_run, woken by io, logic_req or the wait timeout for the link timers
+        if (mReqChannel.empty() && mRespQueue.empty()) {
+            mReacter.wait(ReacterWaitTime);
+        }
     }
     mReacter.release();
     work_resp();
@@ -243,16 +251,15 @@ void PureNetThread::logic_req() {
     if (mReqQueue.empty()) {
         return;
     }
-    mSwapReqMutex.lock();
-    mSwapReqQueue.push_back_list(mReqQueue);
-    mSwapReqMutex.unlock();
+    // left in mReqQueue when full, retry next update
+    if (mReqChannel.push_list(mReqQueue) > 0) {
+        mReacter.wakeup();
+    }
 }
 
 void PureNetThread::logic_resp() {
     PureCore::NodeList nl;
-    mSwapRespMutex.lock();
-    nl.push_back_list(mSwapRespQueue);
-    mSwapRespMutex.unlock();
+    mRespChannel.pop_list(nl);
     while (!nl.empty()) {
         AsyncItem* item = nl.pop_front_t<AsyncItem>();
         if (item == nullptr) {
@@ -324,9 +331,7 @@ void PureNetThread::logic_resp() {
 
 void PureNetThread::work_req() {
     PureCore::NodeList nl;
-    mSwapReqMutex.lock();
-    nl.push_back_list(mSwapReqQueue);
-    mSwapReqMutex.unlock();
+    mReqChannel.pop_list(nl);
     while (!nl.empty()) {
         AsyncItem* item = nl.pop_front_t<AsyncItem>();
         if (item == nullptr) {
@@ -368,9 +373,8 @@ void PureNetThread::work_resp() {
     if (mRespQueue.empty()) {
         return;
     }
-    mSwapRespMutex.lock();
-    mSwapRespQueue.push_back_list(mRespQueue);
-    mSwapRespMutex.unlock();
+    // left in mRespQueue when full, retry next frame
+    mRespChannel.push_list(mRespQueue);
 }
 
 void PureNetThread::listen(ESockType type, LinkType key, GroupID groupID, const char* ip, int port, std::function<ListenCallback> cb) {
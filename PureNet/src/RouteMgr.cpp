@@ -124,4 +124,17 @@ const RouteMap& RouteMgr::find_server_type_id_routes(ServerType serverType, Serv
     return iter->second;
 }
 
+size_t RouteMgr::fill_broadcast_dest(const std::vector<UserID>& users, BroadcastDest& dest) {
+    size_t added = 0;
+    for (auto userID : users) {
+        auto iter = mUsers.find(userID);
+        if (iter == mUsers.end()) {
+            continue;
+        }
+        dest[iter->second].insert(userID);
+        ++added;
+    }
+    return added;
+}
+
 }  // namespace PureNet